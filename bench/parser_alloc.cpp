@@ -0,0 +1,294 @@
+/**
+ * @file parser_alloc.cpp
+ * @brief Compte les allocations mémoire du Tokenizer et du Parser par nœud de l'AST.
+ *
+ * operator new est remplacé par une version qui compte les appels pendant l'analyse.
+ * Chaque programme de `exemples/`, ainsi qu'un programme généré avec de longs
+ * identifiants (qui ne tiennent pas dans le petit tampon de std::string), est analysé
+ * et le nombre d'allocations est divisé par le nombre de nœuds de l'AST.
+ *
+ * Le programme échoue si un rapport dépasse `--max-per-node` (1 par défaut) : chaque
+ * nœud doit coûter au plus une allocation, celle de std::make_shared, sans copie de
+ * token ni de sous-arbre.
+ */
+
+#include "Parser.hpp"
+#include "Tokenizer.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool g_counting = false;
+static size_t g_allocations = 0;
+static size_t g_bytes = 0;
+
+void *operator new(size_t size)
+{
+    if (g_counting)
+    {
+        g_allocations++;
+        g_bytes += size;
+    }
+    if (void *pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+static size_t countNodes(const std::shared_ptr<Expr> &expr);
+
+static size_t countNodes(const std::shared_ptr<Stmt> &stmt)
+{
+    if (!stmt)
+        return 0;
+
+    switch (stmt->getType())
+    {
+    case StmtType::EXIT:
+        return 1 + countNodes(static_cast<const ExitStmt *>(stmt.get())->expr);
+    case StmtType::LET:
+        return 1 + countNodes(static_cast<const LetStmt *>(stmt.get())->expr);
+    case StmtType::ASSIGN:
+        return 1 + countNodes(static_cast<const AssignStmt *>(stmt.get())->expr);
+    case StmtType::PRINT:
+    {
+        size_t count = 1;
+        for (const auto &arg : static_cast<const PrintStmt *>(stmt.get())->args)
+            count += countNodes(arg.expr);
+        return count;
+    }
+    case StmtType::BLOCK:
+    {
+        size_t count = 1;
+        for (const auto &child : static_cast<const BlockStmt *>(stmt.get())->statements)
+            count += countNodes(child);
+        return count;
+    }
+    case StmtType::IF:
+    {
+        auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+        return 1 + countNodes(ifStmt->condition) + countNodes(std::static_pointer_cast<Stmt>(ifStmt->thenBranch)) +
+               countNodes(std::static_pointer_cast<Stmt>(ifStmt->elseBranch));
+    }
+    case StmtType::MATCH:
+    {
+        auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+        size_t count = 1 + countNodes(matchStmt->subject) +
+                       countNodes(std::static_pointer_cast<Stmt>(matchStmt->defaultBranch));
+        for (const MatchArm &arm : matchStmt->arms)
+            count += countNodes(std::static_pointer_cast<Stmt>(arm.body));
+        return count;
+    }
+    case StmtType::WHILE:
+    {
+        auto whileStmt = static_cast<const WhileStmt *>(stmt.get());
+        return 1 + countNodes(whileStmt->condition) + countNodes(std::static_pointer_cast<Stmt>(whileStmt->body));
+    }
+    case StmtType::ARRAY_ASSIGN:
+    {
+        auto assignStmt = static_cast<const ArrayAssignStmt *>(stmt.get());
+        return 1 + countNodes(assignStmt->array) + countNodes(assignStmt->index) + countNodes(assignStmt->value);
+    }
+    case StmtType::MATRIX_ASSIGN:
+    {
+        auto assignStmt = static_cast<const MatrixAssignStmt *>(stmt.get());
+        return 1 + countNodes(assignStmt->matrix) + countNodes(assignStmt->row) + countNodes(assignStmt->col) +
+               countNodes(assignStmt->value);
+    }
+    default:
+        return 1;
+    }
+}
+
+static size_t countNodes(const std::shared_ptr<Expr> &expr)
+{
+    if (!expr)
+        return 0;
+
+    switch (expr->getType())
+    {
+    case ExprType::BINARY:
+    {
+        auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+        return 1 + countNodes(binExpr->gauche) + countNodes(binExpr->droite);
+    }
+    case ExprType::ARRAY:
+    {
+        size_t count = 1;
+        for (const auto &element : static_cast<const ArrayExpr *>(expr.get())->elements)
+            count += countNodes(element);
+        return count;
+    }
+    case ExprType::ARRAY_ACCESS:
+    {
+        auto accessExpr = static_cast<const ArrayAccessExpr *>(expr.get());
+        return 1 + countNodes(accessExpr->array) + countNodes(accessExpr->index);
+    }
+    case ExprType::LENGTH:
+        return 1 + countNodes(static_cast<const LengthExpr *>(expr.get())->array);
+    case ExprType::MATRIX:
+    {
+        auto matrixExpr = static_cast<const MatrixExpr *>(expr.get());
+        return 1 + countNodes(matrixExpr->rows) + countNodes(matrixExpr->cols);
+    }
+    case ExprType::MATRIX_ACCESS:
+    {
+        auto accessExpr = static_cast<const MatrixAccessExpr *>(expr.get());
+        return 1 + countNodes(accessExpr->matrix) + countNodes(accessExpr->row) + countNodes(accessExpr->col);
+    }
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Programme dont les identifiants dépassent le petit tampon de std::string
+ */
+static std::string longIdentifierProgram(int statements)
+{
+    std::ostringstream source;
+    source << "let compteur_de_la_boucle_principale = 0;\n";
+    source << "let tableau_des_valeurs_intermediaires = [1, 2, 3, 4, 5, 6, 7, 8];\n";
+    for (int i = 0; i < statements; i++)
+    {
+        source << "let variable_temporaire_numero_" << i << " = compteur_de_la_boucle_principale * " << i
+               << " + tableau_des_valeurs_intermediaires[" << i % 8 << "];\n";
+        source << "while (compteur_de_la_boucle_principale < " << i << ") {\n"
+               << "    compteur_de_la_boucle_principale = compteur_de_la_boucle_principale + 1;\n"
+               << "    tableau_des_valeurs_intermediaires[" << i % 8 << "] = variable_temporaire_numero_" << i << ";\n"
+               << "}\n";
+    }
+    source << "print(compteur_de_la_boucle_principale);\n";
+    return source.str();
+}
+
+/**
+ * @brief Résultat de l'analyse d'un programme
+ */
+struct AllocationCount
+{
+    size_t nodes = 0;
+    size_t allocations = 0;
+    size_t bytes = 0;
+    bool valid = false;
+};
+
+static AllocationCount measure(const std::string &source)
+{
+    AllocationCount result;
+    {
+        Tokenizer tokenizer(source);
+        Parser parser(tokenizer);
+
+        g_allocations = 0;
+        g_bytes = 0;
+        g_counting = true;
+        auto program = parser.parse();
+        g_counting = false;
+
+        result.allocations = g_allocations;
+        result.bytes = g_bytes;
+        if (program)
+        {
+            result.valid = true;
+            for (const auto &stmt : program->statements)
+                result.nodes += countNodes(stmt);
+        }
+    }
+    return result;
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --corpus <dossier>     Programmes a analyser (defaut: exemples)\n"
+              << "  --max-per-node <x>     Allocations par noeud tolerees (defaut: 1)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    std::string corpusDir = "exemples";
+    double maxPerNode = 1.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--corpus" && hasValue)
+            corpusDir = argv[++i];
+        else if (arg == "--max-per-node" && hasValue)
+            maxPerNode = std::atof(argv[++i]);
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> sources;
+    if (fs::is_directory(corpusDir))
+    {
+        for (const auto &entry : fs::directory_iterator(corpusDir))
+        {
+            if (entry.path().extension() != ".yb")
+                continue;
+            std::ifstream file(entry.path());
+            std::stringstream content;
+            content << file.rdbuf();
+            sources.push_back({entry.path().filename().string(), content.str()});
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+    sources.push_back({"(identifiants longs)", longIdentifierProgram(2000)});
+
+    std::cout << std::left << std::setw(26) << "programme" << std::right << std::setw(10) << "noeuds"
+              << std::setw(14) << "allocations" << std::setw(12) << "par noeud" << std::setw(14) << "octets"
+              << "\n";
+
+    bool failed = false;
+    for (const auto &source : sources)
+    {
+        AllocationCount count = measure(source.second);
+        if (!count.valid)
+        {
+            std::cout << std::left << std::setw(26) << source.first << std::right << "  (programme invalide, ignore)\n";
+            continue;
+        }
+
+        double perNode = count.nodes ? static_cast<double>(count.allocations) / count.nodes : 0.0;
+        std::cout << std::left << std::setw(26) << source.first << std::right << std::setw(10) << count.nodes
+                  << std::setw(14) << count.allocations << std::setw(12) << std::fixed << std::setprecision(2)
+                  << perNode << std::setw(14) << count.bytes;
+        if (perNode > maxPerNode)
+        {
+            std::cout << "  TROP";
+            failed = true;
+        }
+        std::cout << "\n";
+    }
+
+    if (failed)
+    {
+        std::cerr << "Erreur: plus de " << maxPerNode << " allocation(s) par noeud de l'AST" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
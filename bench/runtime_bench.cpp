@@ -0,0 +1,698 @@
+/**
+ * @file runtime_bench.cpp
+ * @brief Banc d'essai du code généré par le compilateur YB.
+ *
+ * Pour chaque noyau (les fichiers `bench_*.yb` de `exemples/` plus un noyau
+ * synthétique qui remplit puis parcourt un grand tableau) et pour chaque configuration de
+ * compilation, le programme est compilé, assemblé avec nasm, lié avec ld puis
+ * exécuté plusieurs fois. On mesure le temps médian, les défauts de page mineurs
+ * et la mémoire résidente maximale du processus.
+ *
+ * Quand le noyau le permet (perf_event_open, perf_event_paranoid <= 2), les compteurs
+ * matériels du programme mesuré sont lus en mode utilisateur : cycles, instructions,
+ * branch-misses, défauts de cache L1d et de dTLB. Un compteur indisponible (machine
+ * virtuelle, PMU absente, droits insuffisants) est simplement omis.
+ *
+ * Les résultats peuvent être enregistrés en JSON (`--json`) puis comparés noyau par
+ * noyau à une mesure précédente (`--compare avant.json`, ou `--diff avant.json apres.json`
+ * sans rien exécuter).
+ *
+ * Exemple :
+ *   runtime_bench --compiler build/compiler --kernels exemples \
+ *                 --config defaut= --config sans-hugepage=--hugepage-threshold=0
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Un programme YB à mesurer
+ */
+struct Kernel
+{
+    std::string name;
+    std::string path;
+};
+
+/**
+ * @brief Une configuration de compilation (options passées au compilateur)
+ */
+struct Config
+{
+    std::string name;
+    std::vector<std::string> flags;
+};
+
+/**
+ * @brief Compteur matériel lu avec perf_event_open
+ */
+struct CounterSpec
+{
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+};
+
+static const CounterSpec COUNTERS[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"L1d-misses", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {"dTLB-misses", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+static constexpr int COUNTER_COUNT = sizeof(COUNTERS) / sizeof(COUNTERS[0]);
+
+/**
+ * @brief Résultat d'une exécution
+ */
+struct Measure
+{
+    double seconds = 0.0;
+    long minorFaults = 0;
+    long maxRssKb = 0;
+    int status = -1;
+    long long counters[COUNTER_COUNT] = {-1, -1, -1, -1, -1}; /**< -1 si indisponible */
+};
+
+/**
+ * @brief Résultat agrégé (médianes) d'un noyau dans une configuration
+ */
+struct Result
+{
+    std::string kernel;
+    std::string config;
+    int status = -1;
+    std::map<std::string, double> metrics; /**< median_ms, minflt, maxrss_kb et compteurs disponibles */
+};
+
+// Premier échec de perf_event_open, affiché une seule fois
+static std::string g_counterError;
+static bool g_countersEnabled = true;
+
+/**
+ * @brief Ouvre un compteur pour le processus pid, activé à son execve et limité au mode utilisateur
+ * @return Le descripteur, ou -1 si le compteur n'est pas disponible
+ */
+static int openCounter(const CounterSpec &spec, pid_t pid)
+{
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0));
+    if (fd < 0 && g_counterError.empty())
+        g_counterError = std::string(spec.name) + ": " + std::strerror(errno);
+    return fd;
+}
+
+/**
+ * @brief Lit un compteur, corrigé du multiplexage
+ * @return La valeur, ou -1 si le compteur n'a jamais été actif
+ */
+static long long readCounter(int fd)
+{
+    uint64_t values[3] = {0, 0, 0}; // valeur, temps activé, temps réellement compté
+    if (read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0)
+        return -1;
+    if (values[2] < values[1])
+        return static_cast<long long>(static_cast<double>(values[0]) * values[1] / values[2]);
+    return static_cast<long long>(values[0]);
+}
+
+/**
+ * @brief Lance une commande et attend sa fin
+ * @param args La commande et ses arguments
+ * @param quiet Rediriger stdout et stderr vers /dev/null
+ * @param measure Si non nul, reçoit le temps, les compteurs rusage et les compteurs matériels du processus
+ * @return Le code de retour (128 + signal si le processus a été tué)
+ *
+ * Pour les compteurs matériels, l'enfant attend sur un tube que le parent ait ouvert
+ * les compteurs (activés à l'execve) avant d'exécuter la commande : seul le programme
+ * mesuré est compté, pas le fork ni le chargement de runtime_bench.
+ */
+static int runCommand(const std::vector<std::string> &args, bool quiet, Measure *measure = nullptr)
+{
+    std::vector<char *> argv;
+    for (const auto &arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    int syncPipe[2];
+    if (pipe(syncPipe) != 0)
+        return -1;
+
+    pid_t pid = fork();
+    if (pid < 0)
+        return -1;
+    if (pid == 0)
+    {
+        if (quiet)
+        {
+            int devnull = open("/dev/null", O_WRONLY);
+            dup2(devnull, STDOUT_FILENO);
+            dup2(devnull, STDERR_FILENO);
+        }
+        close(syncPipe[1]);
+        char go;
+        if (read(syncPipe[0], &go, 1) < 0)
+            _exit(127);
+        close(syncPipe[0]);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    close(syncPipe[0]);
+
+    int counterFds[COUNTER_COUNT];
+    for (int i = 0; i < COUNTER_COUNT; i++)
+        counterFds[i] = measure && g_countersEnabled ? openCounter(COUNTERS[i], pid) : -1;
+
+    auto start = std::chrono::steady_clock::now();
+    close(syncPipe[1]); // Libère l'enfant
+
+    int status = 0;
+    struct rusage usage = {};
+    wait4(pid, &status, 0, &usage);
+    auto end = std::chrono::steady_clock::now();
+
+    int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    if (measure)
+    {
+        measure->seconds = std::chrono::duration<double>(end - start).count();
+        measure->minorFaults = usage.ru_minflt;
+        measure->maxRssKb = usage.ru_maxrss;
+        measure->status = code;
+    }
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        if (counterFds[i] < 0)
+            continue;
+        if (measure)
+            measure->counters[i] = readCounter(counterFds[i]);
+        close(counterFds[i]);
+    }
+    return code;
+}
+
+/**
+ * @brief Écrit le noyau synthétique : remplissage puis parcours d'un grand tableau
+ *
+ * Le tableau est une matrice d'une ligne, seule allocation de taille dynamique en YB.
+ */
+static void writeLargeArrayKernel(const std::string &path, long elements)
+{
+    std::ofstream out(path);
+    out << "// Noyau synthetique : parcours d'un tableau de " << elements << " elements\n";
+    out << "let T = matrix(1, " << elements << ");\n";
+    out << "let f = 0;\n"
+           "while (f < len(T)) {\n"
+           "    T[f] = f % 7;\n"
+           "    f = f + 1;\n"
+           "}\n"
+           "let s = 0;\n"
+           "let pass = 0;\n"
+           "while (pass < 8) {\n"
+           "    let i = 0;\n"
+           "    while (i < len(T)) {\n"
+           "        s = s + T[i];\n"
+           "        i = i + 1;\n"
+           "    }\n"
+           "    pass = pass + 1;\n"
+           "}\n"
+           "print(s);\n";
+}
+
+/**
+ * @brief Médiane d'une série de valeurs (les valeurs négatives, indisponibles, sont ignorées)
+ * @return La médiane, ou -1 si aucune valeur n'est disponible
+ */
+static double median(std::vector<double> values)
+{
+    values.erase(std::remove_if(values.begin(), values.end(), [](double v)
+                                { return v < 0; }),
+                 values.end());
+    if (values.empty())
+        return -1;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+/**
+ * @brief Résume les exécutions d'un noyau par la médiane de chaque mesure
+ */
+static Result summarize(const Kernel &kernel, const Config &config, const std::vector<Measure> &measures)
+{
+    Result result{kernel.name, config.name, measures.empty() ? -1 : measures.front().status, {}};
+    auto collect = [&](auto field)
+    {
+        std::vector<double> values;
+        for (const auto &measure : measures)
+            values.push_back(field(measure));
+        return median(values);
+    };
+
+    result.metrics["median_ms"] = collect([](const Measure &m)
+                                          { return m.seconds * 1000.0; });
+    result.metrics["minflt"] = collect([](const Measure &m)
+                                       { return static_cast<double>(m.minorFaults); });
+    result.metrics["maxrss_kb"] = collect([](const Measure &m)
+                                          { return static_cast<double>(m.maxRssKb); });
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        double value = collect([i](const Measure &m)
+                               { return static_cast<double>(m.counters[i]); });
+        if (value >= 0)
+            result.metrics[COUNTERS[i].name] = value;
+    }
+    return result;
+}
+
+static std::string jsonString(const std::string &text)
+{
+    std::string result = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result + "\"";
+}
+
+/**
+ * @brief Écrit les résultats en JSON : {"runs": n, "results": [{"kernel", "config", "status", mesures...}]}
+ */
+static bool writeJson(const std::string &path, const std::vector<Result> &results, int runs)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    out << "{\n  \"runs\": " << runs << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result &result = results[i];
+        out << (i ? "," : "") << "\n    {\"kernel\": " << jsonString(result.kernel)
+            << ", \"config\": " << jsonString(result.config) << ", \"status\": " << result.status;
+        for (const auto &metric : result.metrics)
+            out << ", " << jsonString(metric.first) << ": " << std::fixed << std::setprecision(3) << metric.second;
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+    return true;
+}
+
+/**
+ * @brief Lecteur JSON minimal, suffisant pour relire les fichiers écrits par writeJson
+ */
+class JsonReader
+{
+public:
+    explicit JsonReader(const std::string &text) : m_text(text) {}
+
+    /**
+     * @brief Lit le tableau "results"
+     * @return false si le texte n'a pas la forme attendue
+     */
+    bool readResults(std::vector<Result> &results)
+    {
+        if (!expect('{'))
+            return false;
+        while (true)
+        {
+            std::string key;
+            if (!readString(key) || !expect(':'))
+                return false;
+            if (key == "results")
+            {
+                if (!expect('['))
+                    return false;
+                while (!peek(']'))
+                {
+                    Result result;
+                    if (!readResult(result))
+                        return false;
+                    results.push_back(result);
+                    if (!peek(']') && !expect(','))
+                        return false;
+                }
+                expect(']');
+            }
+            else
+            {
+                double ignored;
+                if (!readNumber(ignored))
+                    return false;
+            }
+            if (peek('}'))
+                return true;
+            if (!expect(','))
+                return false;
+        }
+    }
+
+private:
+    void skipSpaces()
+    {
+        while (m_position < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_position])))
+            m_position++;
+    }
+
+    bool peek(char c)
+    {
+        skipSpaces();
+        return m_position < m_text.size() && m_text[m_position] == c;
+    }
+
+    bool expect(char c)
+    {
+        if (!peek(c))
+            return false;
+        m_position++;
+        return true;
+    }
+
+    bool readString(std::string &value)
+    {
+        if (!expect('"'))
+            return false;
+        value.clear();
+        while (m_position < m_text.size() && m_text[m_position] != '"')
+        {
+            if (m_text[m_position] == '\\' && m_position + 1 < m_text.size())
+                m_position++;
+            value += m_text[m_position++];
+        }
+        return expect('"');
+    }
+
+    bool readNumber(double &value)
+    {
+        skipSpaces();
+        const char *begin = m_text.c_str() + m_position;
+        char *end = nullptr;
+        value = std::strtod(begin, &end);
+        if (end == begin)
+            return false;
+        m_position += end - begin;
+        return true;
+    }
+
+    bool readResult(Result &result)
+    {
+        if (!expect('{'))
+            return false;
+        while (!peek('}'))
+        {
+            std::string key;
+            if (!readString(key) || !expect(':'))
+                return false;
+            if (key == "kernel" || key == "config")
+            {
+                if (!readString(key == "kernel" ? result.kernel : result.config))
+                    return false;
+            }
+            else
+            {
+                double value;
+                if (!readNumber(value))
+                    return false;
+                if (key == "status")
+                    result.status = static_cast<int>(value);
+                else
+                    result.metrics[key] = value;
+            }
+            if (!peek('}') && !expect(','))
+                return false;
+        }
+        return expect('}');
+    }
+
+    const std::string &m_text;
+    size_t m_position = 0;
+};
+
+static bool readJson(const std::string &path, std::vector<Result> &results)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string text = content.str();
+    return JsonReader(text).readResults(results);
+}
+
+/**
+ * @brief Affiche, noyau par noyau, l'évolution de chaque mesure entre deux séries de résultats
+ */
+static void printDiff(const std::vector<Result> &before, const std::vector<Result> &after)
+{
+    std::cout << "\n"
+              << std::left << std::setw(40) << "noyau / mesure" << std::right << std::setw(16) << "avant"
+              << std::setw(16) << "apres" << std::setw(10) << "ecart" << "\n";
+    for (const auto &current : after)
+    {
+        auto previous = std::find_if(before.begin(), before.end(), [&](const Result &r)
+                                     { return r.kernel == current.kernel && r.config == current.config; });
+        if (previous == before.end())
+        {
+            std::cout << current.kernel << " (" << current.config << ") : absent de la reference\n";
+            continue;
+        }
+
+        std::cout << current.kernel << " (" << current.config << ")";
+        if (previous->status != current.status)
+            std::cout << "  code " << previous->status << " -> " << current.status;
+        std::cout << "\n";
+        for (const auto &metric : current.metrics)
+        {
+            auto old = previous->metrics.find(metric.first);
+            if (old == previous->metrics.end())
+                continue;
+            std::cout << "  " << std::left << std::setw(38) << metric.first << std::right << std::fixed
+                      << std::setprecision(metric.first == "median_ms" ? 2 : 0)
+                      << std::setw(16) << old->second << std::setw(16) << metric.second;
+            if (old->second != 0)
+                std::cout << std::setw(9) << std::showpos << std::setprecision(1)
+                          << (metric.second / old->second - 1.0) * 100.0 << "%" << std::noshowpos;
+            std::cout << "\n";
+        }
+    }
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --compiler <chemin>     Compilateur YB (defaut: ./compiler)\n"
+              << "  --kernels <dossier>     Dossier des noyaux bench_*.yb (defaut: exemples)\n"
+              << "  --config <nom>=<opts>   Configuration de compilation (repetable)\n"
+              << "  --runs <n>              Executions par mesure (defaut: 5)\n"
+              << "  --large-array <n>       Elements du noyau synthetique (defaut: 16777216, 0 = aucun)\n"
+              << "  --workdir <dossier>     Dossier temporaire (defaut: runtime_bench_work)\n"
+              << "  --no-counters           Ne pas lire les compteurs materiels\n"
+              << "  --json <fichier>        Enregistrer les resultats en JSON\n"
+              << "  --compare <fichier>     Comparer les resultats a une mesure JSON precedente\n"
+              << "  --diff <avant> <apres>  Comparer deux fichiers JSON sans rien executer\n";
+}
+
+static std::string formatCount(double value)
+{
+    if (value < 0)
+        return "-";
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(0) << value;
+    return text.str();
+}
+
+int main(int argc, char *argv[])
+{
+    std::string compiler = "./compiler";
+    std::string kernelDir = "exemples";
+    std::string workDir = "runtime_bench_work";
+    std::string jsonPath;
+    std::string comparePath;
+    std::vector<std::string> diffPaths;
+    std::vector<Config> configs;
+    int runs = 5;
+    long largeArray = 16 * 1024 * 1024;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--compiler" && hasValue)
+            compiler = argv[++i];
+        else if (arg == "--kernels" && hasValue)
+            kernelDir = argv[++i];
+        else if (arg == "--workdir" && hasValue)
+            workDir = argv[++i];
+        else if (arg == "--runs" && hasValue)
+            runs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--large-array" && hasValue)
+            largeArray = std::atol(argv[++i]);
+        else if (arg == "--no-counters")
+            g_countersEnabled = false;
+        else if (arg == "--json" && hasValue)
+            jsonPath = argv[++i];
+        else if (arg == "--compare" && hasValue)
+            comparePath = argv[++i];
+        else if (arg == "--diff" && i + 2 < argc)
+        {
+            diffPaths.push_back(argv[++i]);
+            diffPaths.push_back(argv[++i]);
+        }
+        else if (arg == "--config" && hasValue)
+        {
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            Config config{spec.substr(0, eq), {}};
+            if (eq != std::string::npos)
+            {
+                std::istringstream flags(spec.substr(eq + 1));
+                for (std::string flag; flags >> flag;)
+                    config.flags.push_back(flag);
+            }
+            configs.push_back(config);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!diffPaths.empty())
+    {
+        std::vector<Result> before, after;
+        if (!readJson(diffPaths[0], before) || !readJson(diffPaths[1], after))
+        {
+            std::cerr << "Erreur: lecture impossible de " << diffPaths[0] << " ou " << diffPaths[1] << std::endl;
+            return EXIT_FAILURE;
+        }
+        printDiff(before, after);
+        return EXIT_SUCCESS;
+    }
+
+    std::vector<Result> reference;
+    if (!comparePath.empty() && !readJson(comparePath, reference))
+    {
+        std::cerr << "Erreur: lecture impossible de " << comparePath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (configs.empty())
+    {
+        configs.push_back({"defaut", {}});
+        configs.push_back({"sans-hugepage", {"--hugepage-threshold=0"}});
+    }
+    compiler = fs::absolute(compiler).string();
+    fs::create_directories(workDir);
+
+    std::vector<Kernel> kernels;
+    if (fs::is_directory(kernelDir))
+    {
+        for (const auto &entry : fs::directory_iterator(kernelDir))
+        {
+            std::string file = entry.path().filename().string();
+            if (file.rfind("bench_", 0) == 0 && entry.path().extension() == ".yb")
+                kernels.push_back({entry.path().stem().string(), fs::absolute(entry.path()).string()});
+        }
+    }
+    std::sort(kernels.begin(), kernels.end(), [](const Kernel &a, const Kernel &b)
+              { return a.name < b.name; });
+    if (largeArray > 0)
+    {
+        std::string path = fs::absolute(fs::path(workDir) / "large_array.yb").string();
+        writeLargeArrayKernel(path, largeArray);
+        kernels.push_back({"large_array", path});
+    }
+
+    std::cout << std::left << std::setw(22) << "noyau" << std::setw(16) << "config"
+              << std::right << std::setw(12) << "median(ms)" << std::setw(12) << "minflt"
+              << std::setw(12) << "maxrss(Ko)" << std::setw(8) << "code";
+    for (const auto &counter : COUNTERS)
+        std::cout << std::setw(15) << counter.name;
+    std::cout << "\n";
+
+    bool failed = false;
+    std::vector<Result> results;
+    for (const auto &kernel : kernels)
+    {
+        for (const auto &config : configs)
+        {
+            std::string base = (fs::path(workDir) / (kernel.name + "_" + config.name)).string();
+            std::vector<std::string> compile = {compiler, kernel.path, "-o", base + ".asm"};
+            compile.insert(compile.end(), config.flags.begin(), config.flags.end());
+
+            if (runCommand(compile, true) != 0 ||
+                runCommand({"nasm", "-f", "elf64", base + ".asm", "-o", base + ".o"}, false) != 0 ||
+                runCommand({"ld", "-o", base, base + ".o"}, false) != 0)
+            {
+                std::cerr << "Echec de la construction de " << kernel.name << " (" << config.name << ")\n";
+                failed = true;
+                continue;
+            }
+
+            std::vector<Measure> measures(runs);
+            for (auto &measure : measures)
+                runCommand({base}, true, &measure);
+            Result result = summarize(kernel, config, measures);
+            results.push_back(result);
+
+            std::cout << std::left << std::setw(22) << kernel.name << std::setw(16) << config.name
+                      << std::right << std::fixed << std::setprecision(2) << std::setw(12) << result.metrics["median_ms"]
+                      << std::setw(12) << formatCount(result.metrics["minflt"])
+                      << std::setw(12) << formatCount(result.metrics["maxrss_kb"])
+                      << std::setw(8) << result.status;
+            for (const auto &counter : COUNTERS)
+            {
+                auto value = result.metrics.find(counter.name);
+                std::cout << std::setw(15) << (value == result.metrics.end() ? "-" : formatCount(value->second));
+            }
+            std::cout << "\n";
+        }
+    }
+
+    if (g_countersEnabled && !g_counterError.empty())
+        std::cerr << "Compteurs materiels indisponibles (" << g_counterError << "), valeurs affichees "-"" << std::endl;
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, results, runs))
+    {
+        std::cerr << "Erreur: ecriture impossible de " << jsonPath << std::endl;
+        failed = true;
+    }
+    if (!comparePath.empty())
+        printDiff(reference, results);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
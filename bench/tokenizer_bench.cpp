@@ -0,0 +1,367 @@
+/**
+ * @file tokenizer_bench.cpp
+ * @brief Micro-benchmark de Tokenizer::tokenize avec seuil de régression.
+ *
+ * Les programmes de `exemples/` sont découpés en lexèmes (identifiants et mots clés,
+ * nombres, opérateurs et ponctuation, commentaires). Des corpus de 1, 10 et 100 Mo
+ * sont ensuite générés en tirant des lexèmes de ces programmes avec les mêmes
+ * proportions (en octets) que dans les sources réelles. Chaque corpus est analysé une
+ * fois pour chauffer les caches et l'allocateur, puis plusieurs fois : le débit médian
+ * est rapporté en Mo/s et en tokens/s.
+ *
+ * Avec `--baseline <fichier>`, les débits sont comparés à une mesure de référence :
+ * le programme échoue si l'un d'eux baisse de plus de `--threshold` (25 % par défaut).
+ * D'une exécution à l'autre, le débit brut varie de 10 à 30 % sur une même machine
+ * (fréquence, charge). Chaque passe de tokenize() est donc précédée d'une passe de
+ * calibration (un parcours simple du corpus) et c'est le rapport médian des deux
+ * débits, mesurés dans le même processus, qui est comparé à la référence.
+ * Si le fichier n'existe pas encore (ou avec `--update-baseline`), il est écrit.
+ */
+
+#include "Tokenizer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Catégories de lexèmes utilisées pour construire les corpus
+ */
+enum class LexemeKind
+{
+    WORD,     // Identifiants et mots clés
+    NUMBER,   // Littéraux entiers
+    OPERATOR, // Opérateurs et ponctuation
+    COMMENT,  // Commentaires // et /* */
+    COUNT
+};
+
+/**
+ * @brief Lexèmes réels regroupés par catégorie, avec le nombre d'octets de chaque catégorie
+ */
+struct LexemePool
+{
+    std::vector<std::string> lexemes[static_cast<int>(LexemeKind::COUNT)];
+    size_t bytes[static_cast<int>(LexemeKind::COUNT)] = {};
+
+    void add(LexemeKind kind, const std::string &text)
+    {
+        lexemes[static_cast<int>(kind)].push_back(text);
+        bytes[static_cast<int>(kind)] += text.size();
+    }
+};
+
+/**
+ * @brief Découpe un programme source en lexèmes classés par catégorie
+ */
+static void collectLexemes(const std::string &source, LexemePool &pool)
+{
+    size_t position = 0;
+    while (position < source.size())
+    {
+        char c = source[position];
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            position++;
+        }
+        else if (source.compare(position, 2, "//") == 0)
+        {
+            size_t end = source.find('\n', position);
+            end = end == std::string::npos ? source.size() : end;
+            pool.add(LexemeKind::COMMENT, source.substr(position, end - position) + "\n");
+            position = end;
+        }
+        else if (source.compare(position, 2, "/*") == 0)
+        {
+            size_t end = source.find("*/", position + 2);
+            end = end == std::string::npos ? source.size() : end + 2;
+            pool.add(LexemeKind::COMMENT, source.substr(position, end - position));
+            position = end;
+        }
+        else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+        {
+            size_t end = position;
+            while (end < source.size() && (std::isalnum(static_cast<unsigned char>(source[end])) || source[end] == '_'))
+                end++;
+            pool.add(LexemeKind::WORD, source.substr(position, end - position));
+            position = end;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c)))
+        {
+            size_t end = position;
+            while (end < source.size() && std::isdigit(static_cast<unsigned char>(source[end])))
+                end++;
+            pool.add(LexemeKind::NUMBER, source.substr(position, end - position));
+            position = end;
+        }
+        else
+        {
+            static const char *twoChars[] = {"==", "!=", "<=", ">=", "&&", "||"};
+            size_t length = 1;
+            for (const char *op : twoChars)
+                if (source.compare(position, 2, op) == 0)
+                    length = 2;
+            pool.add(LexemeKind::OPERATOR, source.substr(position, length));
+            position += length;
+        }
+    }
+}
+
+/**
+ * @brief Génère un corpus d'environ `size` octets avec les proportions du pool
+ */
+static std::string generateCorpus(const LexemePool &pool, size_t size, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<double> weights;
+    for (int kind = 0; kind < static_cast<int>(LexemeKind::COUNT); kind++)
+        weights.push_back(pool.lexemes[kind].empty() ? 0.0 : static_cast<double>(pool.bytes[kind]));
+    std::discrete_distribution<int> pickKind(weights.begin(), weights.end());
+
+    std::string corpus;
+    corpus.reserve(size + 4096);
+    int column = 0;
+    while (corpus.size() < size)
+    {
+        int kind = pickKind(rng);
+        const auto &choices = pool.lexemes[kind];
+        const std::string &lexeme = choices[rng() % choices.size()];
+        corpus += lexeme;
+        column += static_cast<int>(lexeme.size());
+
+        // Séparer les lexèmes pour que deux mots ou deux nombres ne fusionnent pas
+        if (column > 80 && kind != static_cast<int>(LexemeKind::COMMENT))
+        {
+            corpus += '\n';
+            column = 0;
+        }
+        else
+        {
+            corpus += ' ';
+            column++;
+        }
+    }
+    return corpus;
+}
+
+/**
+ * @brief Résultat d'une mesure de débit
+ */
+struct Throughput
+{
+    double mbPerSecond = 0.0;
+    double tokensPerSecond = 0.0;
+    double relative = 0.0; ///< Débit de tokenize() divisé par celui de la calibration
+    size_t tokens = 0;
+};
+
+/**
+ * @brief Passe de calibration : découpe le corpus en mots, octet par octet, et range chaque
+ * mot dans un vecteur de chaînes (mêmes allocations que les tokens)
+ */
+static size_t splitWords(const std::string &corpus)
+{
+    std::vector<std::string> words;
+    size_t begin = 0;
+    bool inWord = false;
+    for (size_t i = 0; i <= corpus.size(); i++)
+    {
+        bool wordChar = i < corpus.size() && (std::isalnum(static_cast<unsigned char>(corpus[i])) || corpus[i] == '_');
+        if (wordChar && !inWord)
+            begin = i;
+        else if (!wordChar && inWord)
+            words.emplace_back(corpus, begin, i - begin);
+        inWord = wordChar;
+    }
+    return words.size();
+}
+
+/**
+ * @brief Mesure le débit médian de tokenize() sur `repetitions` passes, après une passe
+ * de chauffe non comptée
+ */
+static Throughput measure(const std::string &corpus, int repetitions)
+{
+    Tokenizer tokenizer(corpus);
+    Throughput result;
+    result.tokens = tokenizer.tokenize().size();
+
+    volatile size_t words = splitWords(corpus);
+
+    std::vector<double> durations;
+    std::vector<double> ratios;
+    for (int i = 0; i < repetitions; i++)
+    {
+        auto calibrationStart = std::chrono::steady_clock::now();
+        words = splitWords(corpus);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Token> tokens = tokenizer.tokenize();
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        durations.push_back(seconds);
+        ratios.push_back(std::chrono::duration<double>(start - calibrationStart).count() / seconds);
+    }
+    (void)words;
+
+    std::sort(durations.begin(), durations.end());
+    std::sort(ratios.begin(), ratios.end());
+    double seconds = durations[durations.size() / 2];
+    result.mbPerSecond = corpus.size() / (1024.0 * 1024.0) / seconds;
+    result.tokensPerSecond = result.tokens / seconds;
+    result.relative = ratios[ratios.size() / 2];
+    return result;
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --corpus <dossier>     Programmes sources de reference (defaut: exemples)\n"
+              << "  --sizes <a,b,...>      Tailles des corpus en Mo (defaut: 1,10,100)\n"
+              << "  --repetitions <n>      Passes mesurees par corpus, la mediane est gardee (defaut: 7)\n"
+              << "  --baseline <fichier>   Debits de reference (cree s'il n'existe pas)\n"
+              << "  --threshold <x>        Baisse toleree du debit median, en fraction (defaut: 0.25)\n"
+              << "  --update-baseline      Reecrire le fichier de reference avec cette mesure\n";
+}
+
+int main(int argc, char *argv[])
+{
+    std::string corpusDir = "exemples";
+    std::string baselinePath;
+    std::vector<int> sizes = {1, 10, 100};
+    int repetitions = 7;
+    double threshold = 0.25;
+    bool updateBaseline = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--corpus" && hasValue)
+            corpusDir = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            baselinePath = argv[++i];
+        else if (arg == "--repetitions" && hasValue)
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threshold" && hasValue)
+            threshold = std::atof(argv[++i]);
+        else if (arg == "--update-baseline")
+            updateBaseline = true;
+        else if (arg == "--sizes" && hasValue)
+        {
+            sizes.clear();
+            std::istringstream list(argv[++i]);
+            for (std::string item; std::getline(list, item, ',');)
+                sizes.push_back(std::atoi(item.c_str()));
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    LexemePool pool;
+    if (fs::is_directory(corpusDir))
+    {
+        for (const auto &entry : fs::directory_iterator(corpusDir))
+        {
+            if (entry.path().extension() != ".yb")
+                continue;
+            std::ifstream file(entry.path());
+            std::stringstream content;
+            content << file.rdbuf();
+            collectLexemes(content.str(), pool);
+        }
+    }
+    size_t totalBytes = 0;
+    for (size_t bytes : pool.bytes)
+        totalBytes += bytes;
+    if (totalBytes == 0)
+    {
+        std::cerr << "Erreur: aucun programme .yb trouve dans " << corpusDir << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    static const char *kindNames[] = {"mots", "nombres", "operateurs", "commentaires"};
+    std::cout << "Proportions (octets) :";
+    for (int kind = 0; kind < static_cast<int>(LexemeKind::COUNT); kind++)
+        std::cout << " " << kindNames[kind] << "=" << std::fixed << std::setprecision(1)
+                  << 100.0 * pool.bytes[kind] / totalBytes << "%";
+    std::cout << "\n";
+
+    std::map<int, double> baseline;
+    bool haveBaseline = false;
+    if (!baselinePath.empty() && !updateBaseline)
+    {
+        // Une ligne par corpus : taille, débit relatif (les anciens fichiers, en Mo/s
+        // seulement, sont ignorés et réécrits)
+        std::ifstream file(baselinePath);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            std::string tag;
+            int size;
+            double relative;
+            if (fields >> tag >> size >> relative && tag == "relatif")
+                baseline[size] = relative;
+        }
+        haveBaseline = !baseline.empty();
+    }
+
+    std::cout << std::setw(10) << "corpus" << std::setw(14) << "tokens" << std::setw(12) << "Mo/s"
+              << std::setw(16) << "tokens/s" << std::setw(12) << "reference" << "\n";
+
+    bool regression = false;
+    std::map<int, double> results;
+    for (int size : sizes)
+    {
+        std::string corpus = generateCorpus(pool, static_cast<size_t>(size) * 1024 * 1024, 42 + size);
+        Throughput result = measure(corpus, repetitions);
+        results[size] = result.relative;
+
+        std::cout << std::setw(8) << size << "Mo" << std::setw(14) << result.tokens
+                  << std::setw(12) << std::setprecision(2) << result.mbPerSecond
+                  << std::setw(16) << std::setprecision(0) << result.tokensPerSecond;
+        auto reference = baseline.find(size);
+        if (haveBaseline && reference != baseline.end())
+        {
+            double ratio = result.relative / reference->second;
+            std::cout << std::setw(11) << std::setprecision(1) << (ratio - 1.0) * 100.0 << "%";
+            if (ratio < 1.0 - threshold)
+            {
+                std::cout << "  REGRESSION";
+                regression = true;
+            }
+        }
+        std::cout << "\n";
+    }
+
+    if (!baselinePath.empty() && (updateBaseline || !haveBaseline))
+    {
+        std::ofstream file(baselinePath);
+        for (const auto &entry : results)
+            file << "relatif " << entry.first << " " << std::fixed << std::setprecision(4) << entry.second << "\n";
+        std::cout << "Reference ecrite dans " << baselinePath << "\n";
+    }
+
+    if (regression)
+    {
+        std::cerr << "Erreur: le debit du tokenizer a baisse de plus de " << threshold * 100.0 << "%" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1375 @@
+/**
+ * @file diff_fuzz.cpp
+ * @brief Fuzzing différentiel : code natif contre interpréteur de référence.
+ *
+ * Des programmes YB aléatoires mais bien formés (variables déclarées avant usage,
+ * entiers et tableaux jamais mélangés, boucles bornées par un compteur) sont générés
+ * à partir de tous les constructions de Parser.hpp. Chaque programme est :
+ *  - exécuté par l'Interpreter (src/Interpreter.hpp) ;
+ *  - compilé par le Generator, assemblé avec nasm, lié avec ld puis exécuté ;
+ *    avec --target aarch64, compilé par l'AArch64Backend, assemblé et lié avec les binutils
+ *    AArch64 et exécuté directement ou par un émulateur (--runner qemu-aarch64) ;
+ *    avec --target bytecode, traduit en bytecode par le BytecodeBackend et exécuté par ybvm.
+ * La sortie standard et le code de retour (ou le signal) doivent être identiques.
+ *
+ * En cas d'écart, le programme est minimisé automatiquement : les instructions puis
+ * les sous-expressions sont retirées tant que l'écart se reproduit, et le résultat est
+ * écrit dans un fichier `mismatch_<graine>.yb` avec les deux comportements observés.
+ *
+ * Deux modes :
+ *  - boucle autonome (par défaut) : `diff_fuzz --runs 1000 --seed 1` ;
+ *  - libFuzzer (compilé avec -DYB_LIBFUZZER et -fsanitize=fuzzer) : les octets de l'entrée
+ *    pilotent les choix du générateur, le binaire s'arrête sur abort() au premier écart.
+ *    nasm, ld et le dossier de travail se règlent avec YB_FUZZ_NASM, YB_FUZZ_LD et YB_FUZZ_WORKDIR,
+ *    YB_FUZZ_CHECKED_ARITH active le mode --checked-arith, YB_FUZZ_FAULT_HANDLER le mode --fault-handler,
+ *    YB_FUZZ_TARGET=aarch64 la cible AArch64 (avec YB_FUZZ_AS et YB_FUZZ_RUNNER),
+ *    YB_FUZZ_TARGET=bytecode la cible bytecode (avec YB_FUZZ_VM).
+ *
+ * Quand un programme natif est tué par un signal, seul le signal est comparé : le
+ * tampon de sortie du runtime n'est pas vidé dans ce cas. Avec --fault-handler, le
+ * programme natif doit au contraire vider sa sortie et terminer avec le code 128 + signal,
+ * comme ybvm.
+ */
+
+#include "AArch64Backend.hpp"
+#include "BytecodeBackend.hpp"
+#include "Generator.hpp"
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+#include "Tokenizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Options de la campagne de fuzzing
+ */
+struct FuzzOptions
+{
+    Target target = Target::X86_64;
+    std::string nasm = "nasm";
+    std::string gnuAs = "aarch64-linux-gnu-as"; /**< Assembleur de la cible AArch64 */
+    std::string ld;                             /**< Vide : ld, ou aarch64-linux-gnu-ld pour AArch64 */
+    std::vector<std::string> runner;            /**< Commande qui lance le binaire (émulateur) */
+    std::string vm = "ybvm";                    /**< Machine virtuelle de la cible bytecode */
+    std::string workDir = "diff_fuzz_work";
+    std::string outDir = ".";
+    int timeoutMs = 5000;
+    int minimizeBudget = 300; /**< Exécutions maximales pendant la minimisation */
+    bool checkedArithmetic = false; /**< Compiler et interpréter avec --checked-arith */
+    bool faultHandler = false;      /**< Compiler avec --fault-handler */
+    CpuLevel cpuLevel = CpuLevel::V1; /**< Compiler avec -march (x86-64) */
+};
+
+static FuzzOptions g_options;
+
+static std::string linker()
+{
+    if (!g_options.ld.empty())
+        return g_options.ld;
+    return g_options.target == Target::AARCH64 ? "aarch64-linux-gnu-ld" : "ld";
+}
+
+/**
+ * @brief Cible nommée par --target ou YB_FUZZ_TARGET, X86_64 pour un nom inconnu
+ */
+static Target targetNamed(const std::string &name)
+{
+    if (name == "aarch64")
+        return Target::AARCH64;
+    if (name == "bytecode")
+        return Target::BYTECODE;
+    return Target::X86_64;
+}
+
+/**
+ * @brief Vrai si un signal de l'interpréteur devient le code 128 + signal après la sortie vidée
+ */
+static bool signalsAsExitCode()
+{
+    return g_options.faultHandler || g_options.target == Target::BYTECODE;
+}
+
+/**
+ * @brief Découpe une commande sur les espaces (option --runner)
+ */
+static std::vector<std::string> splitCommand(const std::string &command)
+{
+    std::vector<std::string> words;
+    std::istringstream stream(command);
+    std::string word;
+    while (stream >> word)
+        words.push_back(word);
+    return words;
+}
+
+/**
+ * @brief Source des choix du générateur : octets d'une entrée libFuzzer ou graine aléatoire
+ *
+ * Une entrée épuisée donne toujours 0, ce qui choisit l'alternative la plus simple :
+ * libFuzzer peut ainsi raccourcir une entrée sans la rendre invalide.
+ */
+class ByteSource
+{
+public:
+    ByteSource(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+    explicit ByteSource(uint64_t seed) : m_rng(seed), m_random(true) {}
+
+    /**
+     * @brief Choix uniforme dans [0, bound)
+     */
+    unsigned next(unsigned bound)
+    {
+        if (bound <= 1)
+            return 0;
+        if (m_random)
+            return static_cast<unsigned>(m_rng() % bound);
+        unsigned value = 0;
+        for (unsigned range = 1; range < bound && m_position < m_size; range <<= 8)
+            value = (value << 8) | m_data[m_position++];
+        return value % bound;
+    }
+
+    /**
+     * @brief Vrai avec une probabilité d'environ percent %
+     */
+    bool chance(unsigned percent) { return next(100) < percent; }
+
+private:
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_position = 0;
+    std::mt19937_64 m_rng;
+    bool m_random = false;
+};
+
+/**
+ * @brief Génère le texte source d'un programme YB bien formé
+ */
+class ProgramGenerator
+{
+public:
+    explicit ProgramGenerator(ByteSource &source) : m_source(source) {}
+
+    std::string generate()
+    {
+        m_out.str("");
+        m_scopes.assign(1, {});
+        m_nextName = 0;
+        m_statements = 0;
+        m_loopDepth = 0;
+
+        int count = 3 + static_cast<int>(m_source.next(12));
+        for (int i = 0; i < count && m_statements < MAX_STATEMENTS; i++)
+            statement(0);
+        return m_out.str();
+    }
+
+private:
+    static constexpr int MAX_STATEMENTS = 60;
+    static constexpr int MAX_EXPR_DEPTH = 3;
+
+    enum class Kind
+    {
+        INT,
+        ARRAY,
+        MATRIX
+    };
+
+    struct Variable
+    {
+        std::string name;
+        Kind kind;
+        bool counter; // Compteur de boucle : jamais réaffecté par le corps
+    };
+
+    std::vector<const Variable *> visible(Kind kind, bool assignable = false) const
+    {
+        std::vector<const Variable *> result;
+        for (const auto &scope : m_scopes)
+            for (const auto &variable : scope)
+                if (variable.kind == kind && !(assignable && variable.counter))
+                    result.push_back(&variable);
+        return result;
+    }
+
+    const Variable *pick(Kind kind, bool assignable = false)
+    {
+        auto candidates = visible(kind, assignable);
+        if (candidates.empty())
+            return nullptr;
+        return candidates[m_source.next(static_cast<unsigned>(candidates.size()))];
+    }
+
+    std::string declare(Kind kind, bool counter = false)
+    {
+        std::string prefix = kind == Kind::INT ? (counter ? "i" : "v") : (kind == Kind::ARRAY ? "a" : "m");
+        std::string name = prefix + std::to_string(m_nextName++);
+        m_scopes.back().push_back({name, kind, counter});
+        return name;
+    }
+
+    void indent(int depth)
+    {
+        m_out << std::string(depth * 4, ' ');
+    }
+
+    std::string literal()
+    {
+        static const char *edges[] = {"9223372036854775807", "4611686018427387904", "4294967296",
+                                      "2147483648", "255", "256", "1000000007"};
+        unsigned choice = m_source.next(100);
+        if (choice < 70)
+            return std::to_string(m_source.next(21));
+        if (choice < 90)
+            return std::to_string(m_source.next(1000000));
+        return edges[m_source.next(sizeof(edges) / sizeof(edges[0]))];
+    }
+
+    std::string index(const std::string &array)
+    {
+        unsigned choice = m_source.next(100);
+        auto integers = visible(Kind::INT);
+        if (choice < 40)
+            return std::to_string(m_source.next(4));
+        if (choice < 80 && !integers.empty())
+        {
+            const Variable *variable = integers[m_source.next(static_cast<unsigned>(integers.size()))];
+            return "(" + variable->name + " % len(" + array + "))";
+        }
+        return intExpr(MAX_EXPR_DEPTH - 1);
+    }
+
+    std::string intExpr(int depth)
+    {
+        static const char *operators[] = {"+", "-", "*", "/", "%", "==", "!=", "<", ">", "<=", ">=", "&&", "||"};
+        unsigned choice = m_source.next(depth >= MAX_EXPR_DEPTH ? 40 : 100);
+
+        if (choice < 20)
+            return literal();
+        if (choice < 40)
+        {
+            const Variable *variable = pick(Kind::INT);
+            return variable ? variable->name : literal();
+        }
+        if (choice < 65)
+        {
+            unsigned op = m_source.next(sizeof(operators) / sizeof(operators[0]));
+            std::string left = intExpr(depth + 1);
+            // Le diviseur est le plus souvent un littéral non nul, pour que la division
+            // par zéro reste un cas testé mais rare
+            std::string right = (op == 3 || op == 4) && m_source.chance(80)
+                                    ? std::to_string(1 + m_source.next(9))
+                                    : intExpr(depth + 1);
+            return "(" + left + " " + operators[op] + " " + right + ")";
+        }
+        if (choice < 72)
+            return "(0 - " + intExpr(depth + 1) + ")";
+        if (choice < 80)
+        {
+            const Variable *array = m_source.chance(50) ? pick(Kind::ARRAY) : pick(Kind::MATRIX);
+            return array ? "len(" + array->name + ")" : literal();
+        }
+        if (choice < 90)
+        {
+            const Variable *array = pick(Kind::ARRAY);
+            return array ? array->name + "[" + index(array->name) + "]" : literal();
+        }
+        const Variable *matrix = pick(Kind::MATRIX);
+        if (!matrix)
+            return literal();
+        return matrix->name + "[" + std::to_string(m_source.next(4)) + "][" + index(matrix->name) + "]";
+    }
+
+    std::string condition()
+    {
+        static const char *comparisons[] = {"==", "!=", "<", ">", "<=", ">="};
+        if (m_source.chance(20))
+            return intExpr(1);
+        return intExpr(2) + " " + comparisons[m_source.next(6)] + " " + intExpr(2);
+    }
+
+    void block(int depth)
+    {
+        m_out << "{\n";
+        m_scopes.push_back({});
+        int count = 1 + static_cast<int>(m_source.next(4));
+        for (int i = 0; i < count && m_statements < MAX_STATEMENTS; i++)
+            statement(depth + 1);
+        // Un bloc terminé par exit part dans .text.cold, y compris imbriqué dans un autre
+        if (m_source.chance(15))
+        {
+            indent(depth + 1);
+            m_out << "exit(" << intExpr(1) << ");\n";
+        }
+        m_scopes.pop_back();
+        indent(depth);
+        m_out << "}";
+    }
+
+    /**
+     * @brief match aux valeurs denses, éparses dans un intervalle de 64, ou dispersées sur
+     * 64 bits : les trois aiguillages du Generator sont exercés
+     */
+    void matchStatement(int depth)
+    {
+        unsigned shape = m_source.next(3);
+        long long base = m_source.chance(30) ? -static_cast<long long>(m_source.next(6)) : 0;
+        auto value = [&]() -> long long
+        {
+            if (shape == 0)
+                return base + m_source.next(12);
+            if (shape == 1)
+                return base + m_source.next(60);
+            long long magnitude = static_cast<long long>(m_source.next(1u << 20)) << (m_source.next(4) * 14);
+            return m_source.chance(50) ? -magnitude : magnitude;
+        };
+
+        std::vector<std::vector<long long>> arms;
+        std::vector<long long> used;
+        int armCount = 1 + static_cast<int>(m_source.next(shape == 1 ? 3 : 6));
+        for (int arm = 0; arm < armCount; arm++)
+        {
+            std::vector<long long> values;
+            int count = 1 + static_cast<int>(m_source.next(3));
+            for (int i = 0; i < count; i++)
+            {
+                long long candidate = value();
+                if (std::find(used.begin(), used.end(), candidate) == used.end())
+                {
+                    used.push_back(candidate);
+                    values.push_back(candidate);
+                }
+            }
+            if (!values.empty())
+                arms.push_back(values);
+        }
+
+        // Le plus souvent, une des valeurs des branches est choisie
+        std::string subject;
+        if (shape < 2)
+            subject = "(" + intExpr(1) + " % " + std::to_string(shape == 0 ? 14 : 64) + ") - " + std::to_string(-base);
+        else if (m_source.chance(70))
+        {
+            long long chosen = used[m_source.next(static_cast<unsigned>(used.size()))];
+            subject = chosen < 0 ? "(0 - " + std::to_string(-chosen) + ")" : std::to_string(chosen);
+            if (m_source.chance(50))
+                subject = "(" + subject + " + " + intExpr(1) + " * 0)";
+        }
+        else
+            subject = intExpr(1);
+
+        m_out << "match (" << subject << ") {\n";
+        for (const auto &values : arms)
+        {
+            indent(depth + 1);
+            for (size_t i = 0; i < values.size(); i++)
+                m_out << (i ? ", " : "") << values[i];
+            m_out << " => ";
+            block(depth + 1);
+            m_out << "\n";
+        }
+        if (m_source.chance(50))
+        {
+            indent(depth + 1);
+            m_out << "_ => ";
+            block(depth + 1);
+            m_out << "\n";
+        }
+        indent(depth);
+        m_out << "}\n";
+    }
+
+    void statement(int depth)
+    {
+        m_statements++;
+        unsigned choice = m_source.next(100);
+        indent(depth);
+
+        if (choice < 15)
+        {
+            std::string value = intExpr(0);
+            m_out << "let " << declare(Kind::INT) << " = " << value << ";\n";
+        }
+        else if (choice < 21)
+        {
+            std::string elements;
+            int count = m_source.chance(10) ? 0 : 1 + static_cast<int>(m_source.next(6));
+            for (int i = 0; i < count; i++)
+                elements += (i ? ", " : "") + intExpr(1);
+            m_out << "let " << declare(Kind::ARRAY) << " = [" << elements << "];\n";
+        }
+        else if (choice < 25)
+        {
+            std::string rows = m_source.chance(10) ? intExpr(2) : std::to_string(m_source.next(6));
+            std::string cols = m_source.chance(10) ? intExpr(2) : std::to_string(1 + m_source.next(5));
+            m_out << "let " << declare(Kind::MATRIX) << " = matrix(" << rows << ", " << cols << ");\n";
+        }
+        else if (choice < 38)
+        {
+            const Variable *variable = pick(Kind::INT, true);
+            if (variable)
+                m_out << variable->name << " = " << intExpr(0) << ";\n";
+            else
+                m_out << "print(" << intExpr(0) << ");\n";
+        }
+        else if (choice < 48)
+        {
+            const Variable *array = pick(Kind::ARRAY);
+            if (array)
+                m_out << array->name << "[" << index(array->name) << "] = " << intExpr(0) << ";\n";
+            else
+                m_out << "print(" << intExpr(0) << ");\n";
+        }
+        else if (choice < 56)
+        {
+            const Variable *matrix = pick(Kind::MATRIX);
+            if (matrix)
+                m_out << matrix->name << "[" << index(matrix->name) << "][" << index(matrix->name)
+                      << "] = " << intExpr(0) << ";\n";
+            else
+                m_out << "print(" << intExpr(0) << ");\n";
+        }
+        else if (choice < 58)
+        {
+            // Alias d'un tableau : les deux noms partagent les mêmes éléments
+            const Variable *array = pick(Kind::ARRAY);
+            if (array)
+            {
+                std::string name = array->name;
+                m_out << "let " << declare(Kind::ARRAY) << " = " << name << ";\n";
+            }
+            else
+                m_out << "print(" << intExpr(0) << ");\n";
+        }
+        else if (choice < 68)
+        {
+            m_out << "print(" << intExpr(0) << ");\n";
+        }
+        else if (choice < 74)
+        {
+            // Plusieurs valeurs, tableaux et matrices affichés en entier
+            std::string values;
+            int count = 1 + static_cast<int>(m_source.next(4));
+            for (int i = 0; i < count; i++)
+            {
+                const Variable *array = m_source.chance(50) ? nullptr : pick(m_source.chance(70) ? Kind::ARRAY : Kind::MATRIX);
+                values += (i ? ", " : "") + (array ? array->name : intExpr(1));
+            }
+            m_out << "print(" << values << ");\n";
+        }
+        else if (choice < 80 && depth < 4)
+        {
+            m_out << "if (" << condition() << ") ";
+            block(depth);
+            if (m_source.chance(40))
+            {
+                m_out << " else ";
+                block(depth);
+            }
+            m_out << "\n";
+        }
+        else if (choice < 84 && depth < 4)
+        {
+            matchStatement(depth);
+        }
+        else if (choice < 96 && m_loopDepth < 3 && depth < 4)
+        {
+            std::string limit = std::to_string(m_source.next(9));
+            const Variable *array = pick(Kind::ARRAY);
+            if (array && m_source.chance(30))
+                limit = "len(" + array->name + ")";
+
+            std::string counter = declare(Kind::INT, true);
+            m_out << "let " << counter << " = 0;\n";
+            indent(depth);
+            m_out << "while (" << counter << " < " << limit << ") {\n";
+            m_loopDepth++;
+            m_scopes.push_back({});
+            int count = 1 + static_cast<int>(m_source.next(4));
+            for (int i = 0; i < count && m_statements < MAX_STATEMENTS; i++)
+                statement(depth + 1);
+            m_scopes.pop_back();
+            m_loopDepth--;
+            indent(depth + 1);
+            m_out << counter << " = " << counter << " + 1;\n";
+            indent(depth);
+            m_out << "}\n";
+        }
+        else if (choice < 98)
+        {
+            m_out << "exit(" << intExpr(1) << ");\n";
+        }
+        else
+        {
+            block(depth);
+            m_out << "\n";
+        }
+    }
+
+    ByteSource &m_source;
+    std::ostringstream m_out;
+    std::vector<std::vector<Variable>> m_scopes;
+    int m_nextName = 0;
+    int m_statements = 0;
+    int m_loopDepth = 0;
+};
+
+/**
+ * @brief Réécrit un AST en texte source (les expressions binaires sont parenthésées)
+ */
+static std::string printExpr(const std::shared_ptr<Expr> &expr)
+{
+    static const char *operators[] = {"+", "*", "-", "/", "%", "==", ">", "<", ">=", "<=", "&&", "||", "!="};
+    switch (expr->getType())
+    {
+    case ExprType::INTEGER:
+        return *static_cast<const IntExpr *>(expr.get())->token.value;
+    case ExprType::VARIABLE:
+        return *static_cast<const VarExpr *>(expr.get())->token.value;
+    case ExprType::BINARY:
+    {
+        auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+        return "(" + printExpr(binExpr->gauche) + " " + operators[static_cast<int>(binExpr->op)] + " " +
+               printExpr(binExpr->droite) + ")";
+    }
+    case ExprType::ARRAY:
+    {
+        std::string text = "[";
+        auto arrayExpr = static_cast<const ArrayExpr *>(expr.get());
+        for (size_t i = 0; i < arrayExpr->elements.size(); i++)
+            text += (i ? ", " : "") + printExpr(arrayExpr->elements[i]);
+        return text + "]";
+    }
+    case ExprType::ARRAY_ACCESS:
+    {
+        auto accessExpr = static_cast<const ArrayAccessExpr *>(expr.get());
+        return printExpr(accessExpr->array) + "[" + printExpr(accessExpr->index) + "]";
+    }
+    case ExprType::LENGTH:
+        return "len(" + printExpr(static_cast<const LengthExpr *>(expr.get())->array) + ")";
+    case ExprType::MATRIX:
+    {
+        auto matrixExpr = static_cast<const MatrixExpr *>(expr.get());
+        return "matrix(" + printExpr(matrixExpr->rows) + ", " + printExpr(matrixExpr->cols) + ")";
+    }
+    case ExprType::MATRIX_ACCESS:
+    {
+        auto accessExpr = static_cast<const MatrixAccessExpr *>(expr.get());
+        return printExpr(accessExpr->matrix) + "[" + printExpr(accessExpr->row) + "][" +
+               printExpr(accessExpr->col) + "]";
+    }
+    }
+    return "0";
+}
+
+static void printStmt(const std::shared_ptr<Stmt> &stmt, int depth, std::ostringstream &out);
+
+static void printBlock(const BlockStmt *block, int depth, std::ostringstream &out)
+{
+    out << "{\n";
+    for (const auto &child : block->statements)
+        printStmt(child, depth + 1, out);
+    out << std::string(depth * 4, ' ') << "}";
+}
+
+static void printStmt(const std::shared_ptr<Stmt> &stmt, int depth, std::ostringstream &out)
+{
+    out << std::string(depth * 4, ' ');
+    switch (stmt->getType())
+    {
+    case StmtType::EXIT:
+        out << "exit(" << printExpr(static_cast<const ExitStmt *>(stmt.get())->expr) << ");\n";
+        break;
+    case StmtType::LET:
+    {
+        auto letStmt = static_cast<const LetStmt *>(stmt.get());
+        out << "let " << *letStmt->var.value << " = " << printExpr(letStmt->expr) << ";\n";
+        break;
+    }
+    case StmtType::ASSIGN:
+    {
+        auto assignStmt = static_cast<const AssignStmt *>(stmt.get());
+        out << *assignStmt->var.value << " = " << printExpr(assignStmt->expr) << ";\n";
+        break;
+    }
+    case StmtType::PRINT:
+    {
+        out << "print(";
+        const char *separator = "";
+        for (const auto &arg : static_cast<const PrintStmt *>(stmt.get())->args)
+        {
+            out << separator << printExpr(arg.expr);
+            separator = ", ";
+        }
+        out << ");\n";
+        break;
+    }
+    case StmtType::BLOCK:
+        printBlock(static_cast<const BlockStmt *>(stmt.get()), depth, out);
+        out << "\n";
+        break;
+    case StmtType::IF:
+    {
+        auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+        out << "if (" << printExpr(ifStmt->condition) << ") ";
+        printBlock(ifStmt->thenBranch.get(), depth, out);
+        if (ifStmt->elseBranch)
+        {
+            out << " else ";
+            printBlock(ifStmt->elseBranch.get(), depth, out);
+        }
+        out << "\n";
+        break;
+    }
+    case StmtType::MATCH:
+    {
+        auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+        out << "match (" << printExpr(matchStmt->subject) << ") {\n";
+        for (const MatchArm &arm : matchStmt->arms)
+        {
+            out << std::string((depth + 1) * 4, ' ');
+            for (size_t i = 0; i < arm.values.size(); i++)
+                out << (i ? ", " : "") << arm.values[i];
+            out << " => ";
+            printBlock(arm.body.get(), depth + 1, out);
+            out << "\n";
+        }
+        if (matchStmt->defaultBranch)
+        {
+            out << std::string((depth + 1) * 4, ' ') << "_ => ";
+            printBlock(matchStmt->defaultBranch.get(), depth + 1, out);
+            out << "\n";
+        }
+        out << std::string(depth * 4, ' ') << "}\n";
+        break;
+    }
+    case StmtType::WHILE:
+    {
+        auto whileStmt = static_cast<const WhileStmt *>(stmt.get());
+        out << "while (" << printExpr(whileStmt->condition) << ") ";
+        printBlock(whileStmt->body.get(), depth, out);
+        out << "\n";
+        break;
+    }
+    case StmtType::ARRAY_ASSIGN:
+    {
+        auto assignStmt = static_cast<const ArrayAssignStmt *>(stmt.get());
+        out << printExpr(assignStmt->array) << "[" << printExpr(assignStmt->index) << "] = "
+            << printExpr(assignStmt->value) << ";\n";
+        break;
+    }
+    case StmtType::MATRIX_ASSIGN:
+    {
+        auto assignStmt = static_cast<const MatrixAssignStmt *>(stmt.get());
+        out << printExpr(assignStmt->matrix) << "[" << printExpr(assignStmt->row) << "]["
+            << printExpr(assignStmt->col) << "] = " << printExpr(assignStmt->value) << ";\n";
+        break;
+    }
+    case StmtType::PARAM:
+    {
+        auto paramStmt = static_cast<const ParamStmt *>(stmt.get());
+        out << "param " << *paramStmt->var.value << (paramStmt->array ? "[]" : "") << ";\n";
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static std::string printProgram(const Program &program)
+{
+    std::ostringstream out;
+    for (const auto &stmt : program.statements)
+        printStmt(stmt, 0, out);
+    return out.str();
+}
+
+static std::optional<Program> parseSource(const std::string &source)
+{
+    Tokenizer tokenizer(source);
+    Parser parser(tokenizer);
+    return parser.parse();
+}
+
+/**
+ * @brief Résultat de l'exécution du binaire natif
+ */
+struct NativeResult
+{
+    bool built = false;
+    bool timedOut = false;
+    bool exited = false;
+    int exitCode = 0;
+    int signal = 0;
+    std::string output;
+};
+
+/**
+ * @brief Lance une commande, capture sa sortie standard et l'arrête après timeoutMs
+ * @return Le statut waitpid, ou -1 si le processus n'a pas pu être lancé
+ */
+static int runProcess(const std::vector<std::string> &args, std::string *output, int timeoutMs, bool *timedOut)
+{
+    std::vector<char *> argv;
+    for (const auto &arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0)
+        return -1;
+
+    pid_t pid = fork();
+    if (pid < 0)
+        return -1;
+    if (pid == 0)
+    {
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(output ? pipeFds[1] : devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        struct rlimit cpu = {static_cast<rlim_t>(timeoutMs / 1000 + 1), static_cast<rlim_t>(timeoutMs / 1000 + 2)};
+        setrlimit(RLIMIT_CPU, &cpu);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    close(pipeFds[1]);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    char buffer[4096];
+    while (true)
+    {
+        int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             deadline - std::chrono::steady_clock::now())
+                                             .count());
+        struct pollfd fd = {pipeFds[0], POLLIN, 0};
+        if (remaining <= 0 || poll(&fd, 1, remaining) <= 0)
+        {
+            kill(pid, SIGKILL);
+            if (timedOut)
+                *timedOut = true;
+            break;
+        }
+        ssize_t count = read(pipeFds[0], buffer, sizeof(buffer));
+        if (count <= 0)
+            break;
+        if (output && output->size() < (1u << 22))
+            output->append(buffer, count);
+    }
+    close(pipeFds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return status;
+}
+
+/**
+ * @brief Compile le programme pour la cible choisie, l'assemble et le lie
+ * @return Vrai si le binaire `base` a été produit
+ */
+static bool buildNative(const Program &program, const std::string &base)
+{
+    std::vector<std::string> assemble;
+    if (g_options.target == Target::BYTECODE)
+    {
+        // Pas d'assemblage : le module est exécuté par ybvm
+        LoweringGenerator generator(std::make_unique<BytecodeBackend>(), g_options.checkedArithmetic);
+        std::ofstream module(base + ".ybc", std::ios::binary);
+        module << generator.generateProgram(program);
+        return static_cast<bool>(module);
+    }
+    if (g_options.target == Target::AARCH64)
+    {
+        LoweringGenerator generator(std::make_unique<AArch64Backend>(), g_options.checkedArithmetic);
+        std::ofstream asmFile(base + ".s");
+        asmFile << generator.generateProgram(program);
+        assemble = {g_options.gnuAs, base + ".s", "-o", base + ".o"};
+    }
+    else
+    {
+        GeneratorOptions options;
+        options.checkedArithmetic = g_options.checkedArithmetic;
+        options.faultHandler = g_options.faultHandler;
+        options.runtime.cpuLevel = g_options.cpuLevel;
+        Generator generator(program, options);
+        std::ofstream asmFile(base + ".asm");
+        asmFile << generator.generateAssembly();
+        assemble = {g_options.nasm, "-f", "elf64", base + ".asm", "-o", base + ".o"};
+    }
+
+    if (runProcess(assemble, nullptr, g_options.timeoutMs, nullptr) != 0)
+        return false;
+    return runProcess({linker(), "-o", base, base + ".o"}, nullptr, g_options.timeoutMs, nullptr) == 0;
+}
+
+/**
+ * @brief Compile le programme puis l'exécute
+ */
+static NativeResult runNative(const Program &program)
+{
+    NativeResult result;
+    fs::create_directories(g_options.workDir);
+    std::string base = (fs::path(g_options.workDir) / ("case_" + std::to_string(getpid()))).string();
+
+    if (!buildNative(program, base))
+        return result;
+    result.built = true;
+
+    std::vector<std::string> command = g_options.runner;
+    if (g_options.target == Target::BYTECODE)
+        command = {g_options.vm, base + ".ybc"};
+    else
+        command.push_back(base);
+    int status = runProcess(command, &result.output, g_options.timeoutMs, &result.timedOut);
+    if (WIFEXITED(status))
+    {
+        result.exited = true;
+        result.exitCode = WEXITSTATUS(status);
+    }
+    else if (WIFSIGNALED(status))
+    {
+        result.signal = WTERMSIG(status);
+    }
+    return result;
+}
+
+static std::string describe(const InterpreterResult &result)
+{
+    if (result.status == InterpreterResult::Status::SIGNALED)
+        return "signal " + std::to_string(result.signal);
+    return "code " + std::to_string(result.exitCode) + ", " + std::to_string(result.output.size()) + " octets";
+}
+
+static std::string describe(const NativeResult &result)
+{
+    if (result.timedOut)
+        return "delai depasse";
+    if (!result.exited)
+        return "signal " + std::to_string(result.signal);
+    return "code " + std::to_string(result.exitCode) + ", " + std::to_string(result.output.size()) + " octets";
+}
+
+/**
+ * @brief Compare les deux exécutions
+ * @return Une description de l'écart, vide si les comportements sont identiques
+ */
+static std::string compare(const InterpreterResult &expected, const NativeResult &actual)
+{
+    bool same;
+    if (actual.timedOut)
+        same = false;
+    else if (expected.status == InterpreterResult::Status::SIGNALED && signalsAsExitCode())
+        same = actual.exited && actual.exitCode == 128 + expected.signal && actual.output == expected.output;
+    else if (expected.status == InterpreterResult::Status::SIGNALED)
+        same = !actual.exited && actual.signal == expected.signal;
+    else
+        same = actual.exited && actual.exitCode == expected.exitCode && actual.output == expected.output;
+
+    if (same)
+        return "";
+    std::string text = "interpreteur: " + describe(expected) + " / natif: " + describe(actual);
+    if (expected.status == InterpreterResult::Status::EXITED && actual.exited && actual.output != expected.output)
+    {
+        size_t line = 1;
+        for (size_t i = 0; i < expected.output.size() && i < actual.output.size() &&
+                           expected.output[i] == actual.output[i];
+             i++)
+            line += expected.output[i] == '\n';
+        text += " (sortie differente a partir de la ligne " + std::to_string(line) + ")";
+    }
+    return text;
+}
+
+/**
+ * @brief Résultat du test d'un programme
+ */
+struct CaseResult
+{
+    bool compared = false; /**< Faux si le programme est hors modèle ou ne termine pas */
+    std::string mismatch;  /**< Description de l'écart, vide si aucun */
+};
+
+static CaseResult checkProgram(const Program &program)
+{
+    CaseResult result;
+    Interpreter interpreter(program, 10000000, g_options.checkedArithmetic);
+    InterpreterResult expected = interpreter.run();
+    if (expected.status == InterpreterResult::Status::INVALID ||
+        expected.status == InterpreterResult::Status::STEP_LIMIT)
+        return result;
+
+    NativeResult actual = runNative(program);
+    if (!actual.built)
+    {
+        result.compared = true;
+        result.mismatch = "le code genere ne s'assemble pas ou ne se lie pas";
+        return result;
+    }
+    result.compared = true;
+    result.mismatch = compare(expected, actual);
+    return result;
+}
+
+static bool reproduces(const std::string &source)
+{
+    auto program = parseSource(source);
+    return program && !checkProgram(program.value()).mismatch.empty();
+}
+
+/**
+ * @brief Collecte les listes d'instructions (programme et blocs) de l'AST
+ */
+static void collectLists(std::vector<std::shared_ptr<Stmt>> &list,
+                         std::vector<std::vector<std::shared_ptr<Stmt>> *> &lists)
+{
+    lists.push_back(&list);
+    for (auto &stmt : list)
+    {
+        switch (stmt->getType())
+        {
+        case StmtType::BLOCK:
+            collectLists(static_cast<BlockStmt *>(stmt.get())->statements, lists);
+            break;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<IfStmt *>(stmt.get());
+            collectLists(ifStmt->thenBranch->statements, lists);
+            if (ifStmt->elseBranch)
+                collectLists(ifStmt->elseBranch->statements, lists);
+            break;
+        }
+        case StmtType::WHILE:
+            collectLists(static_cast<WhileStmt *>(stmt.get())->body->statements, lists);
+            break;
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<MatchStmt *>(stmt.get());
+            for (MatchArm &arm : matchStmt->arms)
+                collectLists(arm.body->statements, lists);
+            if (matchStmt->defaultBranch)
+                collectLists(matchStmt->defaultBranch->statements, lists);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+static void collectSlots(std::shared_ptr<Expr> &expr, std::vector<std::shared_ptr<Expr> *> &slots)
+{
+    slots.push_back(&expr);
+    switch (expr->getType())
+    {
+    case ExprType::BINARY:
+        collectSlots(static_cast<BinaryExpr *>(expr.get())->gauche, slots);
+        collectSlots(static_cast<BinaryExpr *>(expr.get())->droite, slots);
+        break;
+    case ExprType::ARRAY:
+        for (auto &element : static_cast<ArrayExpr *>(expr.get())->elements)
+            collectSlots(element, slots);
+        break;
+    case ExprType::ARRAY_ACCESS:
+        collectSlots(static_cast<ArrayAccessExpr *>(expr.get())->index, slots);
+        break;
+    case ExprType::MATRIX:
+        collectSlots(static_cast<MatrixExpr *>(expr.get())->rows, slots);
+        collectSlots(static_cast<MatrixExpr *>(expr.get())->cols, slots);
+        break;
+    case ExprType::MATRIX_ACCESS:
+        collectSlots(static_cast<MatrixAccessExpr *>(expr.get())->row, slots);
+        collectSlots(static_cast<MatrixAccessExpr *>(expr.get())->col, slots);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Collecte les emplacements d'expressions des instructions (hors conditions de boucle,
+ * qui gardent le compteur et donc la terminaison)
+ */
+static void collectSlots(std::vector<std::shared_ptr<Stmt>> &list, std::vector<std::shared_ptr<Expr> *> &slots)
+{
+    for (auto &stmt : list)
+    {
+        switch (stmt->getType())
+        {
+        case StmtType::EXIT:
+            collectSlots(static_cast<ExitStmt *>(stmt.get())->expr, slots);
+            break;
+        case StmtType::LET:
+            collectSlots(static_cast<LetStmt *>(stmt.get())->expr, slots);
+            break;
+        case StmtType::ASSIGN:
+            collectSlots(static_cast<AssignStmt *>(stmt.get())->expr, slots);
+            break;
+        case StmtType::PRINT:
+            for (auto &arg : static_cast<PrintStmt *>(stmt.get())->args)
+                collectSlots(arg.expr, slots);
+            break;
+        case StmtType::BLOCK:
+            collectSlots(static_cast<BlockStmt *>(stmt.get())->statements, slots);
+            break;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<IfStmt *>(stmt.get());
+            collectSlots(ifStmt->condition, slots);
+            collectSlots(ifStmt->thenBranch->statements, slots);
+            if (ifStmt->elseBranch)
+                collectSlots(ifStmt->elseBranch->statements, slots);
+            break;
+        }
+        case StmtType::WHILE:
+            collectSlots(static_cast<WhileStmt *>(stmt.get())->body->statements, slots);
+            break;
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<MatchStmt *>(stmt.get());
+            collectSlots(matchStmt->subject, slots);
+            for (MatchArm &arm : matchStmt->arms)
+                collectSlots(arm.body->statements, slots);
+            if (matchStmt->defaultBranch)
+                collectSlots(matchStmt->defaultBranch->statements, slots);
+            break;
+        }
+        case StmtType::ARRAY_ASSIGN:
+        {
+            auto assignStmt = static_cast<ArrayAssignStmt *>(stmt.get());
+            collectSlots(assignStmt->index, slots);
+            collectSlots(assignStmt->value, slots);
+            break;
+        }
+        case StmtType::MATRIX_ASSIGN:
+        {
+            auto assignStmt = static_cast<MatrixAssignStmt *>(stmt.get());
+            collectSlots(assignStmt->row, slots);
+            collectSlots(assignStmt->col, slots);
+            collectSlots(assignStmt->value, slots);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Réduit un programme tant que l'écart se reproduit
+ *
+ * Deux passes répétées jusqu'à stabilité : suppression d'instructions (de la fin vers le
+ * début de chaque bloc), puis remplacement d'expressions par un de leurs opérandes ou par 0.
+ * Un candidat hors modèle pour l'interpréteur n'est jamais retenu.
+ */
+static std::string minimize(const std::string &source)
+{
+    auto parsed = parseSource(source);
+    if (!parsed)
+        return source;
+    Program program = parsed.value();
+    int budget = g_options.minimizeBudget;
+
+    auto attempt = [&]()
+    {
+        budget--;
+        return reproduces(printProgram(program));
+    };
+
+    bool progress = true;
+    while (progress && budget > 0)
+    {
+        progress = false;
+
+        // Après une réduction réussie, les listes collectées ne sont plus valides : on recommence
+        std::vector<std::vector<std::shared_ptr<Stmt>> *> lists;
+        collectLists(program.statements, lists);
+        for (size_t l = 0; l < lists.size() && budget > 0 && !progress; l++)
+        {
+            auto &list = *lists[l];
+            for (size_t i = list.size(); i-- > 0 && budget > 0;)
+            {
+                auto removed = list[i];
+                list.erase(list.begin() + i);
+                if (attempt())
+                {
+                    progress = true;
+                    break;
+                }
+                list.insert(list.begin() + i, removed);
+            }
+        }
+        if (progress)
+            continue;
+
+        std::vector<std::shared_ptr<Expr> *> slots;
+        collectSlots(program.statements, slots);
+        for (size_t s = 0; s < slots.size() && budget > 0; s++)
+        {
+            std::shared_ptr<Expr> original = *slots[s];
+            std::vector<std::shared_ptr<Expr>> candidates;
+            if (original->getType() == ExprType::BINARY)
+            {
+                candidates.push_back(static_cast<BinaryExpr *>(original.get())->gauche);
+                candidates.push_back(static_cast<BinaryExpr *>(original.get())->droite);
+            }
+            if (original->getType() != ExprType::INTEGER)
+                candidates.push_back(std::make_shared<IntExpr>(Token{TokenType::INT_LITERAL, "0"}));
+
+            for (const auto &candidate : candidates)
+            {
+                *slots[s] = candidate;
+                if (attempt())
+                {
+                    progress = true;
+                    break;
+                }
+                *slots[s] = original;
+            }
+            if (progress)
+                break;
+        }
+    }
+    return printProgram(program);
+}
+
+/**
+ * @brief Minimise et enregistre un écart
+ * @return Le chemin du fichier écrit
+ */
+static std::string reportMismatch(const std::string &source, const std::string &name)
+{
+    std::string reduced = minimize(source);
+    auto program = parseSource(reduced);
+    std::string mismatch = program ? checkProgram(program.value()).mismatch : "";
+
+    fs::create_directories(g_options.outDir);
+    std::string path = (fs::path(g_options.outDir) / ("mismatch_" + name + ".yb")).string();
+    std::ofstream file(path);
+    file << "// diff_fuzz : " << mismatch << "\n";
+    file << reduced;
+    file << "\n/* Programme d'origine :\n" << source << "*/\n";
+
+    std::cerr << "Ecart: " << mismatch << "\n"
+              << "Programme minimise (" << path << ") :\n"
+              << reduced << std::endl;
+    return path;
+}
+
+#ifdef YB_LIBFUZZER
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***)
+{
+    if (const char *value = std::getenv("YB_FUZZ_NASM"))
+        g_options.nasm = value;
+    if (const char *value = std::getenv("YB_FUZZ_LD"))
+        g_options.ld = value;
+    if (const char *value = std::getenv("YB_FUZZ_WORKDIR"))
+        g_options.workDir = value;
+    if (std::getenv("YB_FUZZ_CHECKED_ARITH"))
+        g_options.checkedArithmetic = true;
+    if (std::getenv("YB_FUZZ_FAULT_HANDLER"))
+        g_options.faultHandler = true;
+    if (const char *value = std::getenv("YB_FUZZ_TARGET"))
+        g_options.target = targetNamed(value);
+    if (const char *value = std::getenv("YB_FUZZ_AS"))
+        g_options.gnuAs = value;
+    if (const char *value = std::getenv("YB_FUZZ_RUNNER"))
+        g_options.runner = splitCommand(value);
+    if (const char *value = std::getenv("YB_FUZZ_VM"))
+        g_options.vm = value;
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    ByteSource source(data, size);
+    std::string text = ProgramGenerator(source).generate();
+    auto program = parseSource(text);
+    if (!program)
+        return 0;
+    if (!checkProgram(program.value()).mismatch.empty())
+    {
+        reportMismatch(text, std::to_string(std::hash<std::string>()(text)));
+        std::abort();
+    }
+    return 0;
+}
+
+#else
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --runs <n>            Programmes generes (defaut: 1000, 0 = sans fin)\n"
+              << "  --seed <n>            Premiere graine (defaut: 1)\n"
+              << "  --nasm <chemin>       Assembleur (defaut: nasm)\n"
+              << "  --ld <chemin>         Editeur de liens (defaut: ld, aarch64-linux-gnu-ld pour aarch64)\n"
+              << "  --target <cible>      x86-64 (defaut), aarch64 ou bytecode\n"
+              << "  --as <chemin>         Assembleur AArch64 (defaut: aarch64-linux-gnu-as)\n"
+              << "  --runner <commande>   Lanceur des binaires, ex. \"qemu-aarch64\" (defaut: aucun)\n"
+              << "  --vm <chemin>         Machine virtuelle de la cible bytecode (defaut: ybvm)\n"
+              << "  --workdir <dossier>   Dossier temporaire (defaut: diff_fuzz_work)\n"
+              << "  --out <dossier>       Dossier des programmes minimises (defaut: .)\n"
+              << "  --timeout <ms>        Delai par execution native (defaut: 5000)\n"
+              << "  --keep-going          Continuer apres un ecart\n"
+              << "  --checked-arith       Tester le mode --checked-arith (traps de depassement)\n"
+              << "  --fault-handler       Tester le mode --fault-handler (gestionnaire de SIGFPE)\n"
+              << "  --march <niveau>      Compiler avec -march (x86-64, x86-64-v2, x86-64-v3, x86-64-v4)\n"
+              << "  --replay <fichier>    Comparer un programme existant au lieu d'en generer\n"
+              << "  --print               Afficher les programmes generes\n";
+}
+
+int main(int argc, char *argv[])
+{
+    long long runs = 1000;
+    uint64_t seed = 1;
+    bool keepGoing = false;
+    bool print = false;
+    std::string replay;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--runs" && hasValue)
+            runs = std::atoll(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--nasm" && hasValue)
+            g_options.nasm = argv[++i];
+        else if (arg == "--ld" && hasValue)
+            g_options.ld = argv[++i];
+        else if (arg == "--target" && hasValue)
+        {
+            std::string name = argv[++i];
+            if (name != "x86-64" && name != "aarch64" && name != "bytecode")
+            {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            g_options.target = targetNamed(name);
+        }
+        else if (arg == "--as" && hasValue)
+            g_options.gnuAs = argv[++i];
+        else if (arg == "--runner" && hasValue)
+            g_options.runner = splitCommand(argv[++i]);
+        else if (arg == "--vm" && hasValue)
+            g_options.vm = argv[++i];
+        else if (arg == "--workdir" && hasValue)
+            g_options.workDir = argv[++i];
+        else if (arg == "--out" && hasValue)
+            g_options.outDir = argv[++i];
+        else if (arg == "--timeout" && hasValue)
+            g_options.timeoutMs = std::max(100, std::atoi(argv[++i]));
+        else if (arg == "--replay" && hasValue)
+            replay = argv[++i];
+        else if (arg == "--keep-going")
+            keepGoing = true;
+        else if (arg == "--checked-arith")
+            g_options.checkedArithmetic = true;
+        else if (arg == "--fault-handler")
+            g_options.faultHandler = true;
+        else if (arg == "--march" && hasValue)
+        {
+            if (!parseCpuLevel(argv[++i], g_options.cpuLevel))
+            {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--print")
+            print = true;
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (g_options.faultHandler && g_options.target != Target::X86_64)
+    {
+        std::cerr << "Erreur: --fault-handler n'existe que pour x86-64" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!replay.empty())
+    {
+        std::ifstream file(replay);
+        std::stringstream content;
+        content << file.rdbuf();
+        auto program = parseSource(content.str());
+        if (!program)
+        {
+            std::cerr << "Erreur: impossible d'analyser " << replay << std::endl;
+            return EXIT_FAILURE;
+        }
+        CaseResult result = checkProgram(program.value());
+        if (!result.compared)
+        {
+            std::cout << "Programme hors modele de l'interpreteur, non compare\n";
+            return EXIT_SUCCESS;
+        }
+        std::cout << (result.mismatch.empty() ? "Identique" : "Ecart: " + result.mismatch) << "\n";
+        return result.mismatch.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    long long compared = 0;
+    long long skipped = 0;
+    long long mismatches = 0;
+    for (long long run = 0; runs == 0 || run < runs; run++)
+    {
+        ByteSource source(seed + run);
+        std::string text = ProgramGenerator(source).generate();
+        if (print)
+            std::cout << "// graine " << seed + run << "\n" << text << "\n";
+
+        auto program = parseSource(text);
+        if (!program)
+        {
+            std::cerr << "Erreur: programme genere invalide (graine " << seed + run << ") :\n" << text;
+            return EXIT_FAILURE;
+        }
+
+        CaseResult result = checkProgram(program.value());
+        if (!result.compared)
+        {
+            skipped++;
+            continue;
+        }
+        compared++;
+        if (!result.mismatch.empty())
+        {
+            mismatches++;
+            reportMismatch(text, std::to_string(seed + run));
+            if (!keepGoing)
+                break;
+        }
+    }
+
+    std::cout << compared << " programmes compares, " << skipped << " hors modele, "
+              << mismatches << " ecart(s)" << std::endl;
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,412 @@
+/**
+ * @file parser_fuzz.cpp
+ * @brief Fuzzing du Tokenizer et du Parser, et tests de complexité linéaire.
+ *
+ * Trois modes :
+ *  - libFuzzer (compilé avec -DYB_LIBFUZZER et -fsanitize=fuzzer) : chaque entrée est
+ *    analysée telle quelle ; le délai et la mémoire sont bornés par -timeout et -rss_limit_mb ;
+ *  - boucle autonome (par défaut) : les programmes de `--corpus` sont mutés (octets changés,
+ *    tokens insérés, tranches supprimées, dupliquées ou répétées) puis analysés, avec un délai
+ *    par entrée et une limite d'espace d'adressage. Une entrée qui dépasse le délai ou fait
+ *    planter le processus est écrite dans `--crash-dir` ;
+ *  - `--scaling` : des entrées adverses (imbrications profondes, longues instructions
+ *    commençant par un identifiant, erreurs en fin d'instruction...) sont générées à
+ *    plusieurs tailles et le temps d'analyse doit rester linéaire.
+ */
+
+#include "Parser.hpp"
+#include "Tokenizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Flux qui ignore tout : les erreurs du parser sont attendues sur des entrées aléatoires
+ */
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+};
+
+/**
+ * @brief Analyse une entrée complète
+ * @return Vrai si le programme est valide
+ */
+static bool parseInput(const std::string &input)
+{
+    Tokenizer tokenizer(input);
+    Parser parser(tokenizer);
+    return parser.parse().has_value();
+}
+
+#ifdef YB_LIBFUZZER
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***)
+{
+    static NullBuffer nullBuffer;
+    std::cerr.rdbuf(&nullBuffer);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    parseInput(std::string(reinterpret_cast<const char *>(data), size));
+    return 0;
+}
+
+#else
+
+// Entrée en cours, écrite sur disque par le gestionnaire de signal en cas de délai ou de plantage
+static std::string g_current;
+static char g_crashPath[4096];
+
+static void onFatalSignal(int signal)
+{
+    int fd = open(g_crashPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+        ssize_t written = write(fd, g_current.data(), g_current.size());
+        (void)written;
+        close(fd);
+    }
+    const char *message = signal == SIGALRM ? "parser_fuzz: delai depasse, entree ecrite dans "
+                                            : "parser_fuzz: plantage, entree ecrite dans ";
+    ssize_t written = write(STDERR_FILENO, message, strlen(message));
+    written = write(STDERR_FILENO, g_crashPath, strlen(g_crashPath));
+    written = write(STDERR_FILENO, "\n", 1);
+    (void)written;
+    _exit(1);
+}
+
+/**
+ * @brief Installe les gestionnaires de délai et de plantage (sur une pile dédiée pour
+ * pouvoir signaler un débordement de pile)
+ */
+static void installHandlers(const std::string &crashDir)
+{
+    fs::create_directories(crashDir);
+    std::string path = (fs::path(crashDir) / ("parser_crash_" + std::to_string(getpid()) + ".yb")).string();
+    std::snprintf(g_crashPath, sizeof(g_crashPath), "%s", path.c_str());
+
+    static std::vector<char> alternateStack(1 << 16);
+    stack_t stack = {};
+    stack.ss_sp = alternateStack.data();
+    stack.ss_size = alternateStack.size();
+    sigaltstack(&stack, nullptr);
+
+    struct sigaction action = {};
+    action.sa_handler = onFatalSignal;
+    action.sa_flags = SA_ONSTACK;
+    for (int signal : {SIGALRM, SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL})
+        sigaction(signal, &action, nullptr);
+}
+
+static void armTimer(int milliseconds)
+{
+    struct itimerval timer = {};
+    timer.it_value.tv_sec = milliseconds / 1000;
+    timer.it_value.tv_usec = (milliseconds % 1000) * 1000;
+    setitimer(ITIMER_REAL, &timer, nullptr);
+}
+
+/**
+ * @brief Applique une à quatre mutations aléatoires à une entrée
+ */
+static std::string mutate(const std::string &input, const std::vector<std::string> &corpus, std::mt19937_64 &rng)
+{
+    static const char *dictionary[] = {"let ", "exit", "if", "else", "while", "print", "len", "matrix", "match", "=>", "_",
+                                       "(", ")", "[", "]", "{", "}", ";", ",", "=", "==", "!=",
+                                       "<", "<=", ">", ">=", "+", "-", "*", "/", "%", "&&", "||",
+                                       "x", "a[0]", "m[1][2]", "42", "//", "/*", "*/", "\n"};
+    std::string result = input;
+    auto position = [&]()
+    { return result.empty() ? 0 : static_cast<size_t>(rng() % (result.size() + 1)); };
+
+    int count = 1 + static_cast<int>(rng() % 4);
+    for (int i = 0; i < count; i++)
+    {
+        switch (rng() % 6)
+        {
+        case 0: // Octet quelconque
+            if (!result.empty())
+                result[rng() % result.size()] = static_cast<char>(rng() % 256);
+            break;
+        case 1: // Token du langage
+            result.insert(position(), dictionary[rng() % (sizeof(dictionary) / sizeof(dictionary[0]))]);
+            break;
+        case 2: // Suppression d'une tranche
+            if (!result.empty())
+            {
+                size_t start = rng() % result.size();
+                result.erase(start, rng() % 64);
+            }
+            break;
+        case 3: // Tranche répétée : imbrications et longues instructions
+            if (!result.empty() && result.size() < (1u << 20))
+            {
+                size_t start = rng() % result.size();
+                std::string slice = result.substr(start, 1 + rng() % 16);
+                size_t times = 1 + rng() % 256;
+                std::string repeated;
+                for (size_t k = 0; k < times; k++)
+                    repeated += slice;
+                result.insert(position(), repeated);
+            }
+            break;
+        case 4: // Greffe d'un autre programme du corpus
+            if (!corpus.empty())
+            {
+                const std::string &other = corpus[rng() % corpus.size()];
+                if (!other.empty())
+                {
+                    size_t start = rng() % other.size();
+                    result.insert(position(), other.substr(start, rng() % 256));
+                }
+            }
+            break;
+        default: // Troncature
+            if (!result.empty())
+                result.resize(rng() % result.size());
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Forme d'entrée adverse, générée pour un paramètre de taille n
+ */
+struct Shape
+{
+    std::string name;
+    std::function<std::string(size_t)> build;
+};
+
+static std::string repeat(const std::string &text, size_t times)
+{
+    std::string result;
+    result.reserve(text.size() * times);
+    for (size_t i = 0; i < times; i++)
+        result += text;
+    return result;
+}
+
+static std::vector<Shape> adversarialShapes()
+{
+    return {
+        {"parentheses imbriquees (x200)",
+         [](size_t n)
+         { return repeat("let x = " + repeat("(", 200) + "1" + repeat(")", 200) + ";\n", n / 400); }},
+        {"crochets au-dela de la limite",
+         [](size_t n)
+         { return "let x = " + repeat("[", n); }},
+        {"blocs imbriques (x200)",
+         [](size_t n)
+         { return repeat(repeat("{ ", 200) + repeat("} ", 200) + "\n", n / 800); }},
+        {"else if en chaine (x100)",
+         [](size_t n)
+         { return repeat("if (1) { } " + repeat("else if (1) { } ", 100) + "\n", n / 1600); }},
+        {"affectations de matrice",
+         [](size_t n)
+         { return "let m = matrix(2, 2);\nlet i = 0;\n" + repeat("m[i + 1][i] = m[i][i + 1] + 1;\n", n / 32); }},
+        {"indice d'affectation long",
+         [](size_t n)
+         { return "let a = [0];\na[" + repeat("1 + ", n / 4) + "1] = 1;\n"; }},
+        {"indice long puis erreur",
+         [](size_t n)
+         { return "let a = [0];\na[" + repeat("a[0] + ", n / 7) + "1] 1;\n"; }},
+        {"identifiants sans affectation",
+         [](size_t n)
+         { return repeat("a[0][1] == 2;\n", n / 14); }},
+        {"expressions longues (x100)",
+         [](size_t n)
+         { return "let x = 1;\n" + repeat("x = " + repeat("x * 2 + ", 100) + "1;\n", n / 805); }},
+    };
+}
+
+/**
+ * @brief Meilleur temps d'analyse d'une entrée sur quelques répétitions, en secondes
+ */
+static double timeParse(const std::string &input, int repetitions)
+{
+    double best = 1e9;
+    for (int i = 0; i < repetitions; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        parseInput(input);
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+/**
+ * @brief Vérifie que le temps d'analyse de chaque forme adverse croît linéairement
+ *
+ * Chaque forme est mesurée pour n, 4n et 16n octets. Le temps à 16n ne doit pas dépasser
+ * 16 fois celui à n multiplié par la tolérance (un coût quadratique donnerait un facteur 256).
+ */
+static int runScaling(size_t baseSize, double tolerance, int timeoutMs)
+{
+    std::cout << std::left << std::setw(34) << "forme" << std::right << std::setw(12) << "octets"
+              << std::setw(12) << "ms" << std::setw(10) << "facteur" << "\n";
+
+    bool failed = false;
+    for (const auto &shape : adversarialShapes())
+    {
+        // Un délai par forme : un coût quadratique ne doit pas bloquer la cible
+        armTimer(timeoutMs * 30);
+        double baseTime = 0.0;
+        for (size_t multiplier : {1, 4, 16})
+        {
+            std::string input = shape.build(baseSize * multiplier);
+            g_current = input;
+            double seconds = timeParse(input, multiplier == 16 ? 3 : 5);
+            if (multiplier == 1)
+                baseTime = std::max(seconds, 1e-5);
+            double factor = seconds / baseTime;
+
+            std::cout << std::left << std::setw(34) << (multiplier == 1 ? shape.name : "") << std::right
+                      << std::setw(12) << input.size() << std::setw(12) << std::fixed << std::setprecision(2)
+                      << seconds * 1000.0 << std::setw(10) << std::setprecision(1) << factor;
+            if (multiplier == 16 && factor > 16.0 * tolerance)
+            {
+                std::cout << "  NON LINEAIRE";
+                failed = true;
+            }
+            std::cout << "\n";
+        }
+        armTimer(0);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --corpus <dossier>      Programmes de depart (defaut: exemples)\n"
+              << "  --runs <n>              Entrees mutees (defaut: 100000, 0 = sans fin)\n"
+              << "  --seed <n>              Graine (defaut: 1)\n"
+              << "  --timeout <ms>          Delai par entree (defaut: 2000)\n"
+              << "  --rss-limit-mb <n>      Limite d'espace d'adressage (defaut: 2048)\n"
+              << "  --crash-dir <dossier>   Ou ecrire les entrees fautives (defaut: .)\n"
+              << "  --scaling               Verifier la linearite sur des entrees adverses\n"
+              << "  --scaling-size <oct>    Taille de base des entrees adverses (defaut: 65536)\n"
+              << "  --tolerance <x>         Marge sur le facteur lineaire (defaut: 2.5)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    std::string corpusDir = "exemples";
+    std::string crashDir = ".";
+    long long runs = 100000;
+    uint64_t seed = 1;
+    int timeoutMs = 2000;
+    long rssLimitMb = 2048;
+    bool scaling = false;
+    size_t scalingSize = 65536;
+    double tolerance = 2.5;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--corpus" && hasValue)
+            corpusDir = argv[++i];
+        else if (arg == "--runs" && hasValue)
+            runs = std::atoll(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--timeout" && hasValue)
+            timeoutMs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--rss-limit-mb" && hasValue)
+            rssLimitMb = std::atol(argv[++i]);
+        else if (arg == "--crash-dir" && hasValue)
+            crashDir = argv[++i];
+        else if (arg == "--scaling")
+            scaling = true;
+        else if (arg == "--scaling-size" && hasValue)
+            scalingSize = std::max(1024L, std::atol(argv[++i]));
+        else if (arg == "--tolerance" && hasValue)
+            tolerance = std::atof(argv[++i]);
+        else
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    NullBuffer nullBuffer;
+    std::streambuf *errors = std::cerr.rdbuf(&nullBuffer);
+    auto restoreErrors = [&]()
+    { std::cerr.rdbuf(errors); };
+
+    if (rssLimitMb > 0)
+    {
+        struct rlimit limit = {static_cast<rlim_t>(rssLimitMb) << 20, static_cast<rlim_t>(rssLimitMb) << 20};
+        setrlimit(RLIMIT_AS, &limit);
+    }
+    installHandlers(crashDir);
+
+    if (scaling)
+    {
+        int status = runScaling(scalingSize, tolerance, timeoutMs);
+        restoreErrors();
+        if (status != EXIT_SUCCESS)
+            std::cerr << "Erreur: le temps d'analyse n'est pas lineaire pour au moins une forme" << std::endl;
+        return status;
+    }
+
+    std::vector<std::string> corpus;
+    if (fs::is_directory(corpusDir))
+    {
+        for (const auto &entry : fs::directory_iterator(corpusDir))
+        {
+            if (entry.path().extension() != ".yb")
+                continue;
+            std::ifstream file(entry.path());
+            std::stringstream content;
+            content << file.rdbuf();
+            corpus.push_back(content.str());
+        }
+    }
+    if (corpus.empty())
+        corpus.push_back("let x = 1;\nprint(x);\n");
+
+    std::mt19937_64 rng(seed);
+    long long valid = 0;
+    for (long long run = 0; runs == 0 || run < runs; run++)
+    {
+        g_current = mutate(corpus[rng() % corpus.size()], corpus, rng);
+        armTimer(timeoutMs);
+        valid += parseInput(g_current);
+        armTimer(0);
+    }
+
+    restoreErrors();
+    std::cout << runs << " entrees analysees, " << valid << " programmes valides, aucun plantage" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#endif
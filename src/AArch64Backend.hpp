@@ -0,0 +1,859 @@
+#pragma once
+
+#include "Backend.hpp"
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+/**
+ * @file AArch64Backend.hpp
+ * @brief Backend Linux AArch64 (assembleur GNU), option --target=aarch64.
+ *
+ * Registres :
+ * - la pile de la représentation intermédiaire est gardée dans x9-x15 puis x19-x26
+ *   (niveau 0 dans x9) ; au-delà, les niveaux sont rangés dans la zone yb_spill, pointée
+ *   par x27 ;
+ * - x28 pointe sur yb_vars, la variable d'emplacement k est à [x28, #8k] ;
+ * - x0-x8, x16 et x17 servent de temporaires au code généré et aux routines du runtime.
+ *
+ * Convention d'appel des routines `yb_rt` : arguments dans x0 et x1 (x1 et x2 pour le
+ * message de yb_rt_panic), résultat dans x0 ; une routine ne modifie que x0-x8, x16, x17
+ * et x30, le code généré n'a donc rien à sauvegarder.
+ *
+ * Les tableaux ont la disposition du runtime x86-64 (longueur à [adresse - 8], colonnes
+ * et lignes d'une matrice à [adresse - 16] et [adresse - 24]) et les erreurs d'exécution
+ * ont les mêmes messages et codes de retour. sdiv ne fait pas de faute : la division par
+ * zéro et INT64_MIN / -1 sont testées et envoient SIGFPE au processus, comme idiv.
+ *
+ * Appels système Linux AArch64 : numéro dans x8, arguments dans x0-x5, `svc #0`.
+ */
+class AArch64Backend : public Backend
+{
+public:
+    void begin(std::stringstream &assembly) override
+    {
+        assembly << "    .text\n";
+        assembly << "    .global _start\n";
+        assembly << "_start:\n";
+        emitAddress(assembly, "x28", "yb_vars");
+        emitAddress(assembly, "x27", "yb_spill");
+    }
+
+    void emit(const IrStatement &statement, std::stringstream &assembly) override
+    {
+        m_traps = 0;
+        int depth = 0;
+        for (const IrInstr &instr : statement.code)
+            depth = emitInstr(instr, depth, assembly);
+
+        if (m_traps)
+        {
+            // Les branchements conditionnels portent à ±1 Mio : les sauts vers le runtime
+            // passent par des relais placés après l'instruction
+            std::string next = ".Lyb_next_" + std::to_string(m_statement);
+            assembly << "    b " << next << "\n";
+            if (m_traps & bit(Trap::BOUNDS))
+                assembly << trapLabel(Trap::BOUNDS) << ":\n    b yb_rt_bounds_trap\n";
+            if (m_traps & bit(Trap::OVERFLOW))
+                assembly << trapLabel(Trap::OVERFLOW) << ":\n    b yb_rt_overflow_trap\n";
+            if (m_traps & bit(Trap::DIVISION))
+                assembly << trapLabel(Trap::DIVISION) << ":\n    b yb_rt_div_trap\n";
+            assembly << next << ":\n";
+        }
+        m_statement++;
+    }
+
+    void finish(int slotCount, std::stringstream &assembly) override
+    {
+        assembly << "    mov x0, #0\n";
+        assembly << "    b yb_rt_exit\n";
+        require(Routine::EXIT);
+        emitRuntime(assembly);
+
+        assembly << "\n    .bss\n";
+        assembly << "    .balign 16\n";
+        assembly << "yb_vars:\n";
+        assembly << "    .space " << 8 * (slotCount + 1) << "\n";
+        assembly << "yb_spill:\n";
+        assembly << "    .space " << 8 * (m_maxSpill + 1) << "\n";
+        if (uses(Routine::FLUSH))
+        {
+            assembly << "yb_rt_outpos:\n";
+            assembly << "    .space 8\n";
+            assembly << "yb_rt_outbuf:\n";
+            assembly << "    .space " << OUTPUT_BUFFER_SIZE << "\n";
+        }
+        assembly << "    .section .note.GNU-stack,\"\",%progbits\n";
+    }
+
+private:
+    static constexpr int OUTPUT_BUFFER_SIZE = 65536;
+    static constexpr int ARRAY_HEADER_SIZE = 64;
+
+    // Messages d'erreur des traps (texte, sans le saut de ligne final)
+    static constexpr const char *MSG_BOUNDS = "Erreur: indice de tableau hors limites";
+    static constexpr const char *MSG_ALLOC = "Erreur: allocation memoire impossible";
+    static constexpr const char *MSG_OVERFLOW = "Erreur: depassement de capacite arithmetique";
+
+    /**
+     * @brief Registres des niveaux de pile, du niveau 0 au niveau STACK_REGISTER_COUNT - 1
+     */
+    static constexpr const char *STACK_REGISTERS[] = {"x9",  "x10", "x11", "x12", "x13", "x14", "x15", "x19",
+                                                      "x20", "x21", "x22", "x23", "x24", "x25", "x26"};
+    static constexpr int STACK_REGISTER_COUNT = sizeof(STACK_REGISTERS) / sizeof(STACK_REGISTERS[0]);
+
+    /**
+     * @brief Routines du runtime AArch64
+     */
+    enum class Routine
+    {
+        EXIT,          // yb_rt_exit : x0 = code
+        FMT_INT,       // yb_rt_fmt_int : écrit x0 en décimal à [x1], x1 avance
+        PRINT_INT,     // yb_rt_print_int : x0 suivi d'un saut de ligne
+        PRINT_LIST,    // yb_rt_print_list : x1 valeurs ou tableaux décrits à [x0] (deux mots chacun)
+        FLUSH,         // yb_rt_flush : écrit le tampon de sortie sur stdout
+        ALLOC_ARRAY,   // yb_rt_alloc_array : x0 = éléments -> x0 = adresse de l'élément 0
+        ALLOC_MATRIX,  // yb_rt_alloc_matrix : x0 = lignes, x1 = colonnes -> x0
+        PANIC,         // yb_rt_panic : message (x1, x2) sur stderr puis code 1
+        BOUNDS_TRAP,   // yb_rt_bounds_trap
+        OVERFLOW_TRAP, // yb_rt_overflow_trap (--checked-arith)
+        DIV_TRAP,      // yb_rt_div_trap : SIGFPE
+    };
+
+    /**
+     * @brief Erreurs d'exécution testées par le code d'une instruction
+     */
+    enum class Trap
+    {
+        BOUNDS,
+        OVERFLOW,
+        DIVISION,
+    };
+
+    unsigned m_used = 0;   ///< Masque des routines demandées
+    unsigned m_traps = 0;  ///< Masque des Trap utilisés par l'instruction en cours
+    int m_statement = 0;   ///< Numéro de l'instruction de premier niveau en cours
+    int m_maxSpill = 0;    ///< Niveaux de pile rangés dans yb_spill
+
+    static unsigned bit(Routine routine)
+    {
+        return 1u << static_cast<unsigned>(routine);
+    }
+
+    static unsigned bit(Trap trap)
+    {
+        return 1u << static_cast<unsigned>(trap);
+    }
+
+    void require(Routine routine)
+    {
+        m_used |= bit(routine);
+        switch (routine)
+        {
+        case Routine::PRINT_INT:
+        case Routine::PRINT_LIST:
+            require(Routine::FMT_INT);
+            require(Routine::FLUSH);
+            break;
+        case Routine::ALLOC_MATRIX:
+            require(Routine::ALLOC_ARRAY);
+            break;
+        case Routine::ALLOC_ARRAY:
+        case Routine::BOUNDS_TRAP:
+        case Routine::OVERFLOW_TRAP:
+            require(Routine::PANIC);
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool uses(Routine routine) const
+    {
+        return (m_used & bit(routine)) != 0;
+    }
+
+    /**
+     * @brief Label du relais vers la routine d'une erreur, pour l'instruction en cours
+     */
+    std::string trapLabel(Trap trap)
+    {
+        static const char *names[] = {"bounds", "overflow", "div"};
+        m_traps |= bit(trap);
+        require(trap == Trap::BOUNDS ? Routine::BOUNDS_TRAP
+                                     : trap == Trap::OVERFLOW ? Routine::OVERFLOW_TRAP : Routine::DIV_TRAP);
+        return ".Lyb_" + std::string(names[static_cast<int>(trap)]) + "_" + std::to_string(m_statement);
+    }
+
+    static std::string label(long long index)
+    {
+        return ".Lyb_" + std::to_string(index);
+    }
+
+    static void emitAddress(std::stringstream &assembly, const std::string &reg, const std::string &symbol)
+    {
+        assembly << "    adrp " << reg << ", " << symbol << "\n";
+        assembly << "    add " << reg << ", " << reg << ", :lo12:" << symbol << "\n";
+    }
+
+    /**
+     * @brief Charge une constante de 64 bits avec le moins d'instructions movz/movn + movk
+     */
+    static void emitConstant(std::stringstream &assembly, const std::string &reg, long long value)
+    {
+        uint64_t bits = static_cast<uint64_t>(value);
+        int zeroChunks = 0;
+        int onesChunks = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            uint64_t chunk = (bits >> (16 * i)) & 0xFFFF;
+            zeroChunks += chunk == 0;
+            onesChunks += chunk == 0xFFFF;
+        }
+
+        // Avec movn, les morceaux à 0xFFFF sont gratuits ; avec movz, les morceaux nuls
+        bool inverted = onesChunks > zeroChunks;
+        uint64_t skip = inverted ? 0xFFFF : 0;
+        if (std::max(zeroChunks, onesChunks) == 4)
+        {
+            assembly << "    " << (inverted ? "movn " : "movz ") << reg << ", #0\n";
+            return;
+        }
+        bool first = true;
+        for (int i = 0; i < 4; i++)
+        {
+            uint64_t chunk = (bits >> (16 * i)) & 0xFFFF;
+            if (chunk == skip)
+                continue;
+            if (first)
+                assembly << "    " << (inverted ? "movn " : "movz ") << reg << ", #"
+                         << (inverted ? ~chunk & 0xFFFF : chunk);
+            else
+                assembly << "    movk " << reg << ", #" << chunk;
+            if (i)
+                assembly << ", lsl #" << 16 * i;
+            assembly << "\n";
+            first = false;
+        }
+    }
+
+    /**
+     * @brief Accès mémoire `op reg, [base, #offset]`, par x8 si le décalage est trop grand
+     */
+    static void emitMemory(std::stringstream &assembly, const std::string &op, const std::string &reg,
+                           const std::string &base, long long offset)
+    {
+        if (offset >= 0 && offset <= 32760)
+        {
+            assembly << "    " << op << " " << reg << ", [" << base << ", #" << offset << "]\n";
+            return;
+        }
+        emitConstant(assembly, "x8", offset);
+        assembly << "    " << op << " " << reg << ", [" << base << ", x8]\n";
+    }
+
+    /**
+     * @brief Registre qui contient le niveau de pile `depth` (chargé dans `scratch` s'il est en mémoire)
+     */
+    std::string operand(std::stringstream &assembly, int depth, const std::string &scratch)
+    {
+        if (depth < STACK_REGISTER_COUNT)
+            return STACK_REGISTERS[depth];
+        emitMemory(assembly, "ldr", scratch, "x27", 8LL * (depth - STACK_REGISTER_COUNT));
+        return scratch;
+    }
+
+    /**
+     * @brief Registre où calculer le niveau `depth` (`scratch` s'il est en mémoire, voir store)
+     */
+    std::string result(int depth, const std::string &scratch)
+    {
+        if (depth < STACK_REGISTER_COUNT)
+            return STACK_REGISTERS[depth];
+        m_maxSpill = std::max(m_maxSpill, depth - STACK_REGISTER_COUNT + 1);
+        return scratch;
+    }
+
+    /**
+     * @brief Range le niveau `depth` calculé dans le registre rendu par result
+     */
+    void store(std::stringstream &assembly, int depth, const std::string &reg)
+    {
+        if (depth >= STACK_REGISTER_COUNT)
+            emitMemory(assembly, "str", reg, "x27", 8LL * (depth - STACK_REGISTER_COUNT));
+    }
+
+    static void emitMove(std::stringstream &assembly, const std::string &to, const std::string &from)
+    {
+        if (to != from)
+            assembly << "    mov " << to << ", " << from << "\n";
+    }
+
+    /**
+     * @brief Émet une instruction de la représentation intermédiaire
+     * @return La profondeur de pile après l'instruction
+     */
+    int emitInstr(const IrInstr &instr, int depth, std::stringstream &assembly)
+    {
+        switch (instr.op)
+        {
+        case IrOp::CONST:
+        {
+            std::string reg = result(depth, "x0");
+            emitConstant(assembly, reg, instr.value);
+            store(assembly, depth, reg);
+            return depth + 1;
+        }
+        case IrOp::LOAD:
+        {
+            std::string reg = result(depth, "x0");
+            emitMemory(assembly, "ldr", reg, "x28", 8 * instr.value);
+            store(assembly, depth, reg);
+            return depth + 1;
+        }
+        case IrOp::STORE:
+            emitMemory(assembly, "str", operand(assembly, depth - 1, "x1"), "x28", 8 * instr.value);
+            return depth - 1;
+        case IrOp::BINARY:
+            emitBinary(instr, depth, assembly);
+            return depth - 1;
+        case IrOp::LABEL:
+            assembly << label(instr.value) << ":\n";
+            return depth;
+        case IrOp::JUMP:
+            assembly << "    b " << label(instr.value) << "\n";
+            return depth;
+        case IrOp::JUMP_IF_ZERO:
+            assembly << "    cbz " << operand(assembly, depth - 1, "x1") << ", " << label(instr.value) << "\n";
+            return depth - 1;
+        case IrOp::NEW_ARRAY:
+        {
+            require(Routine::ALLOC_ARRAY);
+            emitConstant(assembly, "x0", instr.value);
+            assembly << "    bl yb_rt_alloc_array\n";
+            std::string reg = result(depth, "x0");
+            emitMove(assembly, reg, "x0");
+            store(assembly, depth, reg);
+            return depth + 1;
+        }
+        case IrOp::INIT_ELEMENT:
+        {
+            std::string value = operand(assembly, depth - 1, "x1");
+            std::string array = operand(assembly, depth - 2, "x2");
+            emitMemory(assembly, "str", value, array, 8 * instr.value);
+            return depth - 1;
+        }
+        case IrOp::NEW_MATRIX:
+        {
+            require(Routine::ALLOC_MATRIX);
+            // x1 est chargé en premier : operand peut utiliser x0 comme temporaire
+            std::string cols = operand(assembly, depth - 2, "x1");
+            emitMove(assembly, "x1", cols);
+            std::string rows = operand(assembly, depth - 1, "x0");
+            emitMove(assembly, "x0", rows);
+            assembly << "    bl yb_rt_alloc_matrix\n";
+            std::string reg = result(depth - 2, "x0");
+            emitMove(assembly, reg, "x0");
+            store(assembly, depth - 2, reg);
+            return depth - 1;
+        }
+        case IrOp::LOAD_ELEMENT:
+        {
+            std::string index = operand(assembly, depth - 1, "x1");
+            std::string array = operand(assembly, depth - 2, "x2");
+            emitBoundsCheck(assembly, index, array, -8);
+            std::string reg = result(depth - 2, "x0");
+            assembly << "    ldr " << reg << ", [" << array << ", " << index << ", lsl #3]\n";
+            store(assembly, depth - 2, reg);
+            return depth - 1;
+        }
+        case IrOp::STORE_ELEMENT:
+        {
+            std::string index = operand(assembly, depth - 1, "x1");
+            std::string array = operand(assembly, depth - 2, "x2");
+            std::string value = operand(assembly, depth - 3, "x3");
+            emitBoundsCheck(assembly, index, array, -8);
+            assembly << "    str " << value << ", [" << array << ", " << index << ", lsl #3]\n";
+            return depth - 3;
+        }
+        case IrOp::LOAD_MATRIX_ELEMENT:
+        {
+            std::string col = operand(assembly, depth - 1, "x1");
+            std::string row = operand(assembly, depth - 2, "x2");
+            std::string matrix = operand(assembly, depth - 3, "x3");
+            emitMatrixOffset(assembly, row, col, matrix);
+            std::string reg = result(depth - 3, "x0");
+            assembly << "    ldr " << reg << ", [" << matrix << ", x16, lsl #3]\n";
+            store(assembly, depth - 3, reg);
+            return depth - 2;
+        }
+        case IrOp::STORE_MATRIX_ELEMENT:
+        {
+            std::string col = operand(assembly, depth - 1, "x1");
+            std::string row = operand(assembly, depth - 2, "x2");
+            std::string matrix = operand(assembly, depth - 3, "x3");
+            std::string value = operand(assembly, depth - 4, "x4");
+            emitMatrixOffset(assembly, row, col, matrix);
+            assembly << "    str " << value << ", [" << matrix << ", x16, lsl #3]\n";
+            return depth - 4;
+        }
+        case IrOp::LENGTH:
+        {
+            std::string array = operand(assembly, depth - 1, "x1");
+            std::string reg = result(depth - 1, "x0");
+            assembly << "    ldur " << reg << ", [" << array << ", #-8]\n";
+            store(assembly, depth - 1, reg);
+            return depth;
+        }
+        case IrOp::PRINT:
+            emitPrint(instr, depth, assembly);
+            return depth - static_cast<int>(instr.arrays.size());
+        case IrOp::EXIT:
+            require(Routine::EXIT);
+            emitMove(assembly, "x0", operand(assembly, depth - 1, "x0"));
+            assembly << "    b yb_rt_exit\n";
+            return depth - 1;
+        }
+        return depth;
+    }
+
+    void emitBinary(const IrInstr &instr, int depth, std::stringstream &assembly)
+    {
+        // Le sommet est l'opérande gauche, l'opérande droit est en dessous (voir Lowering)
+        std::string left = operand(assembly, depth - 1, "x1");
+        std::string right = operand(assembly, depth - 2, "x2");
+        std::string reg = result(depth - 2, "x0");
+        const char *condition = nullptr;
+
+        switch (instr.binaryOp)
+        {
+        case BinaryOpType::ADD:
+        case BinaryOpType::SUB:
+        {
+            const char *op = instr.binaryOp == BinaryOpType::ADD ? "add" : "sub";
+            assembly << "    " << op << (instr.checked ? "s " : " ") << reg << ", " << left << ", " << right << "\n";
+            if (instr.checked)
+                assembly << "    b.vs " << trapLabel(Trap::OVERFLOW) << "\n";
+            break;
+        }
+        case BinaryOpType::MUL:
+            if (!instr.checked)
+            {
+                assembly << "    mul " << reg << ", " << left << ", " << right << "\n";
+                break;
+            }
+            // Le produit tient sur 64 bits si la moitié haute est l'extension du signe de la moitié basse
+            assembly << "    mul x16, " << left << ", " << right << "\n";
+            assembly << "    smulh x17, " << left << ", " << right << "\n";
+            assembly << "    cmp x17, x16, asr #63\n";
+            assembly << "    b.ne " << trapLabel(Trap::OVERFLOW) << "\n";
+            emitMove(assembly, reg, "x16");
+            break;
+        case BinaryOpType::DIV:
+        case BinaryOpType::MOD:
+        {
+            std::string trap = trapLabel(Trap::DIVISION);
+            assembly << "    cbz " << right << ", " << trap << "\n";
+            assembly << "    movz x16, #0x8000, lsl #48\n"; // INT64_MIN
+            assembly << "    cmn " << right << ", #1\n";
+            assembly << "    ccmp " << left << ", x16, #0, eq\n"; // Z seulement pour INT64_MIN / -1
+            assembly << "    b.eq " << trap << "\n";
+            if (instr.binaryOp == BinaryOpType::DIV)
+            {
+                assembly << "    sdiv " << reg << ", " << left << ", " << right << "\n";
+                break;
+            }
+            assembly << "    sdiv x16, " << left << ", " << right << "\n";
+            assembly << "    msub " << reg << ", x16, " << right << ", " << left << "\n";
+            break;
+        }
+        case BinaryOpType::AND:
+            assembly << "    and " << reg << ", " << left << ", " << right << "\n";
+            break;
+        case BinaryOpType::OR:
+            assembly << "    orr " << reg << ", " << left << ", " << right << "\n";
+            break;
+        case BinaryOpType::EQUAL:
+            condition = "eq";
+            break;
+        case BinaryOpType::NOT_EQUAL:
+            condition = "ne";
+            break;
+        case BinaryOpType::GREAT:
+            condition = "gt";
+            break;
+        case BinaryOpType::LESS:
+            condition = "lt";
+            break;
+        case BinaryOpType::GREAT_EQUAL:
+            condition = "ge";
+            break;
+        case BinaryOpType::LESS_EQUAL:
+            condition = "le";
+            break;
+        }
+
+        if (condition)
+        {
+            assembly << "    cmp " << left << ", " << right << "\n";
+            assembly << "    cset " << reg << ", " << condition << "\n";
+        }
+        store(assembly, depth - 2, reg);
+    }
+
+    /**
+     * @brief Contrôle non signé d'un indice contre le mot à [base + lengthOffset]
+     */
+    void emitBoundsCheck(std::stringstream &assembly, const std::string &index, const std::string &base,
+                         int lengthOffset)
+    {
+        assembly << "    ldur x16, [" << base << ", #" << lengthOffset << "]\n";
+        assembly << "    cmp " << index << ", x16\n";
+        assembly << "    b.hs " << trapLabel(Trap::BOUNDS) << "\n";
+    }
+
+    /**
+     * @brief x16 = ligne * colonnes + colonne, après contrôle de la ligne puis de la colonne
+     */
+    void emitMatrixOffset(std::stringstream &assembly, const std::string &row, const std::string &col,
+                          const std::string &matrix)
+    {
+        emitBoundsCheck(assembly, row, matrix, -24);
+        assembly << "    ldur x17, [" << matrix << ", #-16]\n";
+        assembly << "    cmp " << col << ", x17\n";
+        assembly << "    b.hs " << trapLabel(Trap::BOUNDS) << "\n";
+        assembly << "    madd x16, " << row << ", x17, " << col << "\n";
+    }
+
+    void emitPrint(const IrInstr &instr, int depth, std::stringstream &assembly)
+    {
+        int count = static_cast<int>(instr.arrays.size());
+        if (count == 1 && !instr.arrays[0])
+        {
+            require(Routine::PRINT_INT);
+            emitMove(assembly, "x0", operand(assembly, depth - 1, "x0"));
+            assembly << "    bl yb_rt_print_int\n";
+            return;
+        }
+
+        // Deux mots par valeur sur la pile, comme pour le runtime x86-64 : la valeur puis -1
+        // pour un entier, l'adresse de l'élément 0 puis la longueur pour un tableau
+        require(Routine::PRINT_LIST);
+        long long frame = 16LL * count;
+        if (frame)
+        {
+            emitConstant(assembly, "x17", frame);
+            assembly << "    sub sp, sp, x17\n";
+        }
+        for (int i = 0; i < count; i++)
+        {
+            std::string value = operand(assembly, depth - count + i, "x1");
+            if (instr.arrays[i])
+                assembly << "    ldur x16, [" << value << ", #-8]\n";
+            else
+                assembly << "    mov x16, #-1\n";
+            emitMemory(assembly, "str", value, "sp", 16LL * i);
+            emitMemory(assembly, "str", "x16", "sp", 16LL * i + 8);
+        }
+        assembly << "    mov x0, sp\n";
+        emitConstant(assembly, "x1", count);
+        assembly << "    bl yb_rt_print_list\n";
+        if (frame)
+        {
+            emitConstant(assembly, "x17", frame);
+            assembly << "    add sp, sp, x17\n";
+        }
+    }
+
+    void emitRuntime(std::stringstream &assembly) const
+    {
+        assembly << "\n// ---------------- runtime yb_rt ----------------\n";
+        assembly << "    .balign 16\n";
+        if (uses(Routine::EXIT))
+            emitExit(assembly);
+        if (uses(Routine::PRINT_INT))
+            emitPrintInt(assembly);
+        if (uses(Routine::PRINT_LIST))
+            emitPrintList(assembly);
+        if (uses(Routine::FMT_INT))
+            emitFmtInt(assembly);
+        if (uses(Routine::FLUSH))
+            emitFlush(assembly);
+        if (uses(Routine::ALLOC_MATRIX))
+            emitAllocMatrix(assembly);
+        if (uses(Routine::ALLOC_ARRAY))
+            emitAllocArray(assembly);
+        if (uses(Routine::BOUNDS_TRAP))
+            emitTrap(assembly, "yb_rt_bounds_trap", "yb_rt_msg_bounds", MSG_BOUNDS);
+        if (uses(Routine::OVERFLOW_TRAP))
+            emitTrap(assembly, "yb_rt_overflow_trap", "yb_rt_msg_overflow", MSG_OVERFLOW);
+        if (uses(Routine::DIV_TRAP))
+            emitDivTrap(assembly);
+        if (uses(Routine::PANIC))
+            emitPanic(assembly);
+
+        assembly << "\n    .section .rodata\n";
+        if (uses(Routine::BOUNDS_TRAP))
+            assembly << "yb_rt_msg_bounds:\n    .ascii \"" << MSG_BOUNDS << "\\n\"\n";
+        if (uses(Routine::OVERFLOW_TRAP))
+            assembly << "yb_rt_msg_overflow:\n    .ascii \"" << MSG_OVERFLOW << "\\n\"\n";
+        if (uses(Routine::ALLOC_ARRAY))
+            assembly << "yb_rt_msg_alloc:\n    .ascii \"" << MSG_ALLOC << "\\n\"\n";
+    }
+
+    void emitExit(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_exit:\n";
+        if (uses(Routine::FLUSH))
+        {
+            assembly << "    mov x19, x0\n"; // Préservé par yb_rt_flush
+            assembly << "    bl yb_rt_flush\n";
+            assembly << "    mov x0, x19\n";
+        }
+        assembly << "    mov x8, #93\n"; // syscall exit
+        assembly << "    svc #0\n";
+    }
+
+    void emitPrintInt(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_print_int:\n";
+        assembly << "    stp x0, x30, [sp, #-16]!\n";
+        emitAddress(assembly, "x7", "yb_rt_outpos");
+        assembly << "    ldr x1, [x7]\n";
+        // 21 octets suffisent pour un int64 signé et le saut de ligne
+        assembly << "    mov x2, #" << OUTPUT_BUFFER_SIZE - 32 << "\n";
+        assembly << "    cmp x1, x2\n";
+        assembly << "    b.ls .Lyb_rt_print_int_room\n";
+        assembly << "    bl yb_rt_flush\n";
+        assembly << "    mov x1, #0\n";
+        assembly << ".Lyb_rt_print_int_room:\n";
+        emitAddress(assembly, "x8", "yb_rt_outbuf");
+        assembly << "    add x1, x1, x8\n";
+        assembly << "    ldr x0, [sp]\n";
+        assembly << "    bl yb_rt_fmt_int\n";
+        assembly << "    mov w2, #10\n"; // Saut de ligne
+        assembly << "    strb w2, [x1], #1\n";
+        assembly << "    sub x1, x1, x8\n";
+        assembly << "    str x1, [x7]\n";
+        assembly << "    ldp x0, x30, [sp], #16\n";
+        assembly << "    ret\n";
+    }
+
+    void emitPrintList(std::stringstream &assembly) const
+    {
+        // x16 : élément de la liste, x17 : fin de la liste, x7 et x8 : valeurs restantes de
+        // l'élément, x1 : position d'écriture. [sp + 8] vaut 1 dès qu'une valeur est écrite.
+        assembly << "yb_rt_print_list:\n";
+        assembly << "    sub sp, sp, #32\n";
+        assembly << "    str x30, [sp]\n";
+        assembly << "    str xzr, [sp, #8]\n";
+        assembly << "    mov x16, x0\n";
+        assembly << "    add x17, x0, x1, lsl #4\n";
+        emitAddress(assembly, "x2", "yb_rt_outpos");
+        assembly << "    ldr x1, [x2]\n";
+        emitAddress(assembly, "x2", "yb_rt_outbuf");
+        assembly << "    add x1, x1, x2\n";
+        assembly << ".Lyb_rt_print_list_item:\n";
+        assembly << "    cmp x16, x17\n";
+        assembly << "    b.hs .Lyb_rt_print_list_end\n";
+        assembly << "    ldr x8, [x16, #8]\n";
+        assembly << "    cmn x8, #1\n";
+        assembly << "    b.ne .Lyb_rt_print_list_array\n";
+        assembly << "    mov x7, x16\n"; // Entier : la valeur est dans la liste
+        assembly << "    add x8, x16, #8\n";
+        assembly << "    b .Lyb_rt_print_list_value\n";
+        assembly << ".Lyb_rt_print_list_array:\n";
+        assembly << "    ldr x7, [x16]\n"; // Tableau : x8 éléments à partir de [x7]
+        assembly << "    add x8, x7, x8, lsl #3\n";
+        assembly << ".Lyb_rt_print_list_value:\n";
+        assembly << "    cmp x7, x8\n";
+        assembly << "    b.hs .Lyb_rt_print_list_next\n";
+        emitAddress(assembly, "x2", "yb_rt_outbuf");
+        assembly << "    sub x3, x1, x2\n";
+        // 21 octets suffisent pour un int64 signé et le séparateur
+        assembly << "    mov x4, #" << OUTPUT_BUFFER_SIZE - 32 << "\n";
+        assembly << "    cmp x3, x4\n";
+        assembly << "    b.ls .Lyb_rt_print_list_room\n";
+        emitAddress(assembly, "x4", "yb_rt_outpos");
+        assembly << "    str x3, [x4]\n";
+        assembly << "    str x8, [sp, #16]\n";
+        assembly << "    bl yb_rt_flush\n";
+        assembly << "    ldr x8, [sp, #16]\n";
+        emitAddress(assembly, "x1", "yb_rt_outbuf");
+        assembly << ".Lyb_rt_print_list_room:\n";
+        assembly << "    ldr x0, [x7], #8\n";
+        assembly << "    bl yb_rt_fmt_int\n";
+        assembly << "    mov w2, #32\n"; // Espace
+        assembly << "    strb w2, [x1], #1\n";
+        assembly << "    mov x2, #1\n";
+        assembly << "    str x2, [sp, #8]\n";
+        assembly << "    b .Lyb_rt_print_list_value\n";
+        assembly << ".Lyb_rt_print_list_next:\n";
+        assembly << "    add x16, x16, #16\n";
+        assembly << "    b .Lyb_rt_print_list_item\n";
+        assembly << ".Lyb_rt_print_list_end:\n";
+        assembly << "    ldr x2, [sp, #8]\n";
+        assembly << "    sub x1, x1, x2\n"; // Le dernier espace devient le saut de ligne
+        assembly << "    mov w2, #10\n";
+        assembly << "    strb w2, [x1], #1\n";
+        emitAddress(assembly, "x2", "yb_rt_outbuf");
+        assembly << "    sub x1, x1, x2\n";
+        emitAddress(assembly, "x2", "yb_rt_outpos");
+        assembly << "    str x1, [x2]\n";
+        assembly << "    ldr x30, [sp]\n";
+        assembly << "    add sp, sp, #32\n";
+        assembly << "    ret\n";
+    }
+
+    void emitFmtInt(std::stringstream &assembly) const
+    {
+        // Les chiffres sont produits à l'envers dans un tampon sur la pile puis recopiés.
+        // Ne modifie que x0 et x2-x6.
+        assembly << "yb_rt_fmt_int:\n";
+        assembly << "    sub sp, sp, #32\n";
+        assembly << "    add x2, sp, #32\n"; // Fin du tampon temporaire
+        assembly << "    mov x3, x0\n";      // Garder le signe
+        assembly << "    cmp x0, #0\n";
+        assembly << "    cneg x0, x0, lt\n";
+        // n / 10 = (n * 0xCCCCCCCCCCCCCCCD) >> 67, exact pour tout n < 2^64
+        emitConstant(assembly, "x4", static_cast<long long>(0xCCCCCCCCCCCCCCCDULL));
+        assembly << ".Lyb_rt_fmt_int_digit:\n";
+        assembly << "    umulh x5, x0, x4\n";
+        assembly << "    lsr x5, x5, #3\n";          // Quotient
+        assembly << "    add x6, x5, x5, lsl #2\n";
+        assembly << "    sub x6, x0, x6, lsl #1\n";  // Reste
+        assembly << "    add x6, x6, #48\n";         // '0'
+        assembly << "    strb w6, [x2, #-1]!\n";
+        assembly << "    mov x0, x5\n";
+        assembly << "    cbnz x0, .Lyb_rt_fmt_int_digit\n";
+        assembly << "    tbz x3, #63, .Lyb_rt_fmt_int_copy\n";
+        assembly << "    mov w6, #45\n"; // '-'
+        assembly << "    strb w6, [x2, #-1]!\n";
+        assembly << ".Lyb_rt_fmt_int_copy:\n";
+        assembly << "    add x5, sp, #32\n";
+        assembly << ".Lyb_rt_fmt_int_byte:\n";
+        assembly << "    ldrb w6, [x2], #1\n";
+        assembly << "    strb w6, [x1], #1\n";
+        assembly << "    cmp x2, x5\n";
+        assembly << "    b.lo .Lyb_rt_fmt_int_byte\n";
+        assembly << "    add sp, sp, #32\n";
+        assembly << "    ret\n";
+    }
+
+    void emitFlush(std::stringstream &assembly) const
+    {
+        // Ne modifie que x0-x3 et x8
+        assembly << "yb_rt_flush:\n";
+        emitAddress(assembly, "x1", "yb_rt_outbuf");
+        emitAddress(assembly, "x3", "yb_rt_outpos");
+        assembly << "    ldr x2, [x3]\n";
+        assembly << ".Lyb_rt_flush_write:\n";
+        assembly << "    cbz x2, .Lyb_rt_flush_done\n";
+        assembly << "    mov x0, #1\n";  // stdout
+        assembly << "    mov x8, #64\n"; // syscall write
+        assembly << "    svc #0\n";
+        assembly << "    cmp x0, #0\n";
+        assembly << "    b.le .Lyb_rt_flush_done\n";
+        assembly << "    add x1, x1, x0\n"; // Écriture partielle : on continue
+        assembly << "    sub x2, x2, x0\n";
+        assembly << "    b .Lyb_rt_flush_write\n";
+        assembly << ".Lyb_rt_flush_done:\n";
+        assembly << "    str xzr, [x3]\n";
+        assembly << "    ret\n";
+    }
+
+    void emitAllocArray(std::stringstream &assembly) const
+    {
+        // Disposition d'un tableau : [en-tête de 64 octets, longueur à la fin][élément 0][élément 1]...
+        assembly << "yb_rt_alloc_array:\n";
+        assembly << "    mov x6, x0\n"; // Nombre d'éléments
+        assembly << "    lsl x1, x0, #3\n";
+        assembly << "    add x1, x1, #" << ARRAY_HEADER_SIZE << "\n";
+        assembly << "    mov x0, #0\n";   // Le noyau choisit l'adresse
+        assembly << "    mov x2, #3\n";   // PROT_READ | PROT_WRITE
+        assembly << "    mov x3, #34\n";  // MAP_PRIVATE | MAP_ANONYMOUS
+        assembly << "    mov x4, #-1\n";
+        assembly << "    mov x5, #0\n";
+        assembly << "    mov x8, #222\n"; // syscall mmap
+        assembly << "    svc #0\n";
+        assembly << "    cmn x0, #4095\n"; // Les erreurs sont renvoyées sous forme -errno
+        assembly << "    b.hs .Lyb_rt_alloc_array_fail\n";
+        assembly << "    add x0, x0, #" << ARRAY_HEADER_SIZE << "\n";
+        assembly << "    stur x6, [x0, #-8]\n"; // Stocker la longueur
+        assembly << "    ret\n";
+        assembly << ".Lyb_rt_alloc_array_fail:\n";
+        emitPanicJump(assembly, "yb_rt_msg_alloc", MSG_ALLOC);
+    }
+
+    void emitAllocMatrix(std::stringstream &assembly) const
+    {
+        // Une seule allocation de lignes * colonnes éléments, rangés ligne par ligne
+        assembly << "yb_rt_alloc_matrix:\n";
+        assembly << "    orr x2, x0, x1\n"; // Dimension négative ?
+        assembly << "    tbnz x2, #63, .Lyb_rt_alloc_matrix_fail\n";
+        assembly << "    umulh x3, x0, x1\n";
+        assembly << "    cbnz x3, .Lyb_rt_alloc_matrix_fail\n";
+        assembly << "    mul x3, x0, x1\n";
+        assembly << "    movz x4, #0x100, lsl #48\n"; // La taille en octets doit rester représentable
+        assembly << "    cmp x3, x4\n";
+        assembly << "    b.hs .Lyb_rt_alloc_matrix_fail\n";
+        assembly << "    stp x0, x1, [sp, #-32]!\n";
+        assembly << "    str x30, [sp, #16]\n";
+        assembly << "    mov x0, x3\n";
+        assembly << "    bl yb_rt_alloc_array\n";
+        assembly << "    ldp x2, x3, [sp]\n";
+        assembly << "    ldr x30, [sp, #16]\n";
+        assembly << "    add sp, sp, #32\n";
+        assembly << "    stur x3, [x0, #-16]\n"; // Colonnes
+        assembly << "    stur x2, [x0, #-24]\n"; // Lignes
+        assembly << "    ret\n";
+        assembly << ".Lyb_rt_alloc_matrix_fail:\n";
+        emitPanicJump(assembly, "yb_rt_msg_alloc", MSG_ALLOC);
+    }
+
+    void emitPanicJump(std::stringstream &assembly, const std::string &label, const std::string &text) const
+    {
+        emitAddress(assembly, "x1", label);
+        assembly << "    mov x2, #" << text.size() + 1 << "\n"; // +1 pour le saut de ligne
+        assembly << "    b yb_rt_panic\n";
+    }
+
+    void emitTrap(std::stringstream &assembly, const std::string &name, const std::string &label,
+                  const std::string &text) const
+    {
+        assembly << name << ":\n";
+        emitPanicJump(assembly, label, text);
+    }
+
+    void emitDivTrap(std::stringstream &assembly) const
+    {
+        // Comme une faute de idiv : le processus est tué par SIGFPE, sans vider la sortie
+        assembly << "yb_rt_div_trap:\n";
+        assembly << "    mov x8, #172\n"; // syscall getpid
+        assembly << "    svc #0\n";
+        assembly << "    mov x1, #8\n";   // SIGFPE
+        assembly << "    mov x8, #129\n"; // syscall kill
+        assembly << "    svc #0\n";
+        assembly << "    mov x0, #136\n"; // Signal ignoré : même code que le shell
+        assembly << "    mov x8, #93\n";
+        assembly << "    svc #0\n";
+    }
+
+    void emitPanic(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_panic:\n";
+        if (uses(Routine::FLUSH))
+        {
+            // Ne pas perdre ce qui a déjà été affiché
+            assembly << "    stp x1, x2, [sp, #-16]!\n";
+            assembly << "    bl yb_rt_flush\n";
+            assembly << "    ldp x1, x2, [sp], #16\n";
+        }
+        assembly << "    mov x0, #2\n";  // stderr
+        assembly << "    mov x8, #64\n"; // syscall write
+        assembly << "    svc #0\n";
+        assembly << "    mov x0, #1\n";
+        assembly << "    mov x8, #93\n"; // syscall exit
+        assembly << "    svc #0\n";
+    }
+};
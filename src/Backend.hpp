@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CodeGenerator.hpp"
+#include "Lowering.hpp"
+#include <memory>
+#include <sstream>
+
+/**
+ * @file Backend.hpp
+ * @brief Backends des cibles qui passent par la représentation intermédiaire (Lowering.hpp).
+ *
+ * Un backend ne voit que des IrStatement : ajouter une cible revient à écrire la
+ * traduction de chaque IrOp, de l'entrée du programme et du runtime, sans toucher au
+ * Parser ni à la traduction de l'AST.
+ */
+
+/**
+ * @class Backend
+ * @brief Traduit la représentation intermédiaire en assembleur d'une cible
+ */
+class Backend
+{
+public:
+    virtual ~Backend() = default;
+
+    /**
+     * @brief Émet l'entrée du programme
+     */
+    virtual void begin(std::stringstream &assembly) = 0;
+
+    /**
+     * @brief Émet le code d'une instruction de premier niveau
+     */
+    virtual void emit(const IrStatement &statement, std::stringstream &assembly) = 0;
+
+    /**
+     * @brief Émet la sortie par défaut (code 0), le runtime et les données
+     * @param slotCount Nombre d'emplacements de variables du programme
+     */
+    virtual void finish(int slotCount, std::stringstream &assembly) = 0;
+};
+
+/**
+ * @class LoweringGenerator
+ * @brief CodeGenerator qui traduit chaque instruction en IR puis la passe à un backend
+ */
+class LoweringGenerator : public CodeGenerator
+{
+public:
+    /**
+     * @param backend Backend de la cible
+     * @param checkedArithmetic Sémantique de --checked-arith
+     */
+    LoweringGenerator(std::unique_ptr<Backend> backend, bool checkedArithmetic)
+        : m_lowering(checkedArithmetic), m_backend(std::move(backend)) {}
+
+    void beginAssembly(std::stringstream &assembly) const override
+    {
+        m_backend->begin(assembly);
+    }
+
+    void generateStatement(const std::shared_ptr<Stmt> &stmt, std::stringstream &assembly) const override
+    {
+        m_backend->emit(m_lowering.lower(stmt), assembly);
+    }
+
+    void finishAssembly(std::stringstream &assembly) const override
+    {
+        m_backend->finish(m_lowering.slotCount(), assembly);
+    }
+
+    /**
+     * @brief Indique qu'une instruction n'existe pas sur cette cible (le code produit est incomplet)
+     */
+    bool failed() const
+    {
+        return m_lowering.failed();
+    }
+
+private:
+    // La génération est incrémentale comme celle du Generator : l'état avance à chaque instruction
+    mutable Lowering m_lowering;
+    std::unique_ptr<Backend> m_backend;
+};
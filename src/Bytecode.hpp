@@ -0,0 +1,450 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @file Bytecode.hpp
+ * @brief Format du bytecode YB (option --target=bytecode), chargement et validation.
+ *
+ * Un module est :
+ * - l'en-tête "\0ybc" suivi de la version (un octet) ;
+ * - le nombre d'emplacements de variables et la taille du code, en LEB128 non signé ;
+ * - le code : un opcode d'un octet par instruction, suivi de ses opérandes. Les
+ *   constantes sont en LEB128 signé, les emplacements, tailles et indices en LEB128 non
+ *   signé, et les cibles de saut sur 4 octets little-endian (décalage depuis le début du code).
+ *
+ * Le bytecode est celui de la machine à pile de Lowering.hpp. Avant toute exécution,
+ * loadBytecode vérifie le module entier comme le fait un runtime WebAssembly : opcodes et
+ * opérandes valides, sauts vers des débuts d'instruction, emplacements existants, hauteur
+ * de pile identique sur tous les chemins et jamais négative, pas de sortie par la fin du
+ * code. La machine virtuelle (BytecodeVM.hpp) n'a ensuite plus aucun de ces contrôles à
+ * faire pendant l'exécution.
+ */
+
+/**
+ * @brief Opcodes du bytecode
+ */
+enum class Opcode : uint8_t
+{
+    CONST = 0x01,         // sleb valeur
+    LOAD = 0x02,          // uleb emplacement
+    STORE = 0x03,         // uleb emplacement
+    ADD = 0x10,
+    SUB = 0x11,
+    MUL = 0x12,
+    DIV = 0x13,
+    MOD = 0x14,
+    EQUAL = 0x15,
+    NOT_EQUAL = 0x16,
+    GREAT = 0x17,
+    LESS = 0x18,
+    GREAT_EQUAL = 0x19,
+    LESS_EQUAL = 0x1A,
+    AND = 0x1B,
+    OR = 0x1C,
+    ADD_CHECKED = 0x20,   // --checked-arith
+    SUB_CHECKED = 0x21,
+    MUL_CHECKED = 0x22,
+    JUMP = 0x30,          // u32 cible
+    JUMP_IF_ZERO = 0x31,  // u32 cible
+    NEW_ARRAY = 0x40,     // uleb éléments
+    INIT_ELEMENT = 0x41,  // uleb indice
+    NEW_MATRIX = 0x42,
+    LOAD_ELEMENT = 0x43,
+    STORE_ELEMENT = 0x44,
+    LOAD_MATRIX_ELEMENT = 0x45,
+    STORE_MATRIX_ELEMENT = 0x46,
+    LENGTH = 0x47,
+    PRINT = 0x50,         // uleb nombre de valeurs, puis un bit par valeur (1 : tableau), octets complétés par des 0
+    EXIT = 0x51,
+};
+
+/**
+ * @brief Constantes du format
+ */
+struct BytecodeFormat
+{
+    static constexpr char MAGIC[4] = {'\0', 'y', 'b', 'c'};
+    static constexpr uint8_t VERSION = 1;
+    static constexpr uint64_t MAX_SLOTS = 1u << 20;       /**< Emplacements de variables */
+    static constexpr uint64_t MAX_STACK = 1u << 20;       /**< Hauteur de pile */
+    static constexpr uint64_t MAX_PRINT_VALUES = 1u << 16; /**< Valeurs d'un print */
+};
+
+/**
+ * @brief Ajoute un entier en LEB128 non signé
+ */
+inline void writeUleb(std::string &out, uint64_t value)
+{
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out.push_back(static_cast<char>(byte | (value ? 0x80 : 0)));
+    } while (value);
+}
+
+/**
+ * @brief Ajoute un entier en LEB128 signé
+ */
+inline void writeSleb(std::string &out, int64_t value)
+{
+    while (true)
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7; // Décalage arithmétique
+        bool done = (value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40));
+        out.push_back(static_cast<char>(byte | (done ? 0 : 0x80)));
+        if (done)
+            return;
+    }
+}
+
+/**
+ * @brief Écrit un mot de 32 bits little-endian à la position `at`
+ */
+inline void patchU32(std::string &out, size_t at, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out[at + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+/**
+ * @brief Instruction décodée : opcode et opérande de taille fixe
+ */
+struct BytecodeInstr
+{
+    Opcode op;
+    int64_t operand = 0; /**< Constante, emplacement, taille, indice, cible (en instructions) ou print */
+};
+
+/**
+ * @brief Module chargé et validé, prêt pour la BytecodeVM
+ */
+struct BytecodeModule
+{
+    uint64_t slotCount = 0;
+    size_t maxStack = 0;                          /**< Hauteur de pile maximale sur tous les chemins */
+    std::vector<BytecodeInstr> code;              /**< Les sauts désignent des indices dans code */
+    std::vector<std::vector<bool>> printArrays;   /**< Nature des valeurs de chaque print (opérande de PRINT) */
+};
+
+namespace bytecode_detail
+{
+class Reader
+{
+public:
+    Reader(const std::string &bytes, size_t position) : m_bytes(bytes), m_position(position) {}
+
+    bool atEnd() const { return m_position >= m_bytes.size(); }
+    size_t position() const { return m_position; }
+
+    bool byte(uint8_t &value)
+    {
+        if (atEnd())
+            return false;
+        value = static_cast<uint8_t>(m_bytes[m_position++]);
+        return true;
+    }
+
+    bool uleb(uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t b;
+            if (!byte(b))
+                return false;
+            if (shift == 63 && (b & 0x7E))
+                return false; // Plus de 64 bits
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    bool sleb(int64_t &value)
+    {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t b;
+            if (!byte(b))
+                return false;
+            if (shift == 63 && b != 0 && b != 0x7F)
+                return false; // Plus de 64 bits
+            result |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+            {
+                if (shift + 7 < 64 && (b & 0x40))
+                    result |= ~uint64_t(0) << (shift + 7); // Extension du signe
+                value = static_cast<int64_t>(result);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool u32(uint32_t &value)
+    {
+        value = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            uint8_t b;
+            if (!byte(b))
+                return false;
+            value |= static_cast<uint32_t>(b) << (8 * i);
+        }
+        return true;
+    }
+
+private:
+    const std::string &m_bytes;
+    size_t m_position;
+};
+
+/**
+ * @brief Effet d'une instruction sur la pile : valeurs dépilées puis empilées
+ */
+inline void stackEffect(const BytecodeInstr &instr, const BytecodeModule &module, size_t &pops, size_t &pushes)
+{
+    pops = 0;
+    pushes = 0;
+    switch (instr.op)
+    {
+    case Opcode::CONST:
+    case Opcode::LOAD:
+    case Opcode::NEW_ARRAY:
+        pushes = 1;
+        break;
+    case Opcode::STORE:
+    case Opcode::JUMP_IF_ZERO:
+    case Opcode::EXIT:
+        pops = 1;
+        break;
+    case Opcode::INIT_ELEMENT: // La valeur est rangée dans le tableau, qui reste sur la pile
+        pops = 2;
+        pushes = 1;
+        break;
+    case Opcode::JUMP:
+        break;
+    case Opcode::LENGTH:
+        pops = pushes = 1;
+        break;
+    case Opcode::NEW_MATRIX:
+    case Opcode::LOAD_ELEMENT:
+        pops = 2;
+        pushes = 1;
+        break;
+    case Opcode::STORE_ELEMENT:
+        pops = 3;
+        break;
+    case Opcode::LOAD_MATRIX_ELEMENT:
+        pops = 3;
+        pushes = 1;
+        break;
+    case Opcode::STORE_MATRIX_ELEMENT:
+        pops = 4;
+        break;
+    case Opcode::PRINT:
+        pops = module.printArrays[instr.operand].size();
+        break;
+    default: // Opérations binaires
+        pops = 2;
+        pushes = 1;
+        break;
+    }
+}
+
+inline bool isBinary(uint8_t op)
+{
+    return (op >= static_cast<uint8_t>(Opcode::ADD) && op <= static_cast<uint8_t>(Opcode::OR)) ||
+           (op >= static_cast<uint8_t>(Opcode::ADD_CHECKED) && op <= static_cast<uint8_t>(Opcode::MUL_CHECKED));
+}
+} // namespace bytecode_detail
+
+/**
+ * @brief Décode et valide un module
+ * @param bytes Contenu du fichier .ybc
+ * @param error Raison du refus si le module est invalide
+ */
+inline std::optional<BytecodeModule> loadBytecode(const std::string &bytes, std::string &error)
+{
+    using namespace bytecode_detail;
+
+    if (bytes.size() < 5 || bytes.compare(0, 4, BytecodeFormat::MAGIC, 4) != 0)
+    {
+        error = "en-tete absent";
+        return std::nullopt;
+    }
+    if (static_cast<uint8_t>(bytes[4]) != BytecodeFormat::VERSION)
+    {
+        error = "version " + std::to_string(static_cast<uint8_t>(bytes[4])) + " non supportee";
+        return std::nullopt;
+    }
+
+    BytecodeModule module;
+    Reader header(bytes, 5);
+    uint64_t codeSize = 0;
+    if (!header.uleb(module.slotCount) || !header.uleb(codeSize) || module.slotCount > BytecodeFormat::MAX_SLOTS)
+    {
+        error = "en-tete invalide";
+        return std::nullopt;
+    }
+    size_t codeStart = header.position();
+    if (codeSize != bytes.size() - codeStart || codeSize == 0)
+    {
+        error = "taille du code incorrecte";
+        return std::nullopt;
+    }
+
+    // Décodage : chaque instruction garde son décalage pour résoudre les sauts
+    std::vector<uint64_t> offsets;
+    std::vector<size_t> indexOfOffset(codeSize + 1, SIZE_MAX);
+    Reader reader(bytes, codeStart);
+    while (!reader.atEnd())
+    {
+        size_t offset = reader.position() - codeStart;
+        indexOfOffset[offset] = module.code.size();
+        offsets.push_back(offset);
+
+        uint8_t op;
+        reader.byte(op);
+        BytecodeInstr instr{static_cast<Opcode>(op)};
+        bool valid = true;
+        switch (static_cast<Opcode>(op))
+        {
+        case Opcode::CONST:
+            valid = reader.sleb(instr.operand);
+            break;
+        case Opcode::LOAD:
+        case Opcode::STORE:
+        {
+            uint64_t slot;
+            valid = reader.uleb(slot) && slot < module.slotCount;
+            instr.operand = static_cast<int64_t>(slot);
+            break;
+        }
+        case Opcode::NEW_ARRAY:
+        case Opcode::INIT_ELEMENT:
+        {
+            uint64_t value;
+            valid = reader.uleb(value) && value < (uint64_t(1) << 56);
+            instr.operand = static_cast<int64_t>(value);
+            break;
+        }
+        case Opcode::JUMP:
+        case Opcode::JUMP_IF_ZERO:
+        {
+            uint32_t target;
+            valid = reader.u32(target);
+            instr.operand = target; // Converti en indice après le décodage
+            break;
+        }
+        case Opcode::PRINT:
+        {
+            uint64_t count;
+            valid = reader.uleb(count) && count <= BytecodeFormat::MAX_PRINT_VALUES;
+            std::vector<bool> arrays;
+            uint8_t mask = 0;
+            for (uint64_t i = 0; valid && i < count; i++)
+            {
+                if (i % 8 == 0)
+                    valid = reader.byte(mask);
+                arrays.push_back((mask >> (i % 8)) & 1);
+            }
+            instr.operand = static_cast<int64_t>(module.printArrays.size());
+            module.printArrays.push_back(std::move(arrays));
+            break;
+        }
+        case Opcode::NEW_MATRIX:
+        case Opcode::LOAD_ELEMENT:
+        case Opcode::STORE_ELEMENT:
+        case Opcode::LOAD_MATRIX_ELEMENT:
+        case Opcode::STORE_MATRIX_ELEMENT:
+        case Opcode::LENGTH:
+        case Opcode::EXIT:
+            break;
+        default:
+            valid = isBinary(op);
+            break;
+        }
+        if (!valid)
+        {
+            error = "instruction invalide a l'octet " + std::to_string(offset);
+            return std::nullopt;
+        }
+        module.code.push_back(instr);
+    }
+
+    for (size_t i = 0; i < module.code.size(); i++)
+    {
+        BytecodeInstr &instr = module.code[i];
+        if (instr.op != Opcode::JUMP && instr.op != Opcode::JUMP_IF_ZERO)
+            continue;
+        uint64_t target = static_cast<uint64_t>(instr.operand);
+        if (target >= codeSize || indexOfOffset[target] == SIZE_MAX)
+        {
+            error = "saut hors d'une instruction a l'octet " + std::to_string(offsets[i]);
+            return std::nullopt;
+        }
+        instr.operand = static_cast<int64_t>(indexOfOffset[target]);
+    }
+
+    // Hauteur de pile : un parcours de tous les chemins depuis la première instruction
+    std::vector<int64_t> height(module.code.size(), -1);
+    std::vector<size_t> pending = {0};
+    height[0] = 0;
+    while (!pending.empty())
+    {
+        size_t i = pending.back();
+        pending.pop_back();
+        const BytecodeInstr &instr = module.code[i];
+        size_t pops, pushes;
+        stackEffect(instr, module, pops, pushes);
+        if (static_cast<size_t>(height[i]) < pops)
+        {
+            error = "pile vide a l'octet " + std::to_string(offsets[i]);
+            return std::nullopt;
+        }
+        size_t after = height[i] - pops + pushes;
+        module.maxStack = std::max(module.maxStack, std::max<size_t>(after, height[i]));
+        if (module.maxStack > BytecodeFormat::MAX_STACK)
+        {
+            error = "pile trop haute a l'octet " + std::to_string(offsets[i]);
+            return std::nullopt;
+        }
+
+        std::vector<size_t> successors;
+        if (instr.op == Opcode::JUMP || instr.op == Opcode::JUMP_IF_ZERO)
+            successors.push_back(static_cast<size_t>(instr.operand));
+        if (instr.op != Opcode::JUMP && instr.op != Opcode::EXIT)
+        {
+            if (i + 1 == module.code.size())
+            {
+                error = "fin du code atteinte sans exit";
+                return std::nullopt;
+            }
+            successors.push_back(i + 1);
+        }
+        for (size_t next : successors)
+        {
+            if (height[next] < 0)
+            {
+                height[next] = static_cast<int64_t>(after);
+                pending.push_back(next);
+            }
+            else if (static_cast<size_t>(height[next]) != after)
+            {
+                error = "hauteur de pile differente selon le chemin a l'octet " + std::to_string(offsets[next]);
+                return std::nullopt;
+            }
+        }
+    }
+    return module;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Backend.hpp"
+#include "Bytecode.hpp"
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file BytecodeBackend.hpp
+ * @brief Backend bytecode (option --target=bytecode), exécuté par ybvm.
+ *
+ * Chaque IrOp devient un opcode du même nom (Bytecode.hpp) : le bytecode est la
+ * représentation intermédiaire sérialisée, sans labels. L'en-tête contient le nombre
+ * d'emplacements et la taille du code, connus seulement à la fin : le code est gardé en
+ * mémoire et tout le module est écrit par finish. Avec --stream, l'analyse et la
+ * traduction restent faites instruction par instruction.
+ */
+class BytecodeBackend : public Backend
+{
+public:
+    void begin(std::stringstream &) override {}
+
+    void emit(const IrStatement &statement, std::stringstream &) override
+    {
+        // Les labels d'une instruction ne sont utilisés que par ses propres sauts
+        std::unordered_map<long long, uint32_t> labels;
+        std::vector<std::pair<size_t, long long>> jumps;
+
+        for (const IrInstr &instr : statement.code)
+        {
+            switch (instr.op)
+            {
+            case IrOp::CONST:
+                emitOpcode(Opcode::CONST);
+                writeSleb(m_code, instr.value);
+                break;
+            case IrOp::LOAD:
+            case IrOp::STORE:
+                emitOpcode(instr.op == IrOp::LOAD ? Opcode::LOAD : Opcode::STORE);
+                writeUleb(m_code, static_cast<uint64_t>(instr.value));
+                break;
+            case IrOp::BINARY:
+                emitOpcode(binaryOpcode(instr));
+                break;
+            case IrOp::LABEL:
+                labels[instr.value] = static_cast<uint32_t>(m_code.size());
+                break;
+            case IrOp::JUMP:
+            case IrOp::JUMP_IF_ZERO:
+                emitOpcode(instr.op == IrOp::JUMP ? Opcode::JUMP : Opcode::JUMP_IF_ZERO);
+                jumps.push_back({m_code.size(), instr.value});
+                m_code.append(4, '\0'); // Cible écrite à la fin de l'instruction
+                break;
+            case IrOp::NEW_ARRAY:
+            case IrOp::INIT_ELEMENT:
+                emitOpcode(instr.op == IrOp::NEW_ARRAY ? Opcode::NEW_ARRAY : Opcode::INIT_ELEMENT);
+                writeUleb(m_code, static_cast<uint64_t>(instr.value));
+                break;
+            case IrOp::NEW_MATRIX:
+                emitOpcode(Opcode::NEW_MATRIX);
+                break;
+            case IrOp::LOAD_ELEMENT:
+                emitOpcode(Opcode::LOAD_ELEMENT);
+                break;
+            case IrOp::STORE_ELEMENT:
+                emitOpcode(Opcode::STORE_ELEMENT);
+                break;
+            case IrOp::LOAD_MATRIX_ELEMENT:
+                emitOpcode(Opcode::LOAD_MATRIX_ELEMENT);
+                break;
+            case IrOp::STORE_MATRIX_ELEMENT:
+                emitOpcode(Opcode::STORE_MATRIX_ELEMENT);
+                break;
+            case IrOp::LENGTH:
+                emitOpcode(Opcode::LENGTH);
+                break;
+            case IrOp::PRINT:
+            {
+                emitOpcode(Opcode::PRINT);
+                writeUleb(m_code, instr.arrays.size());
+                for (size_t i = 0; i < instr.arrays.size(); i += 8)
+                {
+                    uint8_t mask = 0;
+                    for (size_t bit = 0; bit < 8 && i + bit < instr.arrays.size(); bit++)
+                        mask |= instr.arrays[i + bit] << bit;
+                    m_code.push_back(static_cast<char>(mask));
+                }
+                break;
+            }
+            case IrOp::EXIT:
+                emitOpcode(Opcode::EXIT);
+                break;
+            }
+        }
+
+        for (const auto &jump : jumps)
+            patchU32(m_code, jump.first, labels.at(jump.second));
+    }
+
+    void finish(int slotCount, std::stringstream &assembly) override
+    {
+        // Sortie par défaut avec le code 0
+        emitOpcode(Opcode::CONST);
+        writeSleb(m_code, 0);
+        emitOpcode(Opcode::EXIT);
+
+        std::string header(BytecodeFormat::MAGIC, sizeof(BytecodeFormat::MAGIC));
+        header.push_back(static_cast<char>(BytecodeFormat::VERSION));
+        writeUleb(header, static_cast<uint64_t>(slotCount) + 1); // Les emplacements commencent à 1
+        writeUleb(header, m_code.size());
+        assembly << header << m_code;
+    }
+
+private:
+    std::string m_code; ///< Code du module, écrit par finish après l'en-tête
+
+    void emitOpcode(Opcode op)
+    {
+        m_code.push_back(static_cast<char>(op));
+    }
+
+    static Opcode binaryOpcode(const IrInstr &instr)
+    {
+        switch (instr.binaryOp)
+        {
+        case BinaryOpType::ADD:
+            return instr.checked ? Opcode::ADD_CHECKED : Opcode::ADD;
+        case BinaryOpType::SUB:
+            return instr.checked ? Opcode::SUB_CHECKED : Opcode::SUB;
+        case BinaryOpType::MUL:
+            return instr.checked ? Opcode::MUL_CHECKED : Opcode::MUL;
+        case BinaryOpType::DIV:
+            return Opcode::DIV;
+        case BinaryOpType::MOD:
+            return Opcode::MOD;
+        case BinaryOpType::EQUAL:
+            return Opcode::EQUAL;
+        case BinaryOpType::NOT_EQUAL:
+            return Opcode::NOT_EQUAL;
+        case BinaryOpType::GREAT:
+            return Opcode::GREAT;
+        case BinaryOpType::LESS:
+            return Opcode::LESS;
+        case BinaryOpType::GREAT_EQUAL:
+            return Opcode::GREAT_EQUAL;
+        case BinaryOpType::LESS_EQUAL:
+            return Opcode::LESS_EQUAL;
+        case BinaryOpType::AND:
+            return Opcode::AND;
+        case BinaryOpType::OR:
+            return Opcode::OR;
+        }
+        return Opcode::ADD;
+    }
+};
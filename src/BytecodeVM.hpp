@@ -0,0 +1,351 @@
+#pragma once
+
+#include "Bytecode.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file BytecodeVM.hpp
+ * @brief Machine virtuelle du bytecode YB, utilisée par ybvm.
+ *
+ * La VM n'exécute que des modules validés par loadBytecode : la pile est allouée une
+ * fois à sa hauteur maximale et la boucle d'exécution ne vérifie ni la pile, ni les
+ * opérandes, ni les sauts. Elle garde en revanche tout ce qui protège l'hôte :
+ * - chaque valeur porte son type : un entier ne peut pas servir d'adresse de tableau ;
+ * - les indices sont contrôlés comme dans le runtime natif ;
+ * - la mémoire des tableaux est bornée (maxMemory).
+ *
+ * Les erreurs d'exécution ont les messages et les codes de retour du runtime natif
+ * (code 1), la division par zéro et les erreurs de type ceux du mode --fault-handler
+ * (128 + SIGFPE, 128 + SIGSEGV) : la sortie déjà produite est toujours écrite.
+ */
+class BytecodeVM
+{
+public:
+    /**
+     * @param module Module validé par loadBytecode
+     * @param output Sortie des print
+     * @param errors Sortie des messages d'erreur
+     * @param maxMemory Octets alloués au plus pour les tableaux (en-tête de 64 octets compris)
+     */
+    BytecodeVM(const BytecodeModule &module, std::ostream &output, std::ostream &errors, uint64_t maxMemory)
+        : m_module(module), m_output(output), m_errors(errors), m_maxMemory(maxMemory) {}
+
+    /**
+     * @brief Exécute le programme
+     * @return Le code de retour du programme
+     */
+    int run()
+    {
+        std::vector<Value> stack(m_module.maxStack + 1);
+        std::vector<Value> slots(m_module.slotCount);
+        Value *top = stack.data(); // Première case libre
+        const BytecodeInstr *code = m_module.code.data();
+        size_t pc = 0;
+
+        while (true)
+        {
+            const BytecodeInstr &instr = code[pc++];
+            switch (instr.op)
+            {
+            case Opcode::CONST:
+                *top++ = {instr.operand, -1};
+                break;
+            case Opcode::LOAD:
+                *top++ = slots[instr.operand];
+                break;
+            case Opcode::STORE:
+                slots[instr.operand] = *--top;
+                break;
+            case Opcode::JUMP:
+                pc = static_cast<size_t>(instr.operand);
+                break;
+            case Opcode::JUMP_IF_ZERO:
+            {
+                int64_t condition;
+                if (!number(*--top, condition))
+                    return typeError();
+                if (condition == 0)
+                    pc = static_cast<size_t>(instr.operand);
+                break;
+            }
+            case Opcode::NEW_ARRAY:
+            {
+                int32_t array;
+                if (!allocate(static_cast<uint64_t>(instr.operand), 0, 0, array))
+                    return trap(MSG_ALLOC, 1);
+                *top++ = {0, array};
+                break;
+            }
+            case Opcode::INIT_ELEMENT:
+            {
+                Value value = *--top;
+                if (top[-1].array < 0)
+                    return typeError();
+                std::vector<Value> &elements = m_arrays[top[-1].array].elements;
+                if (static_cast<uint64_t>(instr.operand) >= elements.size())
+                    return trap(MSG_BOUNDS, 1);
+                elements[instr.operand] = value;
+                break;
+            }
+            case Opcode::NEW_MATRIX:
+            {
+                int64_t rows, cols, size = 0;
+                top -= 2;
+                if (!number(top[1], rows) || !number(top[0], cols))
+                    return typeError();
+                int32_t matrix;
+                if (rows < 0 || cols < 0 || __builtin_mul_overflow(rows, cols, &size) || size >= (int64_t(1) << 56) ||
+                    !allocate(static_cast<uint64_t>(size), rows, cols, matrix))
+                    return trap(MSG_ALLOC, 1);
+                *top++ = {0, matrix};
+                break;
+            }
+            case Opcode::LOAD_ELEMENT:
+            case Opcode::STORE_ELEMENT:
+            {
+                top -= 2;
+                int64_t index;
+                if (top[0].array < 0 || !number(top[1], index))
+                    return typeError();
+                std::vector<Value> &elements = m_arrays[top[0].array].elements;
+                if (static_cast<uint64_t>(index) >= elements.size())
+                    return trap(MSG_BOUNDS, 1);
+                if (instr.op == Opcode::LOAD_ELEMENT)
+                    *top++ = elements[index];
+                else
+                    elements[index] = *--top;
+                break;
+            }
+            case Opcode::LOAD_MATRIX_ELEMENT:
+            case Opcode::STORE_MATRIX_ELEMENT:
+            {
+                top -= 3;
+                int64_t row, col;
+                if (top[0].array < 0 || !number(top[1], row) || !number(top[2], col))
+                    return typeError();
+                Array &matrix = m_arrays[top[0].array];
+                if (static_cast<uint64_t>(row) >= static_cast<uint64_t>(matrix.rows) ||
+                    static_cast<uint64_t>(col) >= static_cast<uint64_t>(matrix.cols))
+                    return trap(MSG_BOUNDS, 1);
+                Value &element = matrix.elements[row * matrix.cols + col];
+                if (instr.op == Opcode::LOAD_MATRIX_ELEMENT)
+                    *top++ = element;
+                else
+                    element = *--top;
+                break;
+            }
+            case Opcode::LENGTH:
+                if (top[-1].array < 0)
+                    return typeError();
+                top[-1] = {static_cast<int64_t>(m_arrays[top[-1].array].elements.size()), -1};
+                break;
+            case Opcode::PRINT:
+            {
+                const std::vector<bool> &arrays = m_module.printArrays[instr.operand];
+                top -= arrays.size();
+                if (!print(top, arrays))
+                    return typeError();
+                break;
+            }
+            case Opcode::EXIT:
+            {
+                int64_t status;
+                if (!number(*--top, status))
+                    return typeError();
+                flush();
+                return static_cast<int>(status & 0xFF);
+            }
+            default:
+            {
+                // Opérations binaires : l'opérande gauche est au sommet
+                int64_t left, right, result;
+                top -= 2;
+                if (!number(top[1], left) || !number(top[0], right))
+                    return typeError();
+                if (!binary(instr.op, left, right, result))
+                {
+                    if (instr.op == Opcode::DIV || instr.op == Opcode::MOD)
+                        return trap(MSG_FPE, 128 + 8); // SIGFPE
+                    return trap(MSG_OVERFLOW, 1);
+                }
+                *top++ = {result, -1};
+                break;
+            }
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Valeur de la pile ou d'une variable : entier, ou tableau si array >= 0
+     */
+    struct Value
+    {
+        int64_t number = 0;
+        int32_t array = -1; /**< Indice dans m_arrays */
+    };
+
+    struct Array
+    {
+        std::vector<Value> elements;
+        int64_t rows = 0; /**< Matrice : dimensions, 0 pour un tableau */
+        int64_t cols = 0;
+    };
+
+    static constexpr uint64_t ARRAY_HEADER_SIZE = 64;
+    static constexpr size_t OUTPUT_BUFFER_SIZE = 65536;
+
+    static constexpr const char *MSG_BOUNDS = "Erreur: indice de tableau hors limites";
+    static constexpr const char *MSG_ALLOC = "Erreur: allocation memoire impossible";
+    static constexpr const char *MSG_OVERFLOW = "Erreur: depassement de capacite arithmetique";
+    static constexpr const char *MSG_FPE = "Erreur: division par zero ou depassement de division";
+    static constexpr const char *MSG_TYPE = "Erreur: valeur de type invalide";
+
+    const BytecodeModule &m_module;
+    std::ostream &m_output;
+    std::ostream &m_errors;
+    uint64_t m_maxMemory;
+    uint64_t m_usedMemory = 0;
+    std::vector<Array> m_arrays;
+    std::string m_buffer; ///< Sortie en attente, écrite par blocs comme le tampon du runtime
+
+    static bool number(const Value &value, int64_t &result)
+    {
+        result = value.number;
+        return value.array < 0;
+    }
+
+    bool allocate(uint64_t size, int64_t rows, int64_t cols, int32_t &array)
+    {
+        uint64_t bytes = ARRAY_HEADER_SIZE + size * sizeof(Value);
+        if (size > m_maxMemory / sizeof(Value) || bytes > m_maxMemory - m_usedMemory ||
+            m_arrays.size() >= static_cast<size_t>(INT32_MAX))
+            return false;
+        m_usedMemory += bytes;
+        m_arrays.push_back({std::vector<Value>(size), rows, cols});
+        array = static_cast<int32_t>(m_arrays.size() - 1);
+        return true;
+    }
+
+    /**
+     * @brief Calcule left op right, faux sur division par zéro ou dépassement (opérations vérifiées)
+     */
+    static bool binary(Opcode op, int64_t left, int64_t right, int64_t &result)
+    {
+        uint64_t l = static_cast<uint64_t>(left);
+        uint64_t r = static_cast<uint64_t>(right);
+        switch (op)
+        {
+        case Opcode::ADD:
+            result = static_cast<int64_t>(l + r);
+            return true;
+        case Opcode::SUB:
+            result = static_cast<int64_t>(l - r);
+            return true;
+        case Opcode::MUL:
+            result = static_cast<int64_t>(l * r);
+            return true;
+        case Opcode::ADD_CHECKED:
+            return !__builtin_add_overflow(left, right, &result);
+        case Opcode::SUB_CHECKED:
+            return !__builtin_sub_overflow(left, right, &result);
+        case Opcode::MUL_CHECKED:
+            return !__builtin_mul_overflow(left, right, &result);
+        case Opcode::DIV:
+        case Opcode::MOD:
+            if (right == 0 || (left == INT64_MIN && right == -1))
+                return false;
+            result = op == Opcode::DIV ? left / right : left % right;
+            return true;
+        case Opcode::EQUAL:
+            result = left == right;
+            return true;
+        case Opcode::NOT_EQUAL:
+            result = left != right;
+            return true;
+        case Opcode::GREAT:
+            result = left > right;
+            return true;
+        case Opcode::LESS:
+            result = left < right;
+            return true;
+        case Opcode::GREAT_EQUAL:
+            result = left >= right;
+            return true;
+        case Opcode::LESS_EQUAL:
+            result = left <= right;
+            return true;
+        case Opcode::AND:
+            result = left & right;
+            return true;
+        case Opcode::OR:
+            result = left | right;
+            return true;
+        default:
+            result = 0;
+            return true;
+        }
+    }
+
+    /**
+     * @brief Écrit une ligne : les valeurs séparées par un espace, les tableaux développés
+     */
+    bool print(const Value *values, const std::vector<bool> &arrays)
+    {
+        bool written = false;
+        for (size_t i = 0; i < arrays.size(); i++)
+        {
+            if (arrays[i] != (values[i].array >= 0))
+                return false;
+            if (!arrays[i])
+            {
+                appendNumber(values[i].number);
+                written = true;
+                continue;
+            }
+            for (const Value &element : m_arrays[values[i].array].elements)
+            {
+                if (element.array >= 0)
+                    return false;
+                appendNumber(element.number);
+                written = true;
+            }
+        }
+        if (written)
+            m_buffer.back() = '\n'; // Le dernier espace devient le saut de ligne
+        else
+            m_buffer.push_back('\n');
+        if (m_buffer.size() >= OUTPUT_BUFFER_SIZE)
+            flush();
+        return true;
+    }
+
+    void appendNumber(int64_t value)
+    {
+        // Pas d'écriture au milieu d'une ligne : print remplace encore le dernier espace
+        m_buffer += std::to_string(value);
+        m_buffer.push_back(' ');
+    }
+
+    void flush()
+    {
+        m_output.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_output.flush();
+        m_buffer.clear();
+    }
+
+    int trap(const char *message, int code)
+    {
+        flush();
+        m_errors << message << std::endl;
+        return code;
+    }
+
+    int typeError()
+    {
+        return trap(MSG_TYPE, 128 + 11); // SIGSEGV : ce que ferait le code natif
+    }
+};
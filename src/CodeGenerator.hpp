@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Parser.hpp"
+#include <memory>
+#include <sstream>
+#include <string>
+
+/**
+ * @file CodeGenerator.hpp
+ * @brief Interface commune des générateurs de code, quelle que soit la cible.
+ *
+ * Le Generator x86-64 (Generator.hpp) produit directement du NASM à partir de l'AST,
+ * avec ses optimisations propres. Les autres cibles passent par la représentation
+ * intermédiaire de Lowering.hpp et un backend (LoweringGenerator, Backend.hpp).
+ * Le compilateur, les modes --stream et --pipeline n'utilisent que cette interface.
+ */
+
+/**
+ * @brief Architecture du code produit (option --target)
+ */
+enum class Target
+{
+    X86_64,  // NASM, Linux x86-64 (Generator)
+    AARCH64, // Assembleur GNU, Linux AArch64 (AArch64Backend)
+    BYTECODE, // Bytecode portable exécuté par ybvm (BytecodeBackend)
+};
+
+/**
+ * @class CodeGenerator
+ * @brief Génération incrémentale : entrée du programme, instructions de premier niveau, fin
+ *
+ * beginAssembly, puis generateStatement pour chaque instruction de premier niveau dans
+ * l'ordre, puis finishAssembly produisent le programme complet. Chaque partie peut être
+ * écrite dans la sortie dès qu'elle est générée.
+ */
+class CodeGenerator
+{
+public:
+    virtual ~CodeGenerator() = default;
+
+    /**
+     * @brief Émet l'entrée du programme
+     */
+    virtual void beginAssembly(std::stringstream &assembly) const = 0;
+
+    /**
+     * @brief Émet le code d'une instruction de premier niveau
+     */
+    virtual void generateStatement(const std::shared_ptr<Stmt> &stmt, std::stringstream &assembly) const = 0;
+
+    /**
+     * @brief Émet la sortie par défaut et le runtime
+     */
+    virtual void finishAssembly(std::stringstream &assembly) const = 0;
+
+    /**
+     * @brief Génère tout un programme
+     */
+    std::string generateProgram(const Program &program) const
+    {
+        std::stringstream assembly;
+        beginAssembly(assembly);
+        for (const auto &stmt : program.statements)
+            generateStatement(stmt, assembly);
+        finishAssembly(assembly);
+        return assembly.str();
+    }
+};
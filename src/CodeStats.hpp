@@ -0,0 +1,317 @@
+#pragma once
+
+#include "Parser.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file CodeStats.hpp
+ * @brief Statistiques du code généré (option --stats).
+ *
+ * Pendant la génération, le Generator signale au CodeStatsRecorder la construction
+ * en cours (print, tableau littéral, expression binaire, en-tête de boucle...) et les
+ * bornes de chaque instruction de premier niveau, sous forme de positions dans le flux
+ * assembleur. Le texte final est ensuite parcouru une seule fois : chaque instruction
+ * machine est attribuée à la construction la plus interne active à sa position
+ * (compte propre) et à toutes les constructions englobantes (compte inclus).
+ */
+
+/**
+ * @brief Constructions du langage auxquelles les instructions sont attribuées
+ */
+enum class CodeConstruct
+{
+    PROLOGUE,      // Entrée du programme et sortie par défaut
+    PRINT,         // print(expr)
+    ARRAY_LITERAL, // [a, b, c]
+    BINARY,        // Expressions binaires
+    LOOP_HEADER,   // Condition, saut de sortie et retour d'un while, adresses de lignes pré-calculées
+    IF_CONDITION,  // Condition et sauts d'un if
+    MATCH,         // Aiguillage d'un match : table de sauts, tests de bits ou comparaisons
+    STORE,         // let et affectations de variables
+    ARRAY_ACCESS,  // Lecture et écriture t[i], contrôle des bornes compris
+    MATRIX,        // matrix(l, c), lecture et écriture m[i][j]
+    LENGTH,        // len(t)
+    BLOCK,         // Libération des variables d'un bloc
+    EXIT,          // exit(expr)
+    RUNTIME,       // Routines yb_rt
+    COUNT
+};
+
+/**
+ * @brief Statistiques calculées sur le code généré
+ */
+struct CodeStats
+{
+    /**
+     * @brief Taille du code d'une instruction de premier niveau
+     */
+    struct Statement
+    {
+        int line;          /**< Ligne du source */
+        StmtType type;     /**< Type de l'instruction */
+        long instructions; /**< Instructions machine émises, instructions imbriquées comprises */
+    };
+
+    long own[static_cast<int>(CodeConstruct::COUNT)] = {};      /**< Instructions attribuées à la construction la plus interne */
+    long included[static_cast<int>(CodeConstruct::COUNT)] = {}; /**< Instructions émises pendant la construction */
+    long total = 0;
+    long pushes = 0;
+    long pops = 0;
+    long divisions = 0;
+    long syscalls = 0;
+    std::vector<Statement> statements;
+
+    /**
+     * @brief Affiche le rapport
+     * @param maxStatements Nombre d'instructions de premier niveau listées (les plus grosses)
+     */
+    void print(std::ostream &out, size_t maxStatements = 20) const
+    {
+        static const char *names[] = {"prologue", "print", "tableau litteral", "expression binaire",
+                                      "en-tete de boucle", "condition if", "aiguillage match", "affectation", "acces tableau",
+                                      "matrice", "len", "bloc", "exit", "runtime"};
+
+        out << "Instructions generees : " << total << "\n"
+            << "  push " << pushes << ", pop " << pops << ", div " << divisions
+            << ", syscall " << syscalls << "\n\n";
+
+        out << std::left << std::setw(22) << "construction" << std::right << std::setw(10) << "propres"
+            << std::setw(8) << "%" << std::setw(10) << "incluses" << "\n";
+        for (int i = 0; i < static_cast<int>(CodeConstruct::COUNT); i++)
+        {
+            out << std::left << std::setw(22) << names[i] << std::right << std::setw(10) << own[i]
+                << std::setw(7) << std::fixed << std::setprecision(1)
+                << (total ? 100.0 * own[i] / total : 0.0) << "%" << std::setw(10) << included[i] << "\n";
+        }
+
+        std::vector<Statement> largest = statements;
+        std::stable_sort(largest.begin(), largest.end(), [](const Statement &a, const Statement &b)
+                         { return a.instructions > b.instructions; });
+        if (largest.size() > maxStatements)
+            largest.resize(maxStatements);
+
+        out << "\nTaille par instruction (" << largest.size() << " plus grosses sur " << statements.size() << ")\n";
+        for (const auto &statement : largest)
+            out << "  ligne " << std::setw(6) << statement.line << "  " << std::left << std::setw(14)
+                << stmtTypeName(statement.type) << std::right << std::setw(8) << statement.instructions << "\n";
+    }
+
+    static const char *stmtTypeName(StmtType type)
+    {
+        switch (type)
+        {
+        case StmtType::EXIT:
+            return "exit";
+        case StmtType::LET:
+            return "let";
+        case StmtType::BLOCK:
+            return "bloc";
+        case StmtType::IF:
+            return "if";
+        case StmtType::ELES:
+            return "else";
+        case StmtType::WHILE:
+            return "while";
+        case StmtType::ASSIGN:
+            return "affectation";
+        case StmtType::PRINT:
+            return "print";
+        case StmtType::ARRAY_ASSIGN:
+            return "t[i] =";
+        case StmtType::MATRIX_ASSIGN:
+            return "m[i][j] =";
+        case StmtType::PARAM:
+            return "param";
+        case StmtType::MATCH:
+            return "match";
+        }
+        return "?";
+    }
+};
+
+/**
+ * @brief Enregistre, pendant la génération, quelle construction émet quel code
+ *
+ * Désactivé, il ne fait rien : la génération normale n'en paie pas le coût.
+ */
+class CodeStatsRecorder
+{
+public:
+    explicit CodeStatsRecorder(bool enabled = false) : m_enabled(enabled) {}
+
+    bool enabled() const { return m_enabled; }
+
+    /**
+     * @brief Le code émis à partir de `position` appartient à `construct`
+     */
+    void enter(CodeConstruct construct, long position)
+    {
+        if (!m_enabled)
+            return;
+        m_stack.push_back(construct);
+        mark(position);
+    }
+
+    /**
+     * @brief Fin de la construction la plus interne
+     */
+    void leave(long position)
+    {
+        if (!m_enabled)
+            return;
+        m_stack.pop_back();
+        mark(position);
+    }
+
+    /**
+     * @brief Bornes du code d'une instruction de premier niveau
+     */
+    void statement(const Stmt &stmt, long begin, long end)
+    {
+        if (m_enabled)
+            m_statements.push_back({stmt.line, stmt.getType(), begin, end});
+    }
+
+    /**
+     * @brief Parcourt le code assembleur final et calcule les statistiques
+     */
+    CodeStats analyze(const std::string &assembly) const
+    {
+        CodeStats stats;
+        size_t nextMark = 0;
+        size_t nextStatement = 0;
+        Mark current = {0, CodeConstruct::PROLOGUE, 1u << static_cast<int>(CodeConstruct::PROLOGUE)};
+        std::vector<long> statementSizes(m_statements.size(), 0);
+
+        size_t lineStart = 0;
+        while (lineStart < assembly.size())
+        {
+            size_t lineEnd = assembly.find('\n', lineStart);
+            if (lineEnd == std::string::npos)
+                lineEnd = assembly.size();
+            long position = static_cast<long>(lineStart);
+
+            while (nextMark < m_marks.size() && m_marks[nextMark].position <= position)
+                current = m_marks[nextMark++];
+            while (nextStatement < m_statements.size() && m_statements[nextStatement].end <= position)
+                nextStatement++;
+
+            std::string mnemonic = instructionMnemonic(assembly, lineStart, lineEnd);
+            if (!mnemonic.empty())
+            {
+                stats.total++;
+                stats.own[static_cast<int>(current.construct)]++;
+                for (int i = 0; i < static_cast<int>(CodeConstruct::COUNT); i++)
+                    if (current.active & (1u << i))
+                        stats.included[i]++;
+
+                if (mnemonic == "push")
+                    stats.pushes++;
+                else if (mnemonic == "pop")
+                    stats.pops++;
+                else if (mnemonic == "div" || mnemonic == "idiv")
+                    stats.divisions++;
+                else if (mnemonic == "syscall")
+                    stats.syscalls++;
+
+                if (nextStatement < m_statements.size() && m_statements[nextStatement].begin <= position)
+                    statementSizes[nextStatement]++;
+            }
+            lineStart = lineEnd + 1;
+        }
+
+        for (size_t i = 0; i < m_statements.size(); i++)
+            stats.statements.push_back({m_statements[i].line, m_statements[i].type, statementSizes[i]});
+        return stats;
+    }
+
+private:
+    /**
+     * @brief Changement de construction à une position du flux assembleur
+     */
+    struct Mark
+    {
+        long position;
+        CodeConstruct construct; /**< Construction la plus interne */
+        unsigned active;         /**< Constructions actives (un bit par construction) */
+    };
+
+    struct StatementRange
+    {
+        int line;
+        StmtType type;
+        long begin;
+        long end;
+    };
+
+    void mark(long position)
+    {
+        unsigned active = 0;
+        for (CodeConstruct construct : m_stack)
+            active |= 1u << static_cast<int>(construct);
+        CodeConstruct innermost = m_stack.empty() ? CodeConstruct::PROLOGUE : m_stack.back();
+        if (m_stack.empty())
+            active = 1u << static_cast<int>(CodeConstruct::PROLOGUE);
+
+        // Plusieurs changements à la même position : seul le dernier compte
+        if (!m_marks.empty() && m_marks.back().position == position)
+            m_marks.back() = {position, innermost, active};
+        else
+            m_marks.push_back({position, innermost, active});
+    }
+
+    /**
+     * @brief Mnémonique d'une ligne d'instruction (indentée), vide pour un label,
+     * un commentaire ou une directive
+     */
+    static std::string instructionMnemonic(const std::string &assembly, size_t begin, size_t end)
+    {
+        if (begin == end || (assembly[begin] != ' ' && assembly[begin] != '\t'))
+            return "";
+        while (begin < end && (assembly[begin] == ' ' || assembly[begin] == '\t'))
+            begin++;
+        size_t wordEnd = begin;
+        while (wordEnd < end && assembly[wordEnd] != ' ' && assembly[wordEnd] != '\t')
+            wordEnd++;
+        std::string word = assembly.substr(begin, wordEnd - begin);
+        if (word.empty() || word[0] == ';' || word == "align" || word == "section" || word == "global")
+            return "";
+        return word;
+    }
+
+    bool m_enabled;
+    std::vector<CodeConstruct> m_stack;
+    std::vector<Mark> m_marks;
+    std::vector<StatementRange> m_statements;
+};
+
+/**
+ * @brief Attribue à une construction le code émis pendant la durée de vie de l'objet
+ */
+class ConstructScope
+{
+public:
+    ConstructScope(CodeStatsRecorder &recorder, CodeConstruct construct, std::ostream &assembly)
+        : m_recorder(recorder), m_assembly(assembly)
+    {
+        if (m_recorder.enabled())
+            m_recorder.enter(construct, static_cast<long>(m_assembly.tellp()));
+    }
+
+    ~ConstructScope()
+    {
+        if (m_recorder.enabled())
+            m_recorder.leave(static_cast<long>(m_assembly.tellp()));
+    }
+
+    ConstructScope(const ConstructScope &) = delete;
+    ConstructScope &operator=(const ConstructScope &) = delete;
+
+private:
+    CodeStatsRecorder &m_recorder;
+    std::ostream &m_assembly;
+};
@@ -1,25 +1,58 @@
 #pragma once
 
 #include "Parser.hpp"
+#include "CodeGenerator.hpp"
+#include "CodeStats.hpp"
+#include "HeaderEmitter.hpp"
+#include "RuntimeEmitter.hpp"
+#include "Scheduler.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
 #include <optional>
 #include <vector>
 
 /**
- * @brief Classe responsable de la génération de code assembleur
+ * @brief Options de génération choisies sur la ligne de commande
+ */
+struct GeneratorOptions
+{
+    RuntimeOptions runtime; /**< Options du runtime yb_rt */
+    bool stats = false;     /**< Enregistrer l'origine de chaque instruction (voir codeStats) */
+    bool promoteLoopVariables = true; /**< Garder les variables des boucles internes dans des registres */
+    bool checkedArithmetic = false;   /**< Arrêter le programme sur un dépassement de +, - ou * (jo) */
+    bool faultHandler = false;        /**< Indiquer la ligne du source sur SIGFPE et SIGSEGV */
+    bool schedule = true;             /**< Réordonner le code de chaque instruction (voir Scheduler) */
+    std::string entryName = "yb_main"; /**< Symbole exporté en bibliothèque partagée (runtime.sharedLibrary) */
+};
+
+/**
+ * @brief Classe responsable de la génération de code assembleur x86-64
  *
  * Cette classe prend un arbre syntaxique abstrait (AST) construit par le Parser
  * et le convertit en code assembleur exécutable.
  */
-class Generator
+class Generator : public CodeGenerator
 {
 public:
     /**
      * @brief Constructeur de la classe Generator
      * @param program Programme à compiler (racine de l'AST)
+     * @param options Options de génération
      */
-    Generator(const Program &program) : m_program(program) {}
+    Generator(const Program &program, const GeneratorOptions &options = GeneratorOptions())
+        : m_program(program), m_options(options), m_runtime(options.runtime), m_stats(options.stats) {}
+
+    /**
+     * @brief Constructeur pour la génération incrémentale (voir beginAssembly)
+     * @param options Options de génération
+     */
+    explicit Generator(const GeneratorOptions &options)
+        : m_program(), m_options(options), m_runtime(options.runtime), m_stats(options.stats) {}
 
     /**
      * @brief Génère le code assembleur à partir de l'AST
@@ -28,66 +61,195 @@ public:
     std::string generateAssembly() const
     {
         std::stringstream assembly;
-        std::vector<std::unordered_map<std::string, int>> symbolTables;
-        symbolTables.push_back({}); // Scope global
+        beginAssembly(assembly);
+
+        // Parcourir toutes les instructions du programme
+        for (const auto &stmt : m_program.statements)
+        {
+            generateStatement(stmt, assembly);
+        }
 
-        int stackOffset = 0;      // Offset de la pile pour les variables
-        bool hasExitStmt = false; // Indique si une instruction exit a été trouvée
+        finishAssembly(assembly);
 
-        assembly << "global _start\n";
-        assembly << "section .text\n";
-        assembly << "_start:\n";
+        std::string code = assembly.str();
+        if (m_stats.enabled())
+            m_codeStats = m_stats.analyze(code);
+        return code;
+    }
+
+    /**
+     * @brief Génération incrémentale : émet l'entrée du programme
+     *
+     * beginAssembly, puis generateStatement pour chaque instruction de premier niveau
+     * dans l'ordre, puis finishAssembly produisent le même code que generateAssembly.
+     * Chaque partie peut être écrite dans la sortie dès qu'elle est générée.
+     */
+    void beginAssembly(std::stringstream &assembly) const override
+    {
+        m_symbolTables.clear();
+        m_symbolTables.push_back({}); // Scope global
+        m_stackOffset = 0;
+        m_hasExitStmt = false;
+        m_constantArrays = 0;
+        m_lineMarks.clear();
+        m_parameters.clear();
+        m_sections.assign(1, "section .text");
+
+        // align dans le code : des nop longs plutôt qu'une suite de nop d'un octet
+        assembly << "%use smartalign\n";
+
+        if (m_options.runtime.sharedLibrary)
+        {
+            // Bibliothèque partagée : le point d'entrée suit l'ABI System V. Le code généré
+            // utilise rbx et r12-r15, préservés pour l'appelant ; yb_rt_exit les restaure.
+            // Les six arguments passés par registre sont rangés au-dessus du cadre, à côté de
+            // ceux passés sur la pile, pour les instructions param (voir parameterOperand).
+            assembly << "global " << m_options.entryName << ":function\n";
+            assembly << "section .text\n";
+            assembly << m_options.entryName << ":\n";
+            assembly << "    push rbx\n";
+            assembly << "    push r12\n";
+            assembly << "    push r13\n";
+            assembly << "    push r14\n";
+            assembly << "    push r15\n";
+            assembly << "    push r9\n";
+            assembly << "    push r8\n";
+            assembly << "    push rcx\n";
+            assembly << "    push rdx\n";
+            assembly << "    push rsi\n";
+            assembly << "    push rdi\n";
+        }
+        else
+        {
+            assembly << "global _start\n";
+            assembly << "section .text\n";
+            assembly << "_start:\n";
+        }
 
         // Initialisation de la base de pile
         assembly << "    push rbp\n";
         assembly << "    mov rbp, rsp\n";
 
-        // Parcourir toutes les instructions du programme
-        for (const auto &stmt : m_program.statements)
+        if (m_options.faultHandler)
         {
-            switch (stmt->getType())
-            {
-            case StmtType::EXIT:
-                generateExitCode(dynamic_cast<ExitStmt *>(stmt.get()), assembly, symbolTables);
-                hasExitStmt = true;
-                break;
-            case StmtType::LET:
-                generateLetCode(dynamic_cast<LetStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
-                break;
-            case StmtType::BLOCK:
-                generateBlockCode(dynamic_cast<BlockStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
-                break;
-            case StmtType::IF:
-                generateIfCode(dynamic_cast<IfStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
-                break;
-            case StmtType::WHILE:
-                generateWhileCode(dynamic_cast<WhileStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
-                break;
-            case StmtType::PRINT:
-                generatePrintCode(dynamic_cast<PrintStmt *>(stmt.get()), assembly, symbolTables);
-                break;
-            case StmtType::ARRAY_ASSIGN:
-                generateAssignCode(dynamic_cast<AssignStmt *>(stmt.get()), assembly, symbolTables);
-                break;
+            m_runtime.require(RuntimeRoutine::FAULT_HANDLER);
+            markSourceLine(0, assembly); // Début du code, origine de la table des lignes
+            assembly << "    call yb_rt_fault_init\n";
+        }
+    }
 
-            default:
-                assembly << "    ; Instruction non supportée\n";
-                break;
-            }
+    /**
+     * @brief Génération incrémentale : émet le code d'une instruction de premier niveau
+     */
+    void generateStatement(const std::shared_ptr<Stmt> &stmt, std::stringstream &assembly) const override
+    {
+        // --stats repère les constructions par position dans le flux : le code reste dans l'ordre d'émission
+        if (m_options.schedule && !m_stats.enabled())
+        {
+            std::stringstream code;
+            emitStatement(stmt, code);
+            assembly << Scheduler().run(code.str());
         }
+        else
+            emitStatement(stmt, assembly);
+    }
 
+    /**
+     * @brief Génération incrémentale : émet la sortie par défaut et le runtime
+     */
+    void finishAssembly(std::stringstream &assembly) const override
+    {
         // Ajouter une sortie par défaut seulement si aucun exit n'est présent
-        if (!hasExitStmt)
+        if (!m_hasExitStmt)
         {
-            assembly << "    mov rax, 60\n";
-            assembly << "    mov rdi, 0\n";
-            assembly << "    syscall\n";
+            m_runtime.require(RuntimeRoutine::EXIT);
+            assembly << "    xor eax, eax\n";
+            assembly << "    jmp yb_rt_exit\n";
         }
 
-        return assembly.str();
+        // Le runtime partagé n'est émis qu'une fois, avec uniquement les routines utilisées
+        ConstructScope scope(m_stats, CodeConstruct::RUNTIME, assembly);
+        if (m_options.faultHandler)
+            markSourceLine(0, assembly); // Fin du code du programme
+        m_runtime.emit(assembly);
+        if (m_options.faultHandler)
+            RuntimeEmitter::emitLineTable(assembly, m_lineMarks);
+        if (m_options.runtime.sharedLibrary)
+            assembly << "section .note.GNU-stack noalloc noexec nowrite progbits\n"; // Pile non exécutable
+    }
+
+    /**
+     * @brief Paramètres du noyau (instructions param), dans l'ordre des arguments
+     */
+    const std::vector<KernelParameter> &parameters() const
+    {
+        return m_parameters;
+    }
+
+    /**
+     * @brief Statistiques du dernier code généré (options.stats doit être activé)
+     */
+    const CodeStats &codeStats() const
+    {
+        return m_codeStats;
     }
 
 private:
+    /**
+     * @brief Émet le code d'une instruction de premier niveau, dans l'ordre du parcours
+     */
+    void emitStatement(const std::shared_ptr<Stmt> &stmt, std::stringstream &assembly) const
+    {
+        auto &symbolTables = m_symbolTables;
+        int &stackOffset = m_stackOffset;
+
+        long statementBegin = m_stats.enabled() ? static_cast<long>(assembly.tellp()) : 0;
+        markSourceLine(stmt->line, assembly);
+        switch (stmt->getType())
+        {
+        case StmtType::EXIT:
+            generateExitCode(dynamic_cast<ExitStmt *>(stmt.get()), assembly, symbolTables);
+            m_hasExitStmt = true;
+            break;
+        case StmtType::LET:
+            generateLetCode(dynamic_cast<LetStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
+            break;
+        case StmtType::BLOCK:
+            generateBlockCode(dynamic_cast<BlockStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
+            break;
+        case StmtType::IF:
+            generateIfCode(dynamic_cast<IfStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
+            break;
+        case StmtType::WHILE:
+            generateWhileCode(dynamic_cast<WhileStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
+            break;
+        case StmtType::MATCH:
+            generateMatchCode(static_cast<const MatchStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
+            break;
+        case StmtType::PRINT:
+            generatePrintCode(dynamic_cast<PrintStmt *>(stmt.get()), assembly, symbolTables);
+            break;
+        case StmtType::ASSIGN:
+            generateAssignCode(dynamic_cast<AssignStmt *>(stmt.get()), assembly, symbolTables);
+            break;
+        case StmtType::ARRAY_ASSIGN:
+            generateArrayAssignCode(static_cast<const ArrayAssignStmt *>(stmt.get()), assembly, symbolTables);
+            break;
+        case StmtType::MATRIX_ASSIGN:
+            generateMatrixAssignCode(static_cast<const MatrixAssignStmt *>(stmt.get()), assembly, symbolTables);
+            break;
+        case StmtType::PARAM:
+            generateParamCode(static_cast<const ParamStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
+            break;
+
+        default:
+            assembly << "    ; Instruction non supportée\n";
+            break;
+        }
+        if (m_stats.enabled())
+            m_stats.statement(*stmt, statementBegin, static_cast<long>(assembly.tellp()));
+    }
+
     /**
      * @brief Recherche une variable dans tous les scopes disponibles
      * @param varName Nom de la variable à rechercher
@@ -109,6 +271,18 @@ private:
         return std::nullopt;
     }
 
+    /**
+     * @brief Opérande désignant une variable : son registre si elle est promue par la
+     * boucle en cours (voir promoteLoopVariables), sinon son emplacement de pile
+     */
+    std::string variableOperand(int offset) const
+    {
+        auto promoted = m_promotedSlots.find(offset);
+        if (promoted != m_promotedSlots.end())
+            return promoted->second;
+        return "[rbp-" + std::to_string(offset) + "]";
+    }
+
     /**
      * @brief Génère le code assembleur pour évaluer une expression
      * @param expr Expression à évaluer
@@ -147,8 +321,7 @@ private:
 
                 if (offsetOpt.has_value())
                 {
-                    int offset = offsetOpt.value();
-                    assembly << "    mov rax, [rbp-" << offset << "]\n";
+                    assembly << "    mov rax, " << variableOperand(offsetOpt.value()) << "\n";
                 }
                 else
                 {
@@ -163,6 +336,8 @@ private:
             auto binExpr = dynamic_cast<BinaryExpr *>(expr.get());
             if (binExpr)
             {
+                ConstructScope scope(m_stats, CodeConstruct::BINARY, assembly);
+
                 // Parcour de l'arbre
                 generateExpressionCode(binExpr->droite, assembly, symbolTables);
                 assembly << "    push rax\n"; // Sauvegarder le résultat
@@ -176,22 +351,25 @@ private:
                 {
                 case BinaryOpType::ADD:
                     assembly << "    add rax, rbx\n";
+                    generateOverflowCheck(binExpr, assembly);
                     break;
                 case BinaryOpType::MUL:
                     assembly << "    imul rax, rbx\n";
+                    generateOverflowCheck(binExpr, assembly);
                     break;
                 case BinaryOpType::SUB:
                     assembly << "    sub rax, rbx\n";
+                    generateOverflowCheck(binExpr, assembly);
                     break;
                 case BinaryOpType::DIV:
                     assembly << "    mov rcx, rbx\n"; // Sauvegarder le diviseur dans rcx
-                    assembly << "    xor rdx, rdx\n"; // Mettre à zéro la partie haute du dividende
-                    assembly << "    div rcx\n";      // Diviser par rcx, résultat dans rax
+                    assembly << "    cqo\n";          // Étendre le signe du dividende dans rdx
+                    assembly << "    idiv rcx\n";     // Division signée par rcx, résultat dans rax
                     break;
                 case BinaryOpType::MOD:
                     assembly << "    mov rcx, rbx\n"; // Sauvegarder le diviseur dans rcx
-                    assembly << "    xor rdx, rdx\n"; // Mettre à zéro la partie haute du dividende
-                    assembly << "    div rcx\n";      // Diviser par rcx, quotient dans rax, reste dans rdx
+                    assembly << "    cqo\n";          // Étendre le signe du dividende dans rdx
+                    assembly << "    idiv rcx\n";     // Division signée, quotient dans rax, reste dans rdx
                     assembly << "    mov rax, rdx\n"; // Copier le reste (modulo) dans rax
                     break;
                 case BinaryOpType::EQUAL:
@@ -237,32 +415,28 @@ private:
         case ExprType::ARRAY:
         {
             const ArrayExpr *arrayExpr = static_cast<const ArrayExpr *>(expr.get());
+            ConstructScope scope(m_stats, CodeConstruct::ARRAY_LITERAL, assembly);
             size_t size = arrayExpr->elements.size();
 
-            // Allouer mémoire pour (taille + éléments)
-            assembly << "    mov rax, 9\n";
-            assembly << "    mov rdi, 0\n";
-            assembly << "    mov rsi, " << (size + 1) * 8 << "\n"; // +1 pour la taille
-            assembly << "    mov rdx, 3\n";
-            assembly << "    mov r10, 34\n";
-            assembly << "    mov r8, -1\n";
-            assembly << "    mov r9, 0\n";
-            assembly << "    syscall\n";
+            // Allouer mémoire pour (taille + éléments), la taille est stockée par le runtime
+            m_runtime.require(RuntimeRoutine::ALLOC_ARRAY);
+            assembly << "    mov rax, " << size << "\n";
+            assembly << "    call yb_rt_alloc_array\n";
 
-            assembly << "    push rax\n";
+            if (size >= 2 && isConstantArray(arrayExpr))
+            {
+                generateConstantArrayCopy(arrayExpr, assembly);
+                break;
+            }
 
-            // Stocker la taille en premier
-            assembly << "    mov rbx, [rsp]\n";
-            assembly << "    mov qword [rbx], " << size << "\n";
+            assembly << "    push rax\n";
 
-            // Initialiser les éléments, en commençant à l'offset +8
+            // Initialiser les éléments, rax pointe sur l'élément 0
             for (size_t i = 0; i < size; i++)
             {
-                assembly << "    mov rbx, [rsp]\n";
-                assembly << "    push rbx\n";
                 generateExpressionCode(arrayExpr->elements[i], assembly, symbolTables);
-                assembly << "    pop rbx\n";
-                assembly << "    mov [rbx + " << (i + 1) * 8 << "], rax\n"; // Notez le i+1
+                assembly << "    mov rbx, [rsp]\n";
+                assembly << "    mov [rbx + " << i * 8 << "], rax\n";
             }
 
             assembly << "    pop rax\n";
@@ -272,6 +446,7 @@ private:
         case ExprType::ARRAY_ACCESS:
         {
             const ArrayAccessExpr *accessExpr = static_cast<const ArrayAccessExpr *>(expr.get());
+            ConstructScope scope(m_stats, CodeConstruct::ARRAY_ACCESS, assembly);
 
             // Générer le code pour l'expression du tableau (adresse dans rax)
             generateExpressionCode(accessExpr->array, assembly, symbolTables);
@@ -279,24 +454,45 @@ private:
 
             generateExpressionCode(accessExpr->index, assembly, symbolTables);
 
-            assembly << "    add rax, 1\n";
-
-            assembly << "    imul rax, 8\n";
-
-            assembly << "    pop rbx\n";        // Récupérer l'adresse du tableau
-            assembly << "    add rbx, rax\n";   // Calculer l'adresse de l'élément
-            assembly << "    mov rax, [rbx]\n"; // Charger la valeur
+            assembly << "    pop rbx\n"; // Récupérer l'adresse du tableau
+            generateBoundsCheck(assembly);
+            assembly << "    mov rax, [rbx + rax*8]\n"; // Charger la valeur
             break;
         }
         case ExprType::LENGTH:
         {
             const LengthExpr *lengthExpr = static_cast<const LengthExpr *>(expr.get());
+            ConstructScope scope(m_stats, CodeConstruct::LENGTH, assembly);
 
             // Générer le code pour obtenir l'adresse du tableau
             generateExpressionCode(lengthExpr->array, assembly, symbolTables);
 
-            // La taille est stockée dans le premier mot
-            assembly << "    mov rax, [rax]\n";
+            // La taille est stockée dans le mot qui précède l'élément 0
+            assembly << "    mov rax, [rax-8]\n";
+            break;
+        }
+        case ExprType::MATRIX:
+        {
+            const MatrixExpr *matrixExpr = static_cast<const MatrixExpr *>(expr.get());
+            ConstructScope scope(m_stats, CodeConstruct::MATRIX, assembly);
+
+            generateExpressionCode(matrixExpr->cols, assembly, symbolTables);
+            assembly << "    push rax\n";
+            generateExpressionCode(matrixExpr->rows, assembly, symbolTables);
+            assembly << "    pop rbx\n";
+
+            m_runtime.require(RuntimeRoutine::ALLOC_MATRIX);
+            assembly << "    call yb_rt_alloc_matrix\n";
+            break;
+        }
+        case ExprType::MATRIX_ACCESS:
+        {
+            const MatrixAccessExpr *accessExpr = static_cast<const MatrixAccessExpr *>(expr.get());
+            ConstructScope scope(m_stats, CodeConstruct::MATRIX, assembly);
+
+            generateMatrixElementAddress(accessExpr, accessExpr->matrix, accessExpr->row, accessExpr->col,
+                                         assembly, symbolTables);
+            assembly << "    mov rax, [rbx]\n";
             break;
         }
         }
@@ -309,19 +505,21 @@ private:
     generateExitCode(const ExitStmt *exitStmt, std::stringstream &assembly,
                      const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
     {
+        ConstructScope scope(m_stats, CodeConstruct::EXIT, assembly);
+
         // Traiter l'expression
         if (exitStmt && exitStmt->expr)
         {
             generateExpressionCode(exitStmt->expr, assembly, symbolTables);
-            assembly << "    mov rdi, rax\n";
         }
         else
         {
-            assembly << "    mov rdi, 0\n"; // Code d'erreur par défaut
+            assembly << "    mov rax, 0\n"; // Code d'erreur par défaut
         }
 
-        assembly << "    mov rax, 60\n"; // syscall exit
-        assembly << "    syscall\n";
+        // yb_rt_exit vide le tampon de sortie avant le syscall exit
+        m_runtime.require(RuntimeRoutine::EXIT);
+        assembly << "    jmp yb_rt_exit\n";
     }
 
     /**
@@ -333,6 +531,7 @@ private:
     {
         if (letStmt && letStmt->expr && letStmt->var.value)
         {
+            ConstructScope scope(m_stats, CodeConstruct::STORE, assembly);
             std::string varName = *letStmt->var.value;
 
             // Évaluer l'expression et mettre le résultat dans rax
@@ -351,8 +550,59 @@ private:
 
             // Stocker la valeur sur la pile
             int offset = currentScope[varName];
-            assembly << "    mov [rbp-" << offset << "], rax\n";
+            assembly << "    mov " << variableOperand(offset) << ", rax\n";
+        }
+    }
+
+    /**
+     * @brief Génère le code pour une instruction param (premier niveau uniquement)
+     *
+     * La variable est initialisée avec l'argument suivant du point d'entrée.
+     */
+    void generateParamCode(const ParamStmt *paramStmt, std::stringstream &assembly,
+                           std::vector<std::unordered_map<std::string, int>> &symbolTables,
+                           int &stackOffset) const
+    {
+        ConstructScope scope(m_stats, CodeConstruct::STORE, assembly);
+        const std::string &varName = *paramStmt->var.value;
+        assembly << "    mov rax, " << parameterOperand(m_parameters.size()) << "\n";
+        m_parameters.push_back({varName, paramStmt->array});
+
+        auto &currentScope = symbolTables.back();
+        if (currentScope.find(varName) == currentScope.end())
+        {
+            stackOffset += 8;
+            currentScope[varName] = stackOffset;
+            assembly << "    sub rsp, 8\n";
         }
+        assembly << "    mov " << variableOperand(currentScope[varName]) << ", rax\n";
+    }
+
+    /**
+     * @brief Emplacement de l'argument `index` du point d'entrée
+     *
+     * Au-dessus de rbp : rdi..r9 rangés par le prologue, puis r15..rbx, l'adresse de
+     * retour et les arguments passés sur la pile.
+     */
+    static std::string parameterOperand(size_t index)
+    {
+        size_t offset = index < 6 ? 8 + 8 * index : 104 + 8 * (index - 6);
+        return "[rbp+" + std::to_string(offset) + "]";
+    }
+
+    /**
+     * @brief Pose un repère de ligne pour le gestionnaire de fautes (option faultHandler)
+     * @param line Ligne du source du code qui suit, 0 hors des instructions
+     *
+     * Le code est émis dans l'ordre des adresses : une faute appartient à la ligne du
+     * dernier repère qui la précède. Un repère n'est posé que si la ligne change.
+     */
+    void markSourceLine(int line, std::stringstream &assembly) const
+    {
+        if (!m_options.faultHandler || (!m_lineMarks.empty() && m_lineMarks.back() == line))
+            return;
+        assembly << RuntimeEmitter::lineLabel(m_lineMarks.size()) << ":\n";
+        m_lineMarks.push_back(line);
     }
 
     /**
@@ -362,6 +612,8 @@ private:
                            std::vector<std::unordered_map<std::string, int>> &symbolTables,
                            int &stackOffset) const
     {
+        ConstructScope scope(m_stats, CodeConstruct::BLOCK, assembly);
+
         // Marquer le début du bloc avec un commentaire
         assembly << "    ; Début de bloc\n";
 
@@ -372,6 +624,7 @@ private:
         // Générer le code pour chaque instruction dans le bloc ici Copier coller du parcours dans le programme
         for (const auto &stmt : blockStmt->statements)
         {
+            markSourceLine(stmt->line, assembly);
             switch (stmt->getType())
             {
             case StmtType::EXIT:
@@ -389,6 +642,9 @@ private:
             case StmtType::WHILE:
                 generateWhileCode(dynamic_cast<WhileStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
                 break;
+            case StmtType::MATCH:
+                generateMatchCode(static_cast<const MatchStmt *>(stmt.get()), assembly, symbolTables, stackOffset);
+                break;
             case StmtType::ASSIGN:
                 generateAssignCode(dynamic_cast<AssignStmt *>(stmt.get()), assembly, symbolTables);
                 break;
@@ -398,6 +654,12 @@ private:
             case StmtType::ARRAY_ASSIGN:
                 generateArrayAssignCode(static_cast<const ArrayAssignStmt *>(stmt.get()), assembly, symbolTables);
                 break;
+            case StmtType::MATRIX_ASSIGN:
+                generateMatrixAssignCode(static_cast<const MatrixAssignStmt *>(stmt.get()), assembly, symbolTables);
+                break;
+            case StmtType::PARAM:
+                assert(false && "le Parser n'accepte param qu'au premier niveau");
+                break;
             }
         }
 
@@ -428,34 +690,73 @@ private:
         // Générer un label unique pour le saut
         static int labelCounter = 0;
         std::string elseLabel = ".if_else_" + std::to_string(labelCounter);
+        std::string coldLabel = ".if_cold_" + std::to_string(labelCounter);
         std::string endLabel = ".if_end_" + std::to_string(labelCounter++);
 
-        assembly << "    ; Début du if\n";
+        // Une branche qui se termine par exit n'est exécutée qu'une fois : elle part dans
+        // .text.cold pour que le code chaud reste contigu. La table des lignes de
+        // --fault-handler suppose des repères dans l'ordre des adresses d'une seule section.
+        // Dans du code déjà froid, la branche serait placée à la suite du saut qui l'évite :
+        // elle reste en ligne.
+        bool canGoCold = !m_options.faultHandler && m_sections.back() != RuntimeEmitter::COLD_SECTION;
+        bool coldThen = canGoCold && endsWithExit(ifStmt->thenBranch.get()) &&
+                        !endsWithExit(ifStmt->elseBranch.get());
+        bool coldElse = canGoCold && ifStmt->elseBranch && endsWithExit(ifStmt->elseBranch.get()) &&
+                        !coldThen && !endsWithExit(ifStmt->thenBranch.get());
 
-        // Évaluer la condition
-        generateExpressionCode(ifStmt->condition, assembly, symbolTables);
+        assembly << "    ; Début du if\n";
 
-        assembly << "    cmp rax, 0\n";
-        if (ifStmt->elseBranch)
         {
-            assembly << "    je " << elseLabel << "\n";
+            ConstructScope scope(m_stats, CodeConstruct::IF_CONDITION, assembly);
+
+            // Évaluer la condition
+            generateExpressionCode(ifStmt->condition, assembly, symbolTables);
+
+            assembly << "    cmp rax, 0\n";
+            if (coldThen)
+            {
+                assembly << "    jne " << coldLabel << "\n";
+            }
+            else if (ifStmt->elseBranch)
+            {
+                assembly << "    je " << elseLabel << "\n";
+            }
+            else
+            {
+                assembly << "    je " << endLabel << "\n";
+            }
         }
-        else
+
+        if (coldThen)
         {
-            assembly << "    je " << endLabel << "\n";
+            // Le bloc then, sans retour (exit), puis le else éventuel sur le chemin chaud
+            pushSection(RuntimeEmitter::COLD_SECTION, assembly);
+            assembly << coldLabel << ":\n";
+            generateBlockCode(ifStmt->thenBranch.get(), assembly, symbolTables, stackOffset);
+            popSection(assembly);
+            if (ifStmt->elseBranch)
+                generateBlockCode(ifStmt->elseBranch.get(), assembly, symbolTables, stackOffset);
+            assembly << endLabel << ":\n";
+            assembly << "    ; Fin du if\n";
+            return;
         }
 
         generateBlockCode(ifStmt->thenBranch.get(), assembly, symbolTables, stackOffset);
 
-        if (ifStmt->elseBranch)
+        if (ifStmt->elseBranch && !coldElse)
         {
-            assembly << "    jmp " << elseLabel << "\n";
+            ConstructScope scope(m_stats, CodeConstruct::IF_CONDITION, assembly);
+            assembly << "    jmp " << endLabel << "\n"; // Ne pas exécuter le bloc else
         }
         // Le Bloc else
         if (ifStmt->elseBranch)
         {
+            if (coldElse)
+                pushSection(RuntimeEmitter::COLD_SECTION, assembly);
             assembly << elseLabel << ":\n";
             generateBlockCode(ifStmt->elseBranch.get(), assembly, symbolTables, stackOffset);
+            if (coldElse)
+                popSection(assembly);
         }
 
         // Label pour la fin du if
@@ -463,6 +764,220 @@ private:
         assembly << "    ; Fin du if\n";
     }
 
+    /**
+     * @brief Passe dans une autre section (code froid, .rodata)
+     *
+     * popSection revient ensuite à la section englobante, qui peut elle-même être
+     * .text.cold : un tableau constant d'une branche froide ne renvoie pas la suite de la
+     * branche dans .text.
+     */
+    void pushSection(const std::string &directive, std::stringstream &assembly) const
+    {
+        m_sections.push_back(directive);
+        assembly << directive << "\n";
+    }
+
+    /**
+     * @brief Revient à la section active avant le dernier pushSection
+     */
+    void popSection(std::stringstream &assembly) const
+    {
+        m_sections.pop_back();
+        assembly << m_sections.back() << "\n";
+    }
+
+    /**
+     * @brief Vrai si l'exécution de l'instruction se termine toujours par un exit
+     */
+    static bool endsWithExit(const Stmt *stmt)
+    {
+        if (!stmt)
+            return false;
+        switch (stmt->getType())
+        {
+        case StmtType::EXIT:
+            return true;
+        case StmtType::BLOCK:
+        {
+            const auto &statements = static_cast<const BlockStmt *>(stmt)->statements;
+            return !statements.empty() && endsWithExit(statements.back().get());
+        }
+        case StmtType::IF:
+        {
+            const auto *ifStmt = static_cast<const IfStmt *>(stmt);
+            return endsWithExit(ifStmt->thenBranch.get()) && endsWithExit(ifStmt->elseBranch.get());
+        }
+        case StmtType::MATCH:
+        {
+            const auto *matchStmt = static_cast<const MatchStmt *>(stmt);
+            for (const MatchArm &arm : matchStmt->arms)
+                if (!endsWithExit(arm.body.get()))
+                    return false;
+            return endsWithExit(matchStmt->defaultBranch.get());
+        }
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Génère le code pour une instruction match
+     *
+     * La valeur est calculée une fois dans rax. L'aiguillage dépend de la répartition des
+     * valeurs des branches :
+     * - denses (au moins MATCH_TABLE_MIN_CASES valeurs, intervalle d'au plus 3 fois leur
+     *   nombre) : table de sauts relative, placée dans le code après le jmp rax ;
+     * - intervalle de 64 valeurs au plus et 3 branches au plus : un masque par branche et bt ;
+     * - sinon : recherche dichotomique sur les valeurs triées, comparaisons successives
+     *   pour les feuilles de 3 valeurs ou moins.
+     */
+    void generateMatchCode(const MatchStmt *matchStmt, std::stringstream &assembly,
+                           std::vector<std::unordered_map<std::string, int>> &symbolTables,
+                           int &stackOffset) const
+    {
+        static constexpr size_t MATCH_TABLE_MIN_CASES = 4;
+        static constexpr unsigned long long MATCH_TABLE_MAX_ENTRIES = 1024;
+
+        if (!matchStmt || !matchStmt->subject)
+            return;
+
+        static int labelCounter = 0;
+        std::string prefix = ".match_" + std::to_string(labelCounter++) + "_";
+        std::string endLabel = prefix + "end";
+        std::string defaultLabel = matchStmt->defaultBranch ? prefix + "default" : endLabel;
+        auto armLabel = [&](size_t arm)
+        { return prefix + "case_" + std::to_string(arm); };
+
+        // Couples (valeur, branche) triés par valeur
+        const auto &arms = matchStmt->arms;
+        std::vector<std::pair<long long, size_t>> cases;
+        for (size_t arm = 0; arm < arms.size(); arm++)
+            for (long long value : arms[arm].values)
+                cases.push_back({value, arm});
+        std::sort(cases.begin(), cases.end());
+
+        // cmp et sub n'acceptent qu'un immédiat 32 bits étendu
+        auto withImmediate = [&](const char *op, long long value)
+        {
+            if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max())
+                assembly << "    " << op << " rax, " << value << "\n";
+            else
+                assembly << "    mov rbx, " << value << "\n"
+                         << "    " << op << " rax, rbx\n";
+        };
+
+        assembly << "    ; Début du match\n";
+        {
+            ConstructScope scope(m_stats, CodeConstruct::MATCH, assembly);
+            generateExpressionCode(matchStmt->subject, assembly, symbolTables);
+
+            // Écart entre la plus grande et la plus petite valeur, sans débordement
+            unsigned long long span = cases.empty() ? 0
+                                                    : static_cast<unsigned long long>(cases.back().first) -
+                                                          static_cast<unsigned long long>(cases.front().first);
+            std::vector<size_t> usedArms;
+            for (const auto &[value, arm] : cases)
+                if (std::find(usedArms.begin(), usedArms.end(), arm) == usedArms.end())
+                    usedArms.push_back(arm);
+
+            if (cases.empty())
+            {
+                assembly << "    jmp " << defaultLabel << "\n";
+            }
+            else if (cases.size() >= MATCH_TABLE_MIN_CASES && span < 3 * cases.size() && span < MATCH_TABLE_MAX_ENTRIES)
+            {
+                // rax - min, comparé sans signe : les valeurs sous le minimum passent au-dessus de span
+                std::string tableLabel = prefix + "table";
+                if (cases.front().first != 0)
+                    withImmediate("sub", cases.front().first);
+                assembly << "    cmp rax, " << span << "\n"
+                         << "    ja " << defaultLabel << "\n"
+                         << "    lea rbx, [rel " << tableLabel << "]\n"
+                         << "    movsxd rax, dword [rbx + rax*4]\n"
+                         << "    add rax, rbx\n"
+                         << "    jmp rax\n"
+                         << "align 4\n"
+                         << tableLabel << ":\n";
+                size_t next = 0;
+                for (unsigned long long offset = 0; offset <= span; offset++)
+                {
+                    std::string target = defaultLabel;
+                    if (static_cast<unsigned long long>(cases[next].first) -
+                            static_cast<unsigned long long>(cases.front().first) ==
+                        offset)
+                        target = armLabel(cases[next++].second);
+                    assembly << "dd " << target << " - " << tableLabel << "\n";
+                }
+            }
+            else if (span < 64 && usedArms.size() <= 3)
+            {
+                if (cases.front().first != 0)
+                    withImmediate("sub", cases.front().first);
+                assembly << "    cmp rax, " << span << "\n"
+                         << "    ja " << defaultLabel << "\n";
+                for (size_t arm : usedArms)
+                {
+                    unsigned long long mask = 0;
+                    for (const auto &[value, valueArm] : cases)
+                        if (valueArm == arm)
+                            mask |= 1ULL << (static_cast<unsigned long long>(value) -
+                                             static_cast<unsigned long long>(cases.front().first));
+                    assembly << "    mov rbx, 0x" << std::hex << mask << std::dec << "\n"
+                             << "    bt rbx, rax\n"
+                             << "    jc " << armLabel(arm) << "\n";
+                }
+                assembly << "    jmp " << defaultLabel << "\n";
+            }
+            else
+            {
+                int upperCounter = 0;
+                auto search = [&](auto &self, size_t low, size_t high) -> void
+                {
+                    if (high - low <= 3)
+                    {
+                        for (size_t i = low; i < high; i++)
+                        {
+                            withImmediate("cmp", cases[i].first);
+                            assembly << "    je " << armLabel(cases[i].second) << "\n";
+                        }
+                        assembly << "    jmp " << defaultLabel << "\n";
+                        return;
+                    }
+                    size_t middle = low + (high - low) / 2;
+                    std::string upperLabel = prefix + "upper_" + std::to_string(upperCounter++);
+                    withImmediate("cmp", cases[middle].first);
+                    assembly << "    je " << armLabel(cases[middle].second) << "\n"
+                             << "    jg " << upperLabel << "\n";
+                    self(self, low, middle);
+                    assembly << upperLabel << ":\n";
+                    self(self, middle + 1, high);
+                };
+                search(search, 0, cases.size());
+            }
+        }
+
+        // Les branches, dans l'ordre du source ; chacune rejoint la fin du match
+        for (size_t arm = 0; arm < arms.size(); arm++)
+        {
+            assembly << armLabel(arm) << ":\n";
+            generateBlockCode(arms[arm].body.get(), assembly, symbolTables, stackOffset);
+            bool last = arm + 1 == arms.size() && !matchStmt->defaultBranch;
+            if (!last && !endsWithExit(arms[arm].body.get()))
+            {
+                ConstructScope scope(m_stats, CodeConstruct::MATCH, assembly);
+                assembly << "    jmp " << endLabel << "\n";
+            }
+        }
+        if (matchStmt->defaultBranch)
+        {
+            assembly << defaultLabel << ":\n";
+            generateBlockCode(matchStmt->defaultBranch.get(), assembly, symbolTables, stackOffset);
+        }
+
+        assembly << endLabel << ":\n";
+        assembly << "    ; Fin du match\n";
+    }
+
     /**
      * @brief Génère le code pour une instruction while
      */
@@ -478,128 +993,1047 @@ private:
         std::string startLabel = ".while_start_" + std::to_string(labelCounter);
         std::string endLabel = ".while_end_" + std::to_string(labelCounter++);
 
-        assembly << startLabel << ":\n";
+        int hoistedBytes;
+        std::vector<const void *> hoistedNodes;
+        std::vector<PromotedVariable> promoted;
+        std::vector<const void *> safeCounters;
+        if (m_options.checkedArithmetic)
+        {
+            collectSafeCounters(whileStmt, safeCounters);
+            m_uncheckedNodes.insert(safeCounters.begin(), safeCounters.end());
+        }
+        {
+            ConstructScope scope(m_stats, CodeConstruct::LOOP_HEADER, assembly);
+
+            // Les adresses de ligne des accès m[i][j] invariants sont calculées avant la boucle
+            hoistedBytes = hoistMatrixRows(whileStmt, assembly, symbolTables, stackOffset, hoistedNodes);
+
+            // Les variables les plus utilisées d'une boucle interne passent dans des registres
+            if (m_options.promoteLoopVariables)
+                promoted = promoteLoopVariables(whileStmt, assembly, symbolTables);
 
-        // Évaluer la condition
-        generateExpressionCode(whileStmt->condition, assembly, symbolTables);
+            // Tête de boucle alignée : le corps commence sur une ligne de cache d'instructions
+            assembly << "align 16\n";
+            assembly << startLabel << ":\n";
 
-        assembly << "    cmp rax, 0\n";
-        assembly << "    je " << endLabel << "\n"; // un jump de kungoru si la condition est fausse
+            // Évaluer la condition
+            generateExpressionCode(whileStmt->condition, assembly, symbolTables);
+
+            assembly << "    cmp rax, 0\n";
+            assembly << "    je " << endLabel << "\n"; // un jump de kungoru si la condition est fausse
+        }
 
         // Générer le corps de la boucle
         generateBlockCode(whileStmt->body.get(), assembly, symbolTables, stackOffset);
 
+        // Les nœuds peuvent être libérés après la génération (mode --stream) : leurs adresses
+        // ne doivent plus désigner ces emplacements
+        for (const void *node : hoistedNodes)
+            m_hoistedRows.erase(node);
+        for (const void *node : safeCounters)
+            m_uncheckedNodes.erase(node);
+
+        ConstructScope scope(m_stats, CodeConstruct::LOOP_HEADER, assembly);
+
         // Retourner au début de la boucle
         assembly << "    jmp " << startLabel << "\n";
 
         // Label pour la fin de la boucle
         assembly << endLabel << ":\n";
+
+        // Seule sortie de la boucle : les variables modifiées retournent dans leur emplacement
+        for (const auto &variable : promoted)
+        {
+            if (variable.written)
+                assembly << "    mov [rbp-" << variable.offset << "], " << variable.reg << "\n";
+            m_promotedSlots.erase(variable.offset);
+        }
+
+        if (hoistedBytes > 0)
+        {
+            assembly << "    add rsp, " << hoistedBytes << "\n";
+            stackOffset -= hoistedBytes;
+        }
     }
 
     /**
-     * @brief Génère le code assembleur pour une assignation de variable
+     * @brief Intervalle des valeurs possibles d'une expression (analyse de --checked-arith)
+     *
+     * Les bornes sont calculées sur 128 bits : une opération dont l'intervalle exact
+     * tient dans un int64 ne peut pas déborder.
      */
-    void generateAssignCode(const AssignStmt *assignStmt, std::stringstream &assembly,
-                            const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
+    struct ValueRange
     {
-        if (!assignStmt || !assignStmt->expr)
-            return;
-
-        // Aller dora ou est la variable
-        std::string varName = *assignStmt->var.value; // le nom de la variable
-        int offset = -1;
+        __int128 low;
+        __int128 high;
 
-        // Chercher la variable dans toutes les tables de symboles (de la plus récente à la plus ancienne)
-        for (int i = symbolTables.size() - 1; i >= 0; i--)
+        bool fits() const
         {
-            if (symbolTables[i].find(varName) != symbolTables[i].end())
-            {
-                offset = symbolTables[i].at(varName);
-                break;
-            }
+            return low >= std::numeric_limits<long long>::min() && high <= std::numeric_limits<long long>::max();
         }
+    };
 
-        if (offset == -1)
-        {
-            std::cerr << "Erreur: Variable non déclarée PTN FAIT GAFFE NE REFFAIT PLUS JAMAIS CA !!!! : " << varName << std::endl;
-            return;
+    /**
+     * @brief Longueur maximale d'un tableau : yb_rt_alloc_matrix refuse 2^56 éléments ou plus,
+     * et un tableau littéral est bien plus petit
+     */
+    static constexpr long long MAX_ARRAY_LENGTH = (1LL << 56) - 1;
+
+    static ValueRange fullRange()
+    {
+        return {std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()};
+    }
+
+    /**
+     * @brief Intervalle exact du résultat d'une opération, avant troncature à 64 bits
+     */
+    ValueRange exactRange(const BinaryExpr *binExpr) const
+    {
+        ValueRange a = valueRange(binExpr->gauche);
+        ValueRange b = valueRange(binExpr->droite);
+        switch (binExpr->op)
+        {
+        case BinaryOpType::ADD:
+            return {a.low + b.low, a.high + b.high};
+        case BinaryOpType::SUB:
+            return {a.low - b.high, a.high - b.low};
+        case BinaryOpType::MUL:
+        {
+            __int128 products[] = {a.low * b.low, a.low * b.high, a.high * b.low, a.high * b.high};
+            return {*std::min_element(std::begin(products), std::end(products)),
+                    *std::max_element(std::begin(products), std::end(products))};
+        }
+        case BinaryOpType::EQUAL:
+        case BinaryOpType::NOT_EQUAL:
+        case BinaryOpType::GREAT:
+        case BinaryOpType::LESS:
+        case BinaryOpType::GREAT_EQUAL:
+        case BinaryOpType::LESS_EQUAL:
+            return {0, 1};
+        default:
+            return fullRange();
+        }
+    }
+
+    /**
+     * @brief Intervalle des valeurs d'une expression : littéraux, len() et opérations sur
+     * ceux-ci, les variables pouvant prendre n'importe quelle valeur
+     */
+    ValueRange valueRange(const std::shared_ptr<Expr> &expr) const
+    {
+        switch (expr->getType())
+        {
+        case ExprType::INTEGER:
+            try
+            {
+                long long value = std::stoll(*static_cast<const IntExpr *>(expr.get())->token.value);
+                return {value, value};
+            }
+            catch (const std::exception &)
+            {
+                return fullRange();
+            }
+        case ExprType::LENGTH:
+            return {0, MAX_ARRAY_LENGTH};
+        case ExprType::BINARY:
+        {
+            ValueRange range = exactRange(static_cast<const BinaryExpr *>(expr.get()));
+            return range.fits() ? range : fullRange();
+        }
+        default:
+            return fullRange();
+        }
+    }
+
+    /**
+     * @brief Émet le saut vers le trap de dépassement après add, sub ou imul (mode --checked-arith)
+     *
+     * Le saut n'est pas émis quand l'analyse d'intervalle prouve que l'opération ne peut
+     * pas déborder : opérandes constants ou len(), compteurs de boucle (voir collectSafeCounters).
+     */
+    void generateOverflowCheck(const BinaryExpr *binExpr, std::stringstream &assembly) const
+    {
+        if (!m_options.checkedArithmetic || m_uncheckedNodes.count(binExpr) || exactRange(binExpr).fits())
+            return;
+        m_runtime.require(RuntimeRoutine::OVERFLOW_TRAP);
+        assembly << "    jo yb_rt_overflow_trap\n";
+    }
+
+    /**
+     * @brief Compteurs de boucle dont l'incrément ne peut pas déborder
+     *
+     * Pour `while (i < borne) { ... i = i + c; ... }`, si i n'est modifié que par cette
+     * affectation, exécutée au plus une fois par tour (pas dans une boucle imbriquée), la
+     * condition vient d'assurer i < borne quand l'addition s'exécute : i + c ne déborde pas
+     * si borne - 1 + c tient dans un int64, ce qui est toujours vrai pour c = 1. Même
+     * raisonnement pour `i > borne` et `i = i - c`, et pour <= et >=. La comparaison peut
+     * faire partie d'une conjonction && dans la condition.
+     *
+     * @param safeNodes Reçoit les additions et soustractions des compteurs sûrs
+     */
+    void collectSafeCounters(const WhileStmt *whileStmt, std::vector<const void *> &safeNodes) const
+    {
+        std::vector<const BinaryExpr *> comparisons;
+        collectConjuncts(whileStmt->condition, comparisons);
+
+        for (const BinaryExpr *comparison : comparisons)
+        {
+            // Le compteur peut être de chaque côté : `borne > i` se lit `i < borne`
+            for (int side = 0; side < 2; side++)
+            {
+                const std::shared_ptr<Expr> &counter = side == 0 ? comparison->gauche : comparison->droite;
+                const std::shared_ptr<Expr> &bound = side == 0 ? comparison->droite : comparison->gauche;
+                if (counter->getType() != ExprType::VARIABLE)
+                    continue;
+                BinaryOpType op = side == 0 ? comparison->op : mirrored(comparison->op);
+                const std::string &name = *static_cast<const VarExpr *>(counter.get())->token.value;
+
+                std::vector<const AssignStmt *> assignments;
+                if (!collectCounterAssignments(whileStmt->body, name, false, assignments) || assignments.size() != 1)
+                    continue;
+
+                const BinaryExpr *step = counterStep(assignments[0]->expr, name);
+                if (!step)
+                    continue;
+                __int128 amount = valueRange(step->gauche->getType() == ExprType::INTEGER ? step->gauche : step->droite).low;
+                ValueRange limit = valueRange(bound);
+
+                bool safe = false;
+                if (step->op == BinaryOpType::ADD && op == BinaryOpType::LESS)
+                    safe = limit.high - 1 + amount <= std::numeric_limits<long long>::max();
+                else if (step->op == BinaryOpType::ADD && op == BinaryOpType::LESS_EQUAL)
+                    safe = limit.high + amount <= std::numeric_limits<long long>::max();
+                else if (step->op == BinaryOpType::SUB && op == BinaryOpType::GREAT)
+                    safe = limit.low + 1 - amount >= std::numeric_limits<long long>::min();
+                else if (step->op == BinaryOpType::SUB && op == BinaryOpType::GREAT_EQUAL)
+                    safe = limit.low - amount >= std::numeric_limits<long long>::min();
+                if (safe)
+                    safeNodes.push_back(step);
+            }
+        }
+    }
+
+    /**
+     * @brief Collecte les comparaisons d'une condition et de ses conjonctions &&
+     *
+     * && est un ET bit à bit : un résultat non nul implique que chaque opérande est non nul,
+     * donc que chaque comparaison est vraie.
+     */
+    void collectConjuncts(const std::shared_ptr<Expr> &expr, std::vector<const BinaryExpr *> &comparisons) const
+    {
+        if (!expr || expr->getType() != ExprType::BINARY)
+            return;
+        auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+        switch (binExpr->op)
+        {
+        case BinaryOpType::AND:
+            collectConjuncts(binExpr->gauche, comparisons);
+            collectConjuncts(binExpr->droite, comparisons);
+            break;
+        case BinaryOpType::LESS:
+        case BinaryOpType::LESS_EQUAL:
+        case BinaryOpType::GREAT:
+        case BinaryOpType::GREAT_EQUAL:
+            comparisons.push_back(binExpr);
+            break;
+        default:
+            break;
+        }
+    }
+
+    static BinaryOpType mirrored(BinaryOpType op)
+    {
+        switch (op)
+        {
+        case BinaryOpType::LESS:
+            return BinaryOpType::GREAT;
+        case BinaryOpType::GREAT:
+            return BinaryOpType::LESS;
+        case BinaryOpType::LESS_EQUAL:
+            return BinaryOpType::GREAT_EQUAL;
+        case BinaryOpType::GREAT_EQUAL:
+            return BinaryOpType::LESS_EQUAL;
+        default:
+            return op;
+        }
+    }
+
+    /**
+     * @brief Forme `i + c`, `c + i` ou `i - c` (c littéral) d'un incrément de compteur
+     */
+    const BinaryExpr *counterStep(const std::shared_ptr<Expr> &expr, const std::string &name) const
+    {
+        if (expr->getType() != ExprType::BINARY)
+            return nullptr;
+        auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+        auto isCounter = [&](const std::shared_ptr<Expr> &operand)
+        {
+            return operand->getType() == ExprType::VARIABLE &&
+                   *static_cast<const VarExpr *>(operand.get())->token.value == name;
+        };
+        auto isAmount = [&](const std::shared_ptr<Expr> &operand)
+        {
+            return operand->getType() == ExprType::INTEGER && valueRange(operand).fits() && valueRange(operand).low >= 0;
+        };
+
+        if (binExpr->op == BinaryOpType::ADD &&
+            ((isCounter(binExpr->gauche) && isAmount(binExpr->droite)) || (isAmount(binExpr->gauche) && isCounter(binExpr->droite))))
+            return binExpr;
+        if (binExpr->op == BinaryOpType::SUB && isCounter(binExpr->gauche) && isAmount(binExpr->droite))
+            return binExpr;
+        return nullptr;
+    }
+
+    /**
+     * @brief Collecte les affectations d'une variable dans le corps d'une boucle
+     * @return false si la variable est redéclarée, ou affectée dans une boucle imbriquée
+     */
+    bool collectCounterAssignments(const std::shared_ptr<Stmt> &stmt, const std::string &name, bool nested,
+                                   std::vector<const AssignStmt *> &assignments) const
+    {
+        if (!stmt)
+            return true;
+
+        switch (stmt->getType())
+        {
+        case StmtType::LET:
+            return *static_cast<const LetStmt *>(stmt.get())->var.value != name;
+        case StmtType::ASSIGN:
+        {
+            auto assignStmt = static_cast<const AssignStmt *>(stmt.get());
+            if (*assignStmt->var.value != name)
+                return true;
+            assignments.push_back(assignStmt);
+            return !nested;
+        }
+        case StmtType::BLOCK:
+            for (const auto &child : static_cast<const BlockStmt *>(stmt.get())->statements)
+                if (!collectCounterAssignments(child, name, nested, assignments))
+                    return false;
+            return true;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+            return collectCounterAssignments(ifStmt->thenBranch, name, nested, assignments) &&
+                   collectCounterAssignments(ifStmt->elseBranch, name, nested, assignments);
+        }
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+            for (const MatchArm &arm : matchStmt->arms)
+                if (!collectCounterAssignments(arm.body, name, nested, assignments))
+                    return false;
+            return collectCounterAssignments(matchStmt->defaultBranch, name, nested, assignments);
+        }
+        case StmtType::WHILE:
+            return collectCounterAssignments(static_cast<const WhileStmt *>(stmt.get())->body, name, true, assignments);
+        default:
+            return true;
+        }
+    }
+
+    /**
+     * @brief Variable gardée dans un registre pendant une boucle
+     */
+    struct PromotedVariable
+    {
+        int offset;      /**< Emplacement de pile de la variable */
+        const char *reg; /**< Registre qui la remplace dans la boucle */
+        bool written;    /**< Modifiée dans la boucle : recopiée dans son emplacement à la sortie */
+    };
+
+    /**
+     * @brief Promotion en registres des variables d'une boucle while interne
+     *
+     * Si le corps ne contient pas d'autre boucle, les variables déclarées avant la boucle et
+     * utilisées dans sa condition ou son corps sont classées par nombre d'utilisations, et les
+     * plus utilisées sont chargées dans r12 à r15 avant la boucle. Le langage ne permet pas de
+     * prendre l'adresse d'une variable et le runtime ne touche pas à ces registres : dans la
+     * boucle, le registre est la seule copie de la variable. Pour un tableau, seul le pointeur
+     * est promu, les éléments restent en mémoire.
+     *
+     * @return Les variables promues, à recopier en mémoire à la sortie de la boucle
+     */
+    std::vector<PromotedVariable> promoteLoopVariables(const WhileStmt *whileStmt, std::stringstream &assembly,
+                                                       const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
+    {
+        static const char *registers[] = {"r12", "r13", "r14", "r15"};
+
+        std::vector<PromotedVariable> promoted;
+        if (containsLoop(whileStmt->body))
+            return promoted;
+
+        std::vector<std::pair<std::string, int>> uses; // Dans l'ordre de première utilisation
+        std::unordered_set<std::string> declared;
+        collectVariableUses(whileStmt->condition, uses);
+        collectVariableUses(whileStmt->body, uses, declared);
+
+        // Un nom redéclaré dans le corps désigne deux variables : il n'est pas promu
+        uses.erase(std::remove_if(uses.begin(), uses.end(), [&](const std::pair<std::string, int> &use)
+                                  { return declared.count(use.first) || !findVariableOffset(use.first, symbolTables); }),
+                   uses.end());
+        std::stable_sort(uses.begin(), uses.end(), [](const std::pair<std::string, int> &a, const std::pair<std::string, int> &b)
+                         { return a.second > b.second; });
+        if (uses.size() > std::size(registers))
+            uses.resize(std::size(registers));
+        if (uses.empty())
+            return promoted;
+
+        std::unordered_set<std::string> written;
+        collectWrittenNames(whileStmt->body, written);
+
+        assembly << "    ; Variables de la boucle en registres\n";
+        for (const auto &use : uses)
+        {
+            PromotedVariable variable = {*findVariableOffset(use.first, symbolTables), registers[promoted.size()],
+                                         written.count(use.first) > 0};
+            assembly << "    mov " << variable.reg << ", [rbp-" << variable.offset << "]\n";
+            m_promotedSlots[variable.offset] = variable.reg;
+            promoted.push_back(variable);
+        }
+        return promoted;
+    }
+
+    /**
+     * @brief Indique si une instruction contient une boucle while
+     */
+    bool containsLoop(const std::shared_ptr<Stmt> &stmt) const
+    {
+        if (!stmt)
+            return false;
+
+        switch (stmt->getType())
+        {
+        case StmtType::WHILE:
+            return true;
+        case StmtType::BLOCK:
+            for (const auto &child : static_cast<const BlockStmt *>(stmt.get())->statements)
+                if (containsLoop(child))
+                    return true;
+            return false;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+            return containsLoop(ifStmt->thenBranch) || containsLoop(ifStmt->elseBranch);
+        }
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+            for (const MatchArm &arm : matchStmt->arms)
+                if (containsLoop(arm.body))
+                    return true;
+            return containsLoop(matchStmt->defaultBranch);
+        }
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Compte les lectures de chaque variable dans une expression
+     */
+    void collectVariableUses(const std::shared_ptr<Expr> &expr, std::vector<std::pair<std::string, int>> &uses) const
+    {
+        if (!expr)
+            return;
+
+        switch (expr->getType())
+        {
+        case ExprType::VARIABLE:
+            countUse(*static_cast<const VarExpr *>(expr.get())->token.value, uses);
+            break;
+        case ExprType::BINARY:
+        {
+            auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+            collectVariableUses(binExpr->gauche, uses);
+            collectVariableUses(binExpr->droite, uses);
+            break;
+        }
+        case ExprType::ARRAY:
+            for (const auto &element : static_cast<const ArrayExpr *>(expr.get())->elements)
+                collectVariableUses(element, uses);
+            break;
+        case ExprType::ARRAY_ACCESS:
+        {
+            auto accessExpr = static_cast<const ArrayAccessExpr *>(expr.get());
+            collectVariableUses(accessExpr->array, uses);
+            collectVariableUses(accessExpr->index, uses);
+            break;
+        }
+        case ExprType::LENGTH:
+            collectVariableUses(static_cast<const LengthExpr *>(expr.get())->array, uses);
+            break;
+        case ExprType::MATRIX:
+        {
+            auto matrixExpr = static_cast<const MatrixExpr *>(expr.get());
+            collectVariableUses(matrixExpr->rows, uses);
+            collectVariableUses(matrixExpr->cols, uses);
+            break;
+        }
+        case ExprType::MATRIX_ACCESS:
+        {
+            auto accessExpr = static_cast<const MatrixAccessExpr *>(expr.get());
+            collectVariableUses(accessExpr->matrix, uses);
+            collectVariableUses(accessExpr->row, uses);
+            collectVariableUses(accessExpr->col, uses);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Compte les lectures et écritures de chaque variable dans une instruction
+     * @param declared Reçoit les noms déclarés par un let
+     */
+    void collectVariableUses(const std::shared_ptr<Stmt> &stmt, std::vector<std::pair<std::string, int>> &uses,
+                             std::unordered_set<std::string> &declared) const
+    {
+        if (!stmt)
+            return;
+
+        switch (stmt->getType())
+        {
+        case StmtType::EXIT:
+            collectVariableUses(static_cast<const ExitStmt *>(stmt.get())->expr, uses);
+            break;
+        case StmtType::LET:
+        {
+            auto letStmt = static_cast<const LetStmt *>(stmt.get());
+            declared.insert(*letStmt->var.value);
+            collectVariableUses(letStmt->expr, uses);
+            break;
+        }
+        case StmtType::ASSIGN:
+        {
+            auto assignStmt = static_cast<const AssignStmt *>(stmt.get());
+            countUse(*assignStmt->var.value, uses);
+            collectVariableUses(assignStmt->expr, uses);
+            break;
+        }
+        case StmtType::PRINT:
+            for (const auto &arg : static_cast<const PrintStmt *>(stmt.get())->args)
+                collectVariableUses(arg.expr, uses);
+            break;
+        case StmtType::BLOCK:
+            for (const auto &child : static_cast<const BlockStmt *>(stmt.get())->statements)
+                collectVariableUses(child, uses, declared);
+            break;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+            collectVariableUses(ifStmt->condition, uses);
+            collectVariableUses(std::static_pointer_cast<Stmt>(ifStmt->thenBranch), uses, declared);
+            collectVariableUses(std::static_pointer_cast<Stmt>(ifStmt->elseBranch), uses, declared);
+            break;
+        }
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+            collectVariableUses(matchStmt->subject, uses);
+            for (const MatchArm &arm : matchStmt->arms)
+                collectVariableUses(std::static_pointer_cast<Stmt>(arm.body), uses, declared);
+            collectVariableUses(std::static_pointer_cast<Stmt>(matchStmt->defaultBranch), uses, declared);
+            break;
+        }
+        case StmtType::ARRAY_ASSIGN:
+        {
+            auto assignStmt = static_cast<const ArrayAssignStmt *>(stmt.get());
+            collectVariableUses(assignStmt->array, uses);
+            collectVariableUses(assignStmt->index, uses);
+            collectVariableUses(assignStmt->value, uses);
+            break;
+        }
+        case StmtType::MATRIX_ASSIGN:
+        {
+            auto assignStmt = static_cast<const MatrixAssignStmt *>(stmt.get());
+            collectVariableUses(assignStmt->matrix, uses);
+            collectVariableUses(assignStmt->row, uses);
+            collectVariableUses(assignStmt->col, uses);
+            collectVariableUses(assignStmt->value, uses);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    static void countUse(const std::string &name, std::vector<std::pair<std::string, int>> &uses)
+    {
+        for (auto &use : uses)
+        {
+            if (use.first == name)
+            {
+                use.second++;
+                return;
+            }
+        }
+        uses.push_back({name, 1});
+    }
+
+    /**
+     * @brief Accès m[i][j] rencontré dans une boucle (nœud, matrice et expression de ligne)
+     */
+    struct MatrixRowRef
+    {
+        const void *node;
+        std::shared_ptr<Expr> matrix;
+        std::shared_ptr<Expr> row;
+    };
+
+    /**
+     * @brief Réduction de force des accès de matrice dans une boucle while
+     *
+     * Pour chaque accès m[i][j] du corps dont la matrice et la ligne ne sont pas modifiées
+     * par la boucle, l'adresse de la ligne (m + i*colonnes*8) et le nombre de colonnes sont
+     * calculés une seule fois avant la boucle et gardés dans deux emplacements de pile.
+     * Dans la boucle, l'accès ne coûte plus qu'une comparaison de j et un chargement.
+     * Une ligne hors limites est mémorisée comme une adresse nulle, et l'erreur n'est levée
+     * que si l'accès est réellement exécuté.
+     *
+     * @param hoistedNodes Reçoit les nœuds dont la ligne est pré-calculée
+     * @return Le nombre d'octets de pile réservés (à libérer après la boucle)
+     */
+    int hoistMatrixRows(const WhileStmt *whileStmt, std::stringstream &assembly,
+                        std::vector<std::unordered_map<std::string, int>> &symbolTables,
+                        int &stackOffset, std::vector<const void *> &hoistedNodes) const
+    {
+        std::vector<MatrixRowRef> refs;
+        collectMatrixRows(whileStmt->condition, refs);
+        collectMatrixRows(std::static_pointer_cast<Stmt>(whileStmt->body), refs);
+        if (refs.empty())
+            return 0;
+
+        std::unordered_set<std::string> written;
+        collectWrittenNames(whileStmt->body, written);
+
+        std::unordered_map<std::string, std::pair<int, int>> slotsByKey;
+        std::vector<std::pair<const MatrixRowRef *, std::pair<int, int>>> toCompute;
+        for (const auto &ref : refs)
+        {
+            // Une ligne dont le calcul peut déborder reste dans la boucle : avant la boucle, le
+            // trap de --checked-arith se déclencherait même si la boucle ne s'exécute pas
+            if (ref.matrix->getType() != ExprType::VARIABLE ||
+                !isLoopInvariant(ref.matrix, written) || !isLoopInvariant(ref.row, written) ||
+                hasOverflowCheck(ref.row))
+                continue;
+
+            std::string key = exprKey(ref.matrix) + "[" + exprKey(ref.row) + "]";
+            auto found = slotsByKey.find(key);
+            if (found == slotsByKey.end())
+            {
+                // Deux emplacements : adresse de la ligne puis nombre de colonnes
+                std::pair<int, int> slots = {stackOffset + 8 + 16 * static_cast<int>(toCompute.size()),
+                                             stackOffset + 16 + 16 * static_cast<int>(toCompute.size())};
+                found = slotsByKey.emplace(key, slots).first;
+                toCompute.push_back({&ref, slots});
+            }
+            m_hoistedRows[ref.node] = found->second;
+            hoistedNodes.push_back(ref.node);
+        }
+        if (toCompute.empty())
+            return 0;
+
+        int bytes = 16 * static_cast<int>(toCompute.size());
+        stackOffset += bytes;
+        assembly << "    ; Adresses de lignes de matrice hors de la boucle\n";
+        assembly << "    sub rsp, " << bytes << "\n";
+
+        static int rowCounter = 0;
+        for (const auto &entry : toCompute)
+        {
+            std::string invalidLabel = ".matrix_row_" + std::to_string(rowCounter++);
+            generateExpressionCode(entry.first->matrix, assembly, symbolTables);
+            assembly << "    push rax\n";
+            generateExpressionCode(entry.first->row, assembly, symbolTables);
+            assembly << "    pop rbx\n";
+            assembly << "    mov rcx, [rbx-16]\n"; // Colonnes
+            assembly << "    mov [rbp-" << entry.second.second << "], rcx\n";
+            assembly << "    xor edx, edx\n";
+            assembly << "    cmp rax, [rbx-24]\n"; // Ligne hors limites : adresse nulle
+            assembly << "    jae " << invalidLabel << "\n";
+            assembly << "    imul rax, rcx\n";
+            assembly << "    lea rdx, [rbx + rax*8]\n";
+            assembly << invalidLabel << ":\n";
+            assembly << "    mov [rbp-" << entry.second.first << "], rdx\n";
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Collecte les accès de matrice d'une expression
+     */
+    void collectMatrixRows(const std::shared_ptr<Expr> &expr, std::vector<MatrixRowRef> &refs) const
+    {
+        if (!expr)
+            return;
+
+        switch (expr->getType())
+        {
+        case ExprType::BINARY:
+        {
+            auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+            collectMatrixRows(binExpr->gauche, refs);
+            collectMatrixRows(binExpr->droite, refs);
+            break;
+        }
+        case ExprType::ARRAY:
+            for (const auto &element : static_cast<const ArrayExpr *>(expr.get())->elements)
+                collectMatrixRows(element, refs);
+            break;
+        case ExprType::ARRAY_ACCESS:
+        {
+            auto accessExpr = static_cast<const ArrayAccessExpr *>(expr.get());
+            collectMatrixRows(accessExpr->array, refs);
+            collectMatrixRows(accessExpr->index, refs);
+            break;
+        }
+        case ExprType::LENGTH:
+            collectMatrixRows(static_cast<const LengthExpr *>(expr.get())->array, refs);
+            break;
+        case ExprType::MATRIX:
+        {
+            auto matrixExpr = static_cast<const MatrixExpr *>(expr.get());
+            collectMatrixRows(matrixExpr->rows, refs);
+            collectMatrixRows(matrixExpr->cols, refs);
+            break;
+        }
+        case ExprType::MATRIX_ACCESS:
+        {
+            auto accessExpr = static_cast<const MatrixAccessExpr *>(expr.get());
+            refs.push_back({accessExpr, accessExpr->matrix, accessExpr->row});
+            collectMatrixRows(accessExpr->row, refs);
+            collectMatrixRows(accessExpr->col, refs);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Collecte les accès de matrice d'une instruction
+     * @note Les boucles imbriquées sont ignorées : elles font leur propre réduction
+     */
+    void collectMatrixRows(const std::shared_ptr<Stmt> &stmt, std::vector<MatrixRowRef> &refs) const
+    {
+        if (!stmt)
+            return;
+
+        switch (stmt->getType())
+        {
+        case StmtType::EXIT:
+            collectMatrixRows(static_cast<const ExitStmt *>(stmt.get())->expr, refs);
+            break;
+        case StmtType::LET:
+            collectMatrixRows(static_cast<const LetStmt *>(stmt.get())->expr, refs);
+            break;
+        case StmtType::ASSIGN:
+            collectMatrixRows(static_cast<const AssignStmt *>(stmt.get())->expr, refs);
+            break;
+        case StmtType::PRINT:
+            for (const auto &arg : static_cast<const PrintStmt *>(stmt.get())->args)
+                collectMatrixRows(arg.expr, refs);
+            break;
+        case StmtType::BLOCK:
+            for (const auto &child : static_cast<const BlockStmt *>(stmt.get())->statements)
+                collectMatrixRows(child, refs);
+            break;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+            collectMatrixRows(ifStmt->condition, refs);
+            collectMatrixRows(std::static_pointer_cast<Stmt>(ifStmt->thenBranch), refs);
+            collectMatrixRows(std::static_pointer_cast<Stmt>(ifStmt->elseBranch), refs);
+            break;
         }
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+            collectMatrixRows(matchStmt->subject, refs);
+            for (const MatchArm &arm : matchStmt->arms)
+                collectMatrixRows(std::static_pointer_cast<Stmt>(arm.body), refs);
+            collectMatrixRows(std::static_pointer_cast<Stmt>(matchStmt->defaultBranch), refs);
+            break;
+        }
+        case StmtType::ARRAY_ASSIGN:
+        {
+            auto assignStmt = static_cast<const ArrayAssignStmt *>(stmt.get());
+            collectMatrixRows(assignStmt->array, refs);
+            collectMatrixRows(assignStmt->index, refs);
+            collectMatrixRows(assignStmt->value, refs);
+            break;
+        }
+        case StmtType::MATRIX_ASSIGN:
+        {
+            auto assignStmt = static_cast<const MatrixAssignStmt *>(stmt.get());
+            refs.push_back({assignStmt, assignStmt->matrix, assignStmt->row});
+            collectMatrixRows(assignStmt->row, refs);
+            collectMatrixRows(assignStmt->col, refs);
+            collectMatrixRows(assignStmt->value, refs);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Collecte les noms de variables déclarées ou modifiées dans une instruction
+     */
+    void collectWrittenNames(const std::shared_ptr<Stmt> &stmt, std::unordered_set<std::string> &names) const
+    {
+        if (!stmt)
+            return;
+
+        switch (stmt->getType())
+        {
+        case StmtType::LET:
+            names.insert(*static_cast<const LetStmt *>(stmt.get())->var.value);
+            break;
+        case StmtType::ASSIGN:
+            names.insert(*static_cast<const AssignStmt *>(stmt.get())->var.value);
+            break;
+        case StmtType::BLOCK:
+            for (const auto &child : static_cast<const BlockStmt *>(stmt.get())->statements)
+                collectWrittenNames(child, names);
+            break;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+            collectWrittenNames(ifStmt->thenBranch, names);
+            collectWrittenNames(ifStmt->elseBranch, names);
+            break;
+        }
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+            for (const MatchArm &arm : matchStmt->arms)
+                collectWrittenNames(arm.body, names);
+            collectWrittenNames(matchStmt->defaultBranch, names);
+            break;
+        }
+        case StmtType::WHILE:
+            collectWrittenNames(static_cast<const WhileStmt *>(stmt.get())->body, names);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Indique si tous les éléments d'un tableau littéral sont des entiers
+     */
+    static bool isConstantArray(const ArrayExpr *arrayExpr)
+    {
+        for (const auto &element : arrayExpr->elements)
+            if (element->getType() != ExprType::INTEGER || !static_cast<const IntExpr *>(element.get())->token.value)
+                return false;
+        return true;
+    }
+
+    /**
+     * @brief Remplit le tableau rax, qui vient d'être alloué, depuis une table en .rodata
+     *
+     * Les éléments sont écrits dans .rodata, alignés sur 64 octets comme l'élément 0 d'un
+     * tableau, puis copiés par blocs de la largeur permise par -march : 16 octets (SSE2),
+     * 32 (AVX2) ou 64 (AVX-512). Jusqu'à 32 éléments, les copies sont écrites en ligne ;
+     * au-delà, yb_rt_copy_words fait une boucle et choisit elle-même sa version au
+     * premier appel, ce qui donne la pleine largeur même avec le -march par défaut.
+     */
+    void generateConstantArrayCopy(const ArrayExpr *arrayExpr, std::stringstream &assembly) const
+    {
+        static constexpr size_t INLINE_COPY_ELEMENTS = 32;
+        std::string table = "..@yb_array_" + std::to_string(m_constantArrays++);
+        size_t size = arrayExpr->elements.size();
+
+        if (size > INLINE_COPY_ELEMENTS)
+        {
+            m_runtime.require(RuntimeRoutine::COPY_WORDS);
+            assembly << "    lea rbx, [rel " << table << "]\n";
+            assembly << "    call yb_rt_copy_words\n";
+        }
+        else
+        {
+            CpuLevel level = m_options.runtime.cpuLevel;
+            size_t widest = level >= CpuLevel::V4 ? 8 : level >= CpuLevel::V3 ? 4 : 2;
+            std::string vex = level >= CpuLevel::V3 ? "v" : ""; // Pas de mélange d'encodages SSE et AVX
+            size_t offset = 0;
+            for (size_t width = widest; width >= 1; width /= 2)
+            {
+                // Les décalages restent multiples de la largeur : copies alignées
+                for (; size - offset / 8 >= width; offset += width * 8)
+                {
+                    std::string source = "[rel " + table + " + " + std::to_string(offset) + "]";
+                    std::string target = "[rax + " + std::to_string(offset) + "]";
+                    if (width == 8)
+                        assembly << "    vmovdqa64 zmm0, " << source << "\n    vmovdqa64 " << target << ", zmm0\n";
+                    else if (width == 4)
+                        assembly << "    vmovdqa ymm0, " << source << "\n    vmovdqa " << target << ", ymm0\n";
+                    else if (width == 2)
+                        assembly << "    " << vex << "movdqa xmm0, " << source << "\n    " << vex << "movdqa " << target
+                                 << ", xmm0\n";
+                    else
+                        assembly << "    mov rbx, " << source << "\n    mov " << target << ", rbx\n";
+                }
+            }
+            if (size >= 4 && widest > 2)
+                assembly << "    vzeroupper\n"; // ymm0 ou zmm0 a servi
+        }
+
+        pushSection("section .rodata", assembly);
+        assembly << "align 64\n";
+        assembly << table << ":";
+        for (size_t i = 0; i < size; i++)
+            assembly << (i % 16 == 0 ? (i == 0 ? " dq " : "\ndq ") : ", ")
+                     << *static_cast<const IntExpr *>(arrayExpr->elements[i].get())->token.value;
+        assembly << "\n";
+        popSection(assembly);
+    }
+
+    /**
+     * @brief Indique si une expression peut être évaluée avant la boucle
+     *
+     * Seuls les entiers, les variables non modifiées et les opérations qui ne peuvent pas
+     * échouer sont acceptés (pas de division : elle pourrait diviser par zéro alors que
+     * la boucle ne s'exécute pas).
+     */
+    bool isLoopInvariant(const std::shared_ptr<Expr> &expr, const std::unordered_set<std::string> &written) const
+    {
+        switch (expr->getType())
+        {
+        case ExprType::INTEGER:
+            return true;
+        case ExprType::VARIABLE:
+            return written.count(*static_cast<const VarExpr *>(expr.get())->token.value) == 0;
+        case ExprType::BINARY:
+        {
+            auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+            return binExpr->op != BinaryOpType::DIV && binExpr->op != BinaryOpType::MOD &&
+                   isLoopInvariant(binExpr->gauche, written) && isLoopInvariant(binExpr->droite, written);
+        }
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Indique si le code d'une expression invariante contient un saut vers le trap de
+     * dépassement (voir generateOverflowCheck)
+     */
+    bool hasOverflowCheck(const std::shared_ptr<Expr> &expr) const
+    {
+        if (!m_options.checkedArithmetic || expr->getType() != ExprType::BINARY)
+            return false;
+        auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+        bool checked = (binExpr->op == BinaryOpType::ADD || binExpr->op == BinaryOpType::SUB ||
+                        binExpr->op == BinaryOpType::MUL) &&
+                       !m_uncheckedNodes.count(binExpr) && !exactRange(binExpr).fits();
+        return checked || hasOverflowCheck(binExpr->gauche) || hasOverflowCheck(binExpr->droite);
+    }
+
+    /**
+     * @brief Clé textuelle d'une expression invariante, pour regrouper les accès identiques
+     */
+    std::string exprKey(const std::shared_ptr<Expr> &expr) const
+    {
+        switch (expr->getType())
+        {
+        case ExprType::INTEGER:
+            return *static_cast<const IntExpr *>(expr.get())->token.value;
+        case ExprType::VARIABLE:
+            return "$" + *static_cast<const VarExpr *>(expr.get())->token.value;
+        case ExprType::BINARY:
+        {
+            auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+            return "(" + exprKey(binExpr->gauche) + " " + std::to_string(static_cast<int>(binExpr->op)) +
+                   " " + exprKey(binExpr->droite) + ")";
+        }
+        default:
+            return "?";
+        }
+    }
+
+    /**
+     * @brief Génère le code assembleur pour une assignation de variable
+     */
+    void generateAssignCode(const AssignStmt *assignStmt, std::stringstream &assembly,
+                            const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
+    {
+        if (!assignStmt || !assignStmt->expr)
+            return;
+
+        // Aller dora ou est la variable
+        std::string varName = *assignStmt->var.value; // le nom de la variable
+        int offset = -1;
+
+        // Chercher la variable dans toutes les tables de symboles (de la plus récente à la plus ancienne)
+        for (int i = symbolTables.size() - 1; i >= 0; i--)
+        {
+            if (symbolTables[i].find(varName) != symbolTables[i].end())
+            {
+                offset = symbolTables[i].at(varName);
+                break;
+            }
+        }
+
+        if (offset == -1)
+        {
+            std::cerr << "Erreur: Variable non déclarée PTN FAIT GAFFE NE REFFAIT PLUS JAMAIS CA !!!! : " << varName << std::endl;
+            return;
+        }
+
+        ConstructScope scope(m_stats, CodeConstruct::STORE, assembly);
 
         // Générer le code pour l'expression
         generateExpressionCode(assignStmt->expr, assembly, symbolTables);
 
         // Stocker le résultat dans la variable
-        assembly << "    mov [rbp-" << offset << "], rax\n";
+        assembly << "    mov " << variableOperand(offset) << ", rax\n";
     }
 
     /**
      * @brief Génère le code pour une instruction print
+     *
+     * La conversion et l'écriture sont faites par le runtime : la valeur est ajoutée
+     * au tampon de sortie, qui n'est écrit sur stdout que lorsqu'il est plein ou à la sortie.
+     * Plusieurs valeurs, ou un tableau, sont passées sur la pile à yb_rt_print_list qui
+     * formate toute la ligne en un seul appel.
      */
-
-    // CETTE partie j'ai rien fait par moi meme yoo l'assembleur c'est chaud ca GM
     void generatePrintCode(const PrintStmt *printStmt, std::stringstream &assembly,
                            const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
     {
-        if (!printStmt || !printStmt->expr)
+        if (!printStmt || printStmt->args.empty())
+            return;
+
+        ConstructScope scope(m_stats, CodeConstruct::PRINT, assembly);
+
+        if (printStmt->args.size() == 1 && !printStmt->args[0].array)
+        {
+            // Générer le code pour l'expression (résultat dans rax)
+            generateExpressionCode(printStmt->args[0].expr, assembly, symbolTables);
+
+            m_runtime.require(RuntimeRoutine::PRINT_INT);
+            assembly << "    call yb_rt_print_int\n";
             return;
+        }
 
-        // Compteur statique pour garantir l'unicité des labels
-        static int printCounter = 0;
-        std::string positiveLabel = ".print_positive_" + std::to_string(printCounter);
-        std::string convertLabel = ".convert_loop_" + std::to_string(printCounter);
-        printCounter++; // Incrémenter pour le prochain appel
-
-        // Générer le code pour l'expression (résultat dans rax)
-        generateExpressionCode(printStmt->expr, assembly, symbolTables);
-
-        // Ajouter le code pour convertir un entier en chaîne et l'afficher
-        assembly << "    ; Convertir et afficher l'entier\n";
-
-        // Allouer de l'espace sur la pile pour stocker la chaîne (21 octets pour un int64 max)
-        assembly << "    sub rsp, 32\n";          // Réserver 32 octets
-        assembly << "    mov rcx, rsp\n";         // Pointeur vers le buffer
-        assembly << "    add rcx, 31\n";          // Pointer à la fin du buffer
-        assembly << "    mov byte [rcx], 0x0A\n"; // Ajouter un saut de ligne
-        assembly << "    dec rcx\n";              // Déplacer le pointeur en arrière
-
-        // Sauvegarder rax (la valeur à afficher)
-        assembly << "    mov r10, rax\n"; // Copier la valeur à afficher
-
-        // Vérifier si le nombre est négatif
-        assembly << "    test r10, r10\n";               // Tester si r10 < 0
-        assembly << "    jns " << positiveLabel << "\n"; // Si non négatif, sauter
-        assembly << "    neg r10\n";                     // Rendre r10 positif
-        assembly << "    mov byte [rcx], 0x2D\n";        // Ajouter '-' (ASCII 45)
-        assembly << "    dec rcx\n";                     // Déplacer le pointeur en arrière
-
-        // Convertir la valeur absolue
-        assembly << positiveLabel << ":\n";
-        assembly << "    mov rax, r10\n"; // rax = valeur absolue
-        assembly << "    mov r9, 10\n";   // Diviseur = 10
-
-        // Début de la boucle de conversion
-        assembly << convertLabel << ":\n";
-        assembly << "    xor rdx, rdx\n";               // rdx = 0 (reste)
-        assembly << "    div r9\n";                     // rax = quotient, rdx = reste
-        assembly << "    add dl, '0'\n";                // Convertir en caractère ASCII
-        assembly << "    mov [rcx], dl\n";              // Stocker dans le buffer
-        assembly << "    dec rcx\n";                    // Déplacer le pointeur en arrière
-        assembly << "    test rax, rax\n";              // Vérifier si on a terminé
-        assembly << "    jnz " << convertLabel << "\n"; // Si quotient != 0, continuer
-
-        // Calculer la longueur de la chaîne
-        assembly << "    lea rsi, [rcx+1]\n"; // Adresse du premier caractère
-        assembly << "    mov rdx, rsp\n";
-        assembly << "    add rdx, 31\n";  // Adresse du dernier caractère
-        assembly << "    sub rdx, rcx\n"; // Calculer la longueur
-
-        // Afficher la chaîne avec l'appel système write
-        assembly << "    mov rax, 1\n"; // syscall write
-        assembly << "    mov rdi, 1\n"; // stdout
-        assembly << "    syscall\n";
-
-        // Libérer l'espace sur la pile
-        assembly << "    add rsp, 32\n";
+        // Deux mots par valeur : la valeur et -1, ou l'adresse d'un tableau et sa longueur
+        for (const auto &arg : printStmt->args)
+        {
+            generateExpressionCode(arg.expr, assembly, symbolTables);
+            assembly << "    push rax\n";
+            if (arg.array)
+                assembly << "    push qword [rax-8]\n";
+            else
+                assembly << "    push -1\n";
+        }
+
+        m_runtime.require(RuntimeRoutine::PRINT_LIST);
+        assembly << "    mov rax, " << printStmt->args.size() << "\n";
+        assembly << "    call yb_rt_print_list\n";
+        assembly << "    add rsp, " << 16 * printStmt->args.size() << "\n";
     }
     // Je suis fatigué mais je dois au moins finir ca travaille chatGPT sur cette partie hh
     /**
@@ -608,6 +2042,8 @@ private:
     void generateArrayAssignCode(const ArrayAssignStmt *stmt, std::stringstream &assembly,
                                  const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
     {
+        ConstructScope scope(m_stats, CodeConstruct::ARRAY_ACCESS, assembly);
+
         // Générer le code pour la valeur à assigner
         generateExpressionCode(stmt->value, assembly, symbolTables);
         assembly << "    push rax\n"; // Sauvegarder la valeur
@@ -619,20 +2055,150 @@ private:
         // Générer le code pour l'indice
         generateExpressionCode(stmt->index, assembly, symbolTables);
 
-        // Ajouter 1 à l'indice pour le décalage de la taille
-        assembly << "    add rax, 1\n";
-        assembly << "    imul rax, 8\n"; // Multiplier par 8 octets
-
         // Calculer l'adresse cible
-        assembly << "    pop rbx\n";      // Récupérer l'adresse du tableau
-        assembly << "    add rbx, rax\n"; // Calculer l'adresse de l'élément
+        assembly << "    pop rbx\n"; // Récupérer l'adresse du tableau
+        generateBoundsCheck(assembly);
+        assembly << "    lea rbx, [rbx + rax*8]\n";
 
         // Stocker la valeur
         assembly << "    pop rax\n";        // Récupérer la valeur
         assembly << "    mov [rbx], rax\n"; // Stocker la valeur
     }
+
+    /**
+     * @brief Génère le code pour une assignation d'élément de matrice
+     */
+    void generateMatrixAssignCode(const MatrixAssignStmt *stmt, std::stringstream &assembly,
+                                  const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
+    {
+        ConstructScope scope(m_stats, CodeConstruct::MATRIX, assembly);
+
+        generateExpressionCode(stmt->value, assembly, symbolTables);
+        assembly << "    push rax\n"; // Sauvegarder la valeur
+
+        generateMatrixElementAddress(stmt, stmt->matrix, stmt->row, stmt->col, assembly, symbolTables);
+
+        assembly << "    pop rax\n";
+        assembly << "    mov [rbx], rax\n";
+    }
+
+    /**
+     * @brief Calcule dans rbx l'adresse de l'élément m[ligne][colonne]
+     *
+     * L'adresse est base + (ligne * colonnes + colonne) * 8. Si la boucle englobante a
+     * déjà calculé l'adresse de la ligne (voir hoistMatrixRows), seule la colonne est évaluée.
+     *
+     * @param node Nœud de l'AST (accès ou affectation) servant de clé pour les lignes pré-calculées
+     */
+    void generateMatrixElementAddress(const void *node, const std::shared_ptr<Expr> &matrix,
+                                      const std::shared_ptr<Expr> &row, const std::shared_ptr<Expr> &col,
+                                      std::stringstream &assembly,
+                                      const std::vector<std::unordered_map<std::string, int>> &symbolTables) const
+    {
+        m_runtime.require(RuntimeRoutine::BOUNDS_TRAP);
+
+        auto hoisted = m_hoistedRows.find(node);
+        if (hoisted != m_hoistedRows.end())
+        {
+            generateExpressionCode(col, assembly, symbolTables);
+            assembly << "    mov rbx, [rbp-" << hoisted->second.first << "]\n"; // Adresse de la ligne
+            assembly << "    test rbx, rbx\n";
+            assembly << "    jz yb_rt_bounds_trap\n";
+            assembly << "    cmp rax, [rbp-" << hoisted->second.second << "]\n";
+            assembly << "    jae yb_rt_bounds_trap\n";
+            assembly << "    lea rbx, [rbx + rax*8]\n";
+            return;
+        }
+
+        generateExpressionCode(matrix, assembly, symbolTables);
+        assembly << "    push rax\n";
+        generateExpressionCode(row, assembly, symbolTables);
+        assembly << "    push rax\n";
+        generateExpressionCode(col, assembly, symbolTables);
+        assembly << "    pop rcx\n"; // Ligne
+        assembly << "    pop rbx\n"; // Matrice
+        assembly << "    cmp rcx, [rbx-24]\n";
+        assembly << "    jae yb_rt_bounds_trap\n";
+        assembly << "    cmp rax, [rbx-16]\n";
+        assembly << "    jae yb_rt_bounds_trap\n";
+        assembly << "    imul rcx, [rbx-16]\n";
+        assembly << "    add rax, rcx\n";
+        assembly << "    lea rbx, [rbx + rax*8]\n";
+    }
+
+    /**
+     * @brief Vérifie que l'indice (rax) est dans les bornes du tableau (rbx)
+     * @note La comparaison non signée rejette aussi les indices négatifs
+     */
+    void generateBoundsCheck(std::stringstream &assembly) const
+    {
+        m_runtime.require(RuntimeRoutine::BOUNDS_TRAP);
+        assembly << "    cmp rax, [rbx-8]\n";
+        assembly << "    jae yb_rt_bounds_trap\n";
+    }
     /**
      * @brief Programme à compiler
      */
     const Program m_program;
+
+    /**
+     * @brief Options de génération
+     */
+    const GeneratorOptions m_options;
+
+    /**
+     * @brief Routines du runtime utilisées par le programme (rempli pendant la génération)
+     */
+    mutable RuntimeEmitter m_runtime;
+
+    /**
+     * @brief Emplacements de pile (adresse de ligne, colonnes) des accès de matrice
+     * pré-calculés avant leur boucle, indexés par nœud de l'AST
+     */
+    mutable std::unordered_map<const void *, std::pair<int, int>> m_hoistedRows;
+
+    /**
+     * @brief Registres des variables promues par la boucle interne en cours de génération,
+     * indexés par emplacement de pile
+     */
+    mutable std::unordered_map<int, std::string> m_promotedSlots;
+
+    /**
+     * @brief Additions et soustractions de compteurs de boucle prouvées sans dépassement
+     * (mode --checked-arith), pour la boucle en cours de génération
+     */
+    mutable std::unordered_set<const void *> m_uncheckedNodes;
+
+    /**
+     * @brief Origine des instructions émises (mode --stats)
+     */
+    mutable CodeStatsRecorder m_stats;
+
+    /**
+     * @brief Statistiques du dernier code généré
+     */
+    mutable CodeStats m_codeStats;
+
+    /**
+     * @brief État de la génération entre deux instructions de premier niveau
+     */
+    mutable std::vector<std::unordered_map<std::string, int>> m_symbolTables;
+    mutable int m_stackOffset = 0;
+    mutable bool m_hasExitStmt = false; ///< Une instruction exit a été trouvée au premier niveau
+    mutable int m_constantArrays = 0;   ///< Tables .rodata des tableaux littéraux constants
+
+    /**
+     * @brief Ligne du source de chaque repère de ligne posé (option faultHandler)
+     */
+    mutable std::vector<int> m_lineMarks;
+
+    /**
+     * @brief Sections ouvertes, la section courante en dernier (voir pushSection)
+     */
+    mutable std::vector<std::string> m_sections{"section .text"};
+
+    /**
+     * @brief Paramètres rencontrés (instructions param), pour l'en-tête C++
+     */
+    mutable std::vector<KernelParameter> m_parameters;
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file HeaderEmitter.hpp
+ * @brief Génère l'en-tête C++ d'un noyau compilé avec --shared (option --emit-header).
+ *
+ * Le noyau est la fonction `extern "C" int64_t yb_main(...)` de la bibliothèque, avec un
+ * argument par instruction param du programme, dans l'ordre du source. Un tableau est
+ * passé par l'adresse de son élément 0, la longueur étant lue dans le mot qui précède :
+ * l'en-tête fournit yb::ArrayView, qui pose cette longueur devant un tampon de l'hôte
+ * pour que le noyau travaille directement sur ses données, sans copie.
+ */
+
+/**
+ * @brief Paramètre d'un noyau (instruction param)
+ */
+struct KernelParameter
+{
+    std::string name;
+    bool array; /**< Tableau (param t[];) ou entier (param n;) */
+};
+
+/**
+ * @brief Produit l'en-tête C++ d'un noyau
+ * @param entry Nom du symbole exporté
+ * @param parameters Paramètres, dans l'ordre des arguments
+ * @param sourceName Fichier source, rappelé en commentaire
+ */
+inline std::string generateKernelHeader(const std::string &entry, const std::vector<KernelParameter> &parameters,
+                                        const std::string &sourceName)
+{
+    std::ostringstream header;
+    header << "// Genere par le compilateur YB a partir de " << sourceName << " : ne pas modifier\n"
+           << "#pragma once\n\n"
+           << "#include <cstddef>\n"
+           << "#include <cstdint>\n"
+           << "#include <span>\n\n";
+
+    header << "#ifndef YB_ARRAY_VIEW_DEFINED\n"
+           << "#define YB_ARRAY_VIEW_DEFINED\n"
+           << "namespace yb\n"
+           << "{\n"
+           << "/**\n"
+           << " * @brief Tableau passe a un noyau YB sans copie\n"
+           << " *\n"
+           << " * Disposition des tableaux du runtime : un mot de longueur suivi des elements.\n"
+           << " * Le premier mot du tampon recoit la longueur, les suivants sont les elements ;\n"
+           << " * le noyau lit et ecrit directement dans le tampon. La longueur doit rester\n"
+           << " * inferieure a 2^56.\n"
+           << " */\n"
+           << "class ArrayView\n"
+           << "{\n"
+           << "public:\n"
+           << "    /// words.size() >= 1 : words[0] est ecrase, les words.size() - 1 mots suivants sont les elements\n"
+           << "    explicit ArrayView(std::span<std::int64_t> words) : m_elements(words.data() + 1)\n"
+           << "    {\n"
+           << "        words[0] = static_cast<std::int64_t>(words.size() - 1);\n"
+           << "    }\n\n"
+           << "    /// Nombre de mots du tampon d'un tableau de `length` elements\n"
+           << "    static constexpr std::size_t words(std::size_t length) { return length + 1; }\n\n"
+           << "    std::int64_t *data() const { return m_elements; }\n"
+           << "    std::size_t size() const { return static_cast<std::size_t>(m_elements[-1]); }\n"
+           << "    std::span<std::int64_t> elements() const { return {m_elements, size()}; }\n\n"
+           << "private:\n"
+           << "    std::int64_t *m_elements;\n"
+           << "};\n"
+           << "} // namespace yb\n"
+           << "#endif\n\n";
+
+    std::string rawArguments;
+    std::string viewArguments;
+    std::string forwarded;
+    for (size_t i = 0; i < parameters.size(); i++)
+    {
+        const std::string separator = i ? ", " : "";
+        const KernelParameter &parameter = parameters[i];
+        rawArguments += separator + (parameter.array ? "std::int64_t *" : "std::int64_t ") + parameter.name;
+        viewArguments += separator + (parameter.array ? "ArrayView " : "std::int64_t ") + parameter.name;
+        forwarded += separator + parameter.name + (parameter.array ? ".data()" : "");
+    }
+
+    header << "/// Renvoie la valeur passee a exit (0 sans exit, 1 apres une erreur d'execution)\n"
+           << "extern \"C\" std::int64_t " << entry << "(" << rawArguments << ");\n\n"
+           << "namespace yb\n"
+           << "{\n"
+           << "inline std::int64_t " << entry << "(" << viewArguments << ")\n"
+           << "{\n"
+           << "    return ::" << entry << "(" << forwarded << ");\n"
+           << "}\n"
+           << "} // namespace yb\n";
+    return header.str();
+}
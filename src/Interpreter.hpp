@@ -0,0 +1,455 @@
+#pragma once
+
+#include "Parser.hpp"
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file Interpreter.hpp
+ * @brief Interpréteur de référence de l'AST.
+ *
+ * L'interpréteur exécute un Program directement sur l'arbre syntaxique, avec la même
+ * sémantique que le code produit par le Generator : entiers signés de 64 bits qui
+ * débordent modulo 2^64, opérandes d'une expression binaire évalués de droite à gauche,
+ * ET et OU bit à bit, division entière tronquée, tableaux et matrices partagés par
+ * référence, traps de bornes, d'allocation et de dépassement avec --checked-arith
+ * (message sur stderr et code 1).
+ *
+ * Il sert d'oracle au fuzzing différentiel (fuzz/diff_fuzz.cpp) : tout écart entre
+ * l'interpréteur et le binaire natif est un bug du compilateur ou du runtime.
+ * Les programmes dont le comportement natif n'est pas défini (variable non déclarée,
+ * entier utilisé comme tableau, tableau additionné, print d'une variable dont la
+ * valeur n'a pas la nature donnée par son let...) sont signalés
+ * comme INVALID plutôt que d'imiter un comportement accidentel.
+ */
+
+/**
+ * @brief Résultat d'une exécution par l'interpréteur
+ */
+struct InterpreterResult
+{
+    enum class Status
+    {
+        EXITED,     // Fin normale ou exit(), exitCode est valide
+        SIGNALED,   // Le programme natif serait tué par un signal (division par zéro)
+        INVALID,    // Programme hors du modèle, le comportement natif n'est pas défini
+        STEP_LIMIT, // Trop d'instructions exécutées (boucle probablement infinie)
+    };
+
+    Status status = Status::EXITED;
+    int exitCode = 0;    /**< Code de sortie (0 à 255) si EXITED */
+    int signal = 0;      /**< Numéro du signal si SIGNALED */
+    std::string output;  /**< Texte écrit sur stdout */
+    std::string message; /**< Message d'erreur (trap, raison de INVALID) */
+};
+
+/**
+ * @brief Interpréteur de référence pour les programmes YB
+ */
+class Interpreter
+{
+public:
+    /**
+     * @brief Taille maximale d'une matrice interprétée, au-delà le programme est INVALID
+     */
+    static constexpr long long MAX_ELEMENTS = 1LL << 22;
+
+    /**
+     * @param program Programme à exécuter
+     * @param stepLimit Nombre maximal d'instructions et d'itérations avant STEP_LIMIT
+     * @param checkedArithmetic Sémantique de --checked-arith : un dépassement de +, - ou * arrête le programme
+     */
+    Interpreter(const Program &program, long long stepLimit = 10000000, bool checkedArithmetic = false)
+        : m_program(program), m_stepLimit(stepLimit), m_checkedArithmetic(checkedArithmetic) {}
+
+    /**
+     * @brief Exécute le programme du début à la fin
+     */
+    InterpreterResult run()
+    {
+        m_result = InterpreterResult();
+        m_scopes.assign(1, {});
+        m_arrays.clear();
+        m_steps = 0;
+
+        try
+        {
+            for (const auto &stmt : m_program.statements)
+                execute(stmt);
+            halt(InterpreterResult::Status::EXITED, 0);
+        }
+        catch (const Halt &)
+        {
+        }
+        return m_result;
+    }
+
+private:
+    // Messages identiques à ceux du runtime yb_rt
+    static constexpr const char *MSG_BOUNDS = "Erreur: indice de tableau hors limites";
+    static constexpr const char *MSG_ALLOC = "Erreur: allocation memoire impossible";
+    static constexpr const char *MSG_OVERFLOW = "Erreur: depassement de capacite arithmetique";
+
+    /**
+     * @brief Valeur d'une variable : un entier, ou une référence vers un tableau
+     */
+    struct Value
+    {
+        long long number = 0;
+        int array = -1; // Indice dans m_arrays, -1 pour un entier
+    };
+
+    /**
+     * @brief Tableau ou matrice (les dimensions restent à 0 pour un tableau simple)
+     */
+    struct ArrayObject
+    {
+        std::vector<Value> elements;
+        long long rows = 0;
+        long long cols = 0;
+    };
+
+    /**
+     * @brief Levée pour arrêter l'exécution, m_result est déjà rempli
+     */
+    struct Halt
+    {
+    };
+
+    [[noreturn]] void halt(InterpreterResult::Status status, int code, const std::string &message = "")
+    {
+        m_result.status = status;
+        if (status == InterpreterResult::Status::SIGNALED)
+            m_result.signal = code;
+        else
+            m_result.exitCode = code & 0xff;
+        m_result.message = message;
+        throw Halt();
+    }
+
+    [[noreturn]] void invalid(const std::string &reason)
+    {
+        halt(InterpreterResult::Status::INVALID, 0, reason);
+    }
+
+    void step()
+    {
+        if (++m_steps > m_stepLimit)
+            halt(InterpreterResult::Status::STEP_LIMIT, 0, "limite d'instructions atteinte");
+    }
+
+    Value *findVariable(const std::string &name)
+    {
+        for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it)
+        {
+            auto found = it->find(name);
+            if (found != it->end())
+                return &found->second;
+        }
+        return nullptr;
+    }
+
+    long long asNumber(const Value &value)
+    {
+        if (value.array >= 0)
+            invalid("tableau utilisé comme entier");
+        return value.number;
+    }
+
+    ArrayObject &asArray(const Value &value)
+    {
+        if (value.array < 0)
+            invalid("entier utilisé comme tableau");
+        return m_arrays[value.array];
+    }
+
+    /**
+     * @brief Vérifie un indice comme le fait `cmp rax, [rbx-8]; jae` (non signé)
+     */
+    void checkIndex(long long index, long long size)
+    {
+        if (static_cast<unsigned long long>(index) >= static_cast<unsigned long long>(size))
+            halt(InterpreterResult::Status::EXITED, 1, MSG_BOUNDS);
+    }
+
+    Value &matrixElement(const Value &matrixValue, long long row, long long col)
+    {
+        ArrayObject &matrix = asArray(matrixValue);
+        checkIndex(row, matrix.rows);
+        checkIndex(col, matrix.cols);
+        return matrix.elements[row * matrix.cols + col];
+    }
+
+    static long long wrap(unsigned long long value)
+    {
+        return static_cast<long long>(value);
+    }
+
+    /**
+     * @brief Résultat d'une opération : arrêt comme yb_rt_overflow_trap en mode vérifié
+     */
+    long long checked(bool overflow, long long wrapped)
+    {
+        if (overflow && m_checkedArithmetic)
+            halt(InterpreterResult::Status::EXITED, 1, MSG_OVERFLOW);
+        return wrapped;
+    }
+
+    Value evaluate(const std::shared_ptr<Expr> &expr)
+    {
+        switch (expr->getType())
+        {
+        case ExprType::INTEGER:
+        {
+            const std::string &text = *static_cast<const IntExpr *>(expr.get())->token.value;
+            try
+            {
+                return {std::stoll(text), -1};
+            }
+            catch (const std::exception &)
+            {
+                invalid("littéral entier hors de l'intervalle 64 bits: " + text);
+            }
+        }
+        case ExprType::VARIABLE:
+        {
+            const std::string &name = *static_cast<const VarExpr *>(expr.get())->token.value;
+            Value *variable = findVariable(name);
+            if (!variable)
+                invalid("variable non déclarée: " + name);
+            return *variable;
+        }
+        case ExprType::BINARY:
+        {
+            auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+            // Même ordre que le code généré : droite puis gauche
+            long long droite = asNumber(evaluate(binExpr->droite));
+            long long gauche = asNumber(evaluate(binExpr->gauche));
+            unsigned long long a = static_cast<unsigned long long>(gauche);
+            unsigned long long b = static_cast<unsigned long long>(droite);
+            long long result;
+            switch (binExpr->op)
+            {
+            case BinaryOpType::ADD:
+                return {checked(__builtin_add_overflow(gauche, droite, &result), wrap(a + b)), -1};
+            case BinaryOpType::SUB:
+                return {checked(__builtin_sub_overflow(gauche, droite, &result), wrap(a - b)), -1};
+            case BinaryOpType::MUL:
+                return {checked(__builtin_mul_overflow(gauche, droite, &result), wrap(a * b)), -1};
+            case BinaryOpType::DIV:
+            case BinaryOpType::MOD:
+                // idiv lève #DE pour un diviseur nul et pour INT64_MIN / -1
+                if (droite == 0 || (gauche == std::numeric_limits<long long>::min() && droite == -1))
+                    halt(InterpreterResult::Status::SIGNALED, SIGFPE);
+                return {binExpr->op == BinaryOpType::DIV ? gauche / droite : gauche % droite, -1};
+            case BinaryOpType::EQUAL:
+                return {gauche == droite, -1};
+            case BinaryOpType::NOT_EQUAL:
+                return {gauche != droite, -1};
+            case BinaryOpType::GREAT:
+                return {gauche > droite, -1};
+            case BinaryOpType::LESS:
+                return {gauche < droite, -1};
+            case BinaryOpType::GREAT_EQUAL:
+                return {gauche >= droite, -1};
+            case BinaryOpType::LESS_EQUAL:
+                return {gauche <= droite, -1};
+            case BinaryOpType::AND:
+                return {wrap(a & b), -1};
+            case BinaryOpType::OR:
+                return {wrap(a | b), -1};
+            }
+            invalid("opérateur inconnu");
+        }
+        case ExprType::ARRAY:
+        {
+            auto arrayExpr = static_cast<const ArrayExpr *>(expr.get());
+            int handle = static_cast<int>(m_arrays.size());
+            m_arrays.push_back({std::vector<Value>(arrayExpr->elements.size()), 0, 0});
+            for (size_t i = 0; i < arrayExpr->elements.size(); i++)
+            {
+                Value element = evaluate(arrayExpr->elements[i]);
+                m_arrays[handle].elements[i] = element;
+            }
+            return {0, handle};
+        }
+        case ExprType::ARRAY_ACCESS:
+        {
+            auto accessExpr = static_cast<const ArrayAccessExpr *>(expr.get());
+            Value array = evaluate(accessExpr->array);
+            long long index = asNumber(evaluate(accessExpr->index));
+            ArrayObject &object = asArray(array);
+            checkIndex(index, static_cast<long long>(object.elements.size()));
+            return object.elements[index];
+        }
+        case ExprType::LENGTH:
+        {
+            Value array = evaluate(static_cast<const LengthExpr *>(expr.get())->array);
+            return {static_cast<long long>(asArray(array).elements.size()), -1};
+        }
+        case ExprType::MATRIX:
+        {
+            auto matrixExpr = static_cast<const MatrixExpr *>(expr.get());
+            long long cols = asNumber(evaluate(matrixExpr->cols));
+            long long rows = asNumber(evaluate(matrixExpr->rows));
+            long long size = 0;
+            if (rows < 0 || cols < 0 || __builtin_mul_overflow(rows, cols, &size) || size >= (1LL << 56))
+                halt(InterpreterResult::Status::EXITED, 1, MSG_ALLOC);
+            if (size > MAX_ELEMENTS)
+                invalid("matrice trop grande pour l'interpréteur");
+            m_arrays.push_back({std::vector<Value>(size), rows, cols});
+            return {0, static_cast<int>(m_arrays.size()) - 1};
+        }
+        case ExprType::MATRIX_ACCESS:
+        {
+            auto accessExpr = static_cast<const MatrixAccessExpr *>(expr.get());
+            Value matrix = evaluate(accessExpr->matrix);
+            long long row = asNumber(evaluate(accessExpr->row));
+            long long col = asNumber(evaluate(accessExpr->col));
+            return matrixElement(matrix, row, col);
+        }
+        }
+        invalid("expression inconnue");
+    }
+
+    void executeBlock(const BlockStmt *block)
+    {
+        m_scopes.push_back({});
+        for (const auto &stmt : block->statements)
+            execute(stmt);
+        m_scopes.pop_back();
+    }
+
+    void execute(const std::shared_ptr<Stmt> &stmt)
+    {
+        step();
+        switch (stmt->getType())
+        {
+        case StmtType::EXIT:
+        {
+            long long code = asNumber(evaluate(static_cast<const ExitStmt *>(stmt.get())->expr));
+            halt(InterpreterResult::Status::EXITED, static_cast<int>(code & 0xff));
+        }
+        case StmtType::LET:
+        {
+            auto letStmt = static_cast<const LetStmt *>(stmt.get());
+            // L'expression est évaluée avant la déclaration : `let x = x + 1` lit le x englobant
+            Value value = evaluate(letStmt->expr);
+            m_scopes.back()[*letStmt->var.value] = value;
+            break;
+        }
+        case StmtType::ASSIGN:
+        {
+            auto assignStmt = static_cast<const AssignStmt *>(stmt.get());
+            Value *variable = findVariable(*assignStmt->var.value);
+            if (!variable)
+                invalid("affectation d'une variable non déclarée: " + *assignStmt->var.value);
+            Value value = evaluate(assignStmt->expr);
+            *findVariable(*assignStmt->var.value) = value;
+            break;
+        }
+        case StmtType::BLOCK:
+            executeBlock(static_cast<const BlockStmt *>(stmt.get()));
+            break;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+            if (asNumber(evaluate(ifStmt->condition)) != 0)
+                executeBlock(ifStmt->thenBranch.get());
+            else if (ifStmt->elseBranch)
+                executeBlock(ifStmt->elseBranch.get());
+            break;
+        }
+        case StmtType::MATCH:
+        {
+            auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+            long long subject = asNumber(evaluate(matchStmt->subject));
+            const BlockStmt *chosen = matchStmt->defaultBranch.get();
+            for (const MatchArm &arm : matchStmt->arms)
+                if (std::find(arm.values.begin(), arm.values.end(), subject) != arm.values.end())
+                    chosen = arm.body.get();
+            if (chosen)
+                executeBlock(chosen);
+            break;
+        }
+        case StmtType::WHILE:
+        {
+            auto whileStmt = static_cast<const WhileStmt *>(stmt.get());
+            while (asNumber(evaluate(whileStmt->condition)) != 0)
+            {
+                step();
+                executeBlock(whileStmt->body.get());
+            }
+            break;
+        }
+        case StmtType::PRINT:
+        {
+            // Toutes les valeurs sont évaluées avant d'écrire la ligne, comme avant l'appel
+            // à yb_rt_print_list
+            auto printStmt = static_cast<const PrintStmt *>(stmt.get());
+            std::vector<Value> values;
+            for (const auto &arg : printStmt->args)
+            {
+                values.push_back(evaluate(arg.expr));
+                if (arg.array != (values.back().array >= 0))
+                    invalid(arg.array ? "entier affiché comme tableau" : "tableau affiché");
+            }
+
+            std::string line;
+            for (const Value &value : values)
+            {
+                if (value.array < 0)
+                {
+                    line += std::to_string(value.number) + ' ';
+                    continue;
+                }
+                for (const Value &element : m_arrays[value.array].elements)
+                    line += std::to_string(asNumber(element)) + ' ';
+            }
+            if (!line.empty())
+                line.pop_back();
+            m_result.output += line;
+            m_result.output += '\n';
+            break;
+        }
+        case StmtType::ARRAY_ASSIGN:
+        {
+            auto assignStmt = static_cast<const ArrayAssignStmt *>(stmt.get());
+            Value value = evaluate(assignStmt->value);
+            Value array = evaluate(assignStmt->array);
+            long long index = asNumber(evaluate(assignStmt->index));
+            ArrayObject &object = asArray(array);
+            checkIndex(index, static_cast<long long>(object.elements.size()));
+            object.elements[index] = value;
+            break;
+        }
+        case StmtType::MATRIX_ASSIGN:
+        {
+            auto assignStmt = static_cast<const MatrixAssignStmt *>(stmt.get());
+            Value value = evaluate(assignStmt->value);
+            Value matrix = evaluate(assignStmt->matrix);
+            long long row = asNumber(evaluate(assignStmt->row));
+            long long col = asNumber(evaluate(assignStmt->col));
+            matrixElement(matrix, row, col) = value;
+            break;
+        }
+        case StmtType::PARAM:
+            invalid("param: les arguments ne sont fournis qu'en bibliotheque partagee");
+        default:
+            invalid("instruction non supportée");
+        }
+    }
+
+    const Program &m_program;
+    long long m_stepLimit;
+    bool m_checkedArithmetic;
+    long long m_steps = 0;
+    InterpreterResult m_result;
+    std::vector<std::unordered_map<std::string, Value>> m_scopes;
+    std::vector<ArrayObject> m_arrays;
+};
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "Parser.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file Lowering.hpp
+ * @brief Représentation intermédiaire indépendante de la cible et traduction de l'AST.
+ *
+ * Chaque instruction de premier niveau est traduite en une suite d'instructions d'une
+ * machine à pile (IrStatement) : les expressions empilent leur résultat, les opérations
+ * dépilent leurs opérandes. La profondeur de pile est connue à chaque instruction et est
+ * nulle à chaque label et à chaque saut : un backend peut donc associer chaque niveau de
+ * pile à un registre. Les variables sont des emplacements numérotés à partir de 1, réutilisés
+ * à la sortie de leur bloc comme les emplacements [rbp-N] du Generator x86-64.
+ *
+ * L'ordre d'évaluation est celui du Generator x86-64 et de l'Interpreter (opérande droit
+ * d'une expression binaire avant le gauche, valeur avant la destination d'une affectation
+ * d'élément) : les erreurs d'exécution arrivent dans le même ordre sur toutes les cibles.
+ */
+
+/**
+ * @brief Opérations de la représentation intermédiaire
+ */
+enum class IrOp
+{
+    CONST,                // Empile value
+    LOAD,                 // Empile la variable d'emplacement value
+    STORE,                // Dépile dans la variable d'emplacement value
+    BINARY,               // Dépile gauche puis droite, empile gauche binaryOp droite (division par zéro : SIGFPE)
+    LABEL,                // Label numéro value
+    JUMP,                 // Saut vers le label value
+    JUMP_IF_ZERO,         // Dépile, saute vers le label value si la valeur est nulle
+    NEW_ARRAY,            // Empile un tableau de value éléments
+    INIT_ELEMENT,         // Dépile une valeur et la range à l'indice value du tableau au sommet
+    NEW_MATRIX,           // Dépile lignes puis colonnes, empile la matrice (dimensions contrôlées)
+    LOAD_ELEMENT,         // Dépile indice puis tableau, empile l'élément (indice contrôlé)
+    STORE_ELEMENT,        // Dépile indice, tableau puis valeur, range la valeur
+    LOAD_MATRIX_ELEMENT,  // Dépile colonne, ligne puis matrice, empile l'élément
+    STORE_MATRIX_ELEMENT, // Dépile colonne, ligne, matrice puis valeur, range la valeur
+    LENGTH,               // Remplace le tableau au sommet par sa longueur
+    PRINT,                // Dépile arrays.size() valeurs (la première empilée est affichée en premier)
+    EXIT,                 // Dépile le code de retour et termine le programme
+};
+
+/**
+ * @brief Instruction de la représentation intermédiaire
+ */
+struct IrInstr
+{
+    IrOp op;
+    long long value = 0;                       /**< Constante, emplacement, label, taille ou indice */
+    BinaryOpType binaryOp = BinaryOpType::ADD; /**< Opération de BINARY */
+    bool checked = false;                      /**< BINARY : arrêter le programme sur un dépassement */
+    std::vector<bool> arrays;                  /**< PRINT : nature de chaque valeur (true : tableau) */
+
+    IrInstr(IrOp op, long long value = 0) : op(op), value(value) {}
+};
+
+/**
+ * @brief Code d'une instruction de premier niveau
+ */
+struct IrStatement
+{
+    int line = 0; /**< Ligne du source */
+    std::vector<IrInstr> code;
+};
+
+/**
+ * @class Lowering
+ * @brief Traduit les instructions de premier niveau, dans l'ordre, en IrStatement
+ *
+ * Comme le Generator, la traduction est incrémentale : seules les tables de symboles
+ * sont gardées d'une instruction à la suivante.
+ */
+class Lowering
+{
+public:
+    /**
+     * @param checkedArithmetic Sémantique de --checked-arith pour +, - et *
+     */
+    explicit Lowering(bool checkedArithmetic = false) : m_checkedArithmetic(checkedArithmetic) {}
+
+    /**
+     * @brief Traduit une instruction de premier niveau
+     */
+    IrStatement lower(const std::shared_ptr<Stmt> &stmt)
+    {
+        IrStatement statement;
+        statement.line = stmt->line;
+        lowerStatement(stmt, statement.code);
+        return statement;
+    }
+
+    /**
+     * @brief Nombre d'emplacements de variables utilisés jusqu'ici (numérotés de 1 à slotCount)
+     */
+    int slotCount() const
+    {
+        return m_maxSlot;
+    }
+
+    /**
+     * @brief Indique qu'une instruction n'a pas pu être traduite pour cette cible
+     */
+    bool failed() const
+    {
+        return m_failed;
+    }
+
+private:
+    void lowerStatement(const std::shared_ptr<Stmt> &stmt, std::vector<IrInstr> &code)
+    {
+        switch (stmt->getType())
+        {
+        case StmtType::EXIT:
+            lowerExpression(static_cast<const ExitStmt *>(stmt.get())->expr, code);
+            code.push_back({IrOp::EXIT});
+            break;
+        case StmtType::LET:
+        {
+            auto letStmt = static_cast<const LetStmt *>(stmt.get());
+            // L'expression est traduite avant la déclaration : `let x = x + 1` lit le x englobant
+            lowerExpression(letStmt->expr, code);
+            code.push_back({IrOp::STORE, declare(*letStmt->var.value)});
+            break;
+        }
+        case StmtType::ASSIGN:
+        {
+            auto assignStmt = static_cast<const AssignStmt *>(stmt.get());
+            int slot = lookup(*assignStmt->var.value);
+            if (slot == 0)
+            {
+                std::cerr << "Erreur: Variable non déclarée : " << *assignStmt->var.value << std::endl;
+                break;
+            }
+            lowerExpression(assignStmt->expr, code);
+            code.push_back({IrOp::STORE, slot});
+            break;
+        }
+        case StmtType::BLOCK:
+            lowerBlock(static_cast<const BlockStmt *>(stmt.get()), code);
+            break;
+        case StmtType::IF:
+        {
+            auto ifStmt = static_cast<const IfStmt *>(stmt.get());
+            long long elseLabel = m_labelCounter++;
+            lowerExpression(ifStmt->condition, code);
+            code.push_back({IrOp::JUMP_IF_ZERO, elseLabel});
+            lowerBlock(ifStmt->thenBranch.get(), code);
+            if (ifStmt->elseBranch)
+            {
+                long long endLabel = m_labelCounter++;
+                code.push_back({IrOp::JUMP, endLabel});
+                code.push_back({IrOp::LABEL, elseLabel});
+                lowerBlock(ifStmt->elseBranch.get(), code);
+                code.push_back({IrOp::LABEL, endLabel});
+            }
+            else
+                code.push_back({IrOp::LABEL, elseLabel});
+            break;
+        }
+        case StmtType::WHILE:
+        {
+            auto whileStmt = static_cast<const WhileStmt *>(stmt.get());
+            long long startLabel = m_labelCounter++;
+            long long endLabel = m_labelCounter++;
+            code.push_back({IrOp::LABEL, startLabel});
+            lowerExpression(whileStmt->condition, code);
+            code.push_back({IrOp::JUMP_IF_ZERO, endLabel});
+            lowerBlock(whileStmt->body.get(), code);
+            code.push_back({IrOp::JUMP, startLabel});
+            code.push_back({IrOp::LABEL, endLabel});
+            break;
+        }
+        case StmtType::MATCH:
+        {
+            // La valeur est rangée dans un emplacement caché, puis comparée à chaque cas
+            auto matchStmt = static_cast<const MatchStmt *>(stmt.get());
+            int slotTop = m_slotTop;
+            int subject = ++m_slotTop;
+            m_maxSlot = std::max(m_maxSlot, subject);
+            lowerExpression(matchStmt->subject, code);
+            code.push_back({IrOp::STORE, subject});
+
+            long long firstArm = m_labelCounter;
+            m_labelCounter += static_cast<long long>(matchStmt->arms.size());
+            long long defaultLabel = m_labelCounter++;
+            long long endLabel = m_labelCounter++;
+            for (size_t arm = 0; arm < matchStmt->arms.size(); arm++)
+                for (long long value : matchStmt->arms[arm].values)
+                {
+                    IrInstr notEqual{IrOp::BINARY};
+                    notEqual.binaryOp = BinaryOpType::NOT_EQUAL;
+                    code.push_back({IrOp::CONST, value});
+                    code.push_back({IrOp::LOAD, subject});
+                    code.push_back(std::move(notEqual));
+                    code.push_back({IrOp::JUMP_IF_ZERO, firstArm + static_cast<long long>(arm)});
+                }
+            code.push_back({IrOp::JUMP, defaultLabel});
+            for (size_t arm = 0; arm < matchStmt->arms.size(); arm++)
+            {
+                code.push_back({IrOp::LABEL, firstArm + static_cast<long long>(arm)});
+                lowerBlock(matchStmt->arms[arm].body.get(), code);
+                code.push_back({IrOp::JUMP, endLabel});
+            }
+            code.push_back({IrOp::LABEL, defaultLabel});
+            if (matchStmt->defaultBranch)
+                lowerBlock(matchStmt->defaultBranch.get(), code);
+            code.push_back({IrOp::LABEL, endLabel});
+            m_slotTop = slotTop;
+            break;
+        }
+        case StmtType::PRINT:
+        {
+            IrInstr print{IrOp::PRINT};
+            for (const auto &arg : static_cast<const PrintStmt *>(stmt.get())->args)
+            {
+                lowerExpression(arg.expr, code);
+                print.arrays.push_back(arg.array);
+            }
+            code.push_back(std::move(print));
+            break;
+        }
+        case StmtType::ARRAY_ASSIGN:
+        {
+            auto assignStmt = static_cast<const ArrayAssignStmt *>(stmt.get());
+            lowerExpression(assignStmt->value, code);
+            lowerExpression(assignStmt->array, code);
+            lowerExpression(assignStmt->index, code);
+            code.push_back({IrOp::STORE_ELEMENT});
+            break;
+        }
+        case StmtType::MATRIX_ASSIGN:
+        {
+            auto assignStmt = static_cast<const MatrixAssignStmt *>(stmt.get());
+            lowerExpression(assignStmt->value, code);
+            lowerExpression(assignStmt->matrix, code);
+            lowerExpression(assignStmt->row, code);
+            lowerExpression(assignStmt->col, code);
+            code.push_back({IrOp::STORE_MATRIX_ELEMENT});
+            break;
+        }
+        case StmtType::PARAM:
+            // Les arguments n'existent qu'en bibliothèque partagée, que seule la cible x86-64 produit
+            std::cerr << "Erreur: param n'est disponible qu'avec --shared (ligne " << stmt->line << ")" << std::endl;
+            m_failed = true;
+            break;
+        default:
+            std::cerr << "Erreur: instruction non supportee par cette cible (ligne " << stmt->line << ")" << std::endl;
+            m_failed = true;
+            break;
+        }
+    }
+
+    void lowerBlock(const BlockStmt *block, std::vector<IrInstr> &code)
+    {
+        // Les emplacements du bloc sont réutilisés après sa fin
+        m_scopes.push_back({});
+        int slotTop = m_slotTop;
+        for (const auto &stmt : block->statements)
+            lowerStatement(stmt, code);
+        m_slotTop = slotTop;
+        m_scopes.pop_back();
+    }
+
+    void lowerExpression(const std::shared_ptr<Expr> &expr, std::vector<IrInstr> &code)
+    {
+        switch (expr->getType())
+        {
+        case ExprType::INTEGER:
+        {
+            // Comme nasm, un littéral est pris modulo 2^64
+            const std::string &text = *static_cast<const IntExpr *>(expr.get())->token.value;
+            code.push_back({IrOp::CONST, static_cast<long long>(std::strtoull(text.c_str(), nullptr, 10))});
+            break;
+        }
+        case ExprType::VARIABLE:
+        {
+            // Une variable non déclarée vaut 0, comme dans le Generator x86-64
+            int slot = lookup(*static_cast<const VarExpr *>(expr.get())->token.value);
+            code.push_back(slot ? IrInstr{IrOp::LOAD, slot} : IrInstr{IrOp::CONST, 0});
+            break;
+        }
+        case ExprType::BINARY:
+        {
+            auto binExpr = static_cast<const BinaryExpr *>(expr.get());
+            lowerExpression(binExpr->droite, code);
+            lowerExpression(binExpr->gauche, code);
+            IrInstr instr{IrOp::BINARY};
+            instr.binaryOp = binExpr->op;
+            instr.checked = m_checkedArithmetic && (binExpr->op == BinaryOpType::ADD ||
+                                                    binExpr->op == BinaryOpType::SUB ||
+                                                    binExpr->op == BinaryOpType::MUL);
+            code.push_back(std::move(instr));
+            break;
+        }
+        case ExprType::ARRAY:
+        {
+            auto arrayExpr = static_cast<const ArrayExpr *>(expr.get());
+            code.push_back({IrOp::NEW_ARRAY, static_cast<long long>(arrayExpr->elements.size())});
+            for (size_t i = 0; i < arrayExpr->elements.size(); i++)
+            {
+                lowerExpression(arrayExpr->elements[i], code);
+                code.push_back({IrOp::INIT_ELEMENT, static_cast<long long>(i)});
+            }
+            break;
+        }
+        case ExprType::ARRAY_ACCESS:
+        {
+            auto accessExpr = static_cast<const ArrayAccessExpr *>(expr.get());
+            lowerExpression(accessExpr->array, code);
+            lowerExpression(accessExpr->index, code);
+            code.push_back({IrOp::LOAD_ELEMENT});
+            break;
+        }
+        case ExprType::LENGTH:
+            lowerExpression(static_cast<const LengthExpr *>(expr.get())->array, code);
+            code.push_back({IrOp::LENGTH});
+            break;
+        case ExprType::MATRIX:
+        {
+            auto matrixExpr = static_cast<const MatrixExpr *>(expr.get());
+            lowerExpression(matrixExpr->cols, code);
+            lowerExpression(matrixExpr->rows, code);
+            code.push_back({IrOp::NEW_MATRIX});
+            break;
+        }
+        case ExprType::MATRIX_ACCESS:
+        {
+            auto accessExpr = static_cast<const MatrixAccessExpr *>(expr.get());
+            lowerExpression(accessExpr->matrix, code);
+            lowerExpression(accessExpr->row, code);
+            lowerExpression(accessExpr->col, code);
+            code.push_back({IrOp::LOAD_MATRIX_ELEMENT});
+            break;
+        }
+        }
+    }
+
+    /**
+     * @brief Emplacement d'une variable déclarée dans le bloc courant (nouveau si besoin)
+     */
+    int declare(const std::string &name)
+    {
+        auto found = m_scopes.back().find(name);
+        if (found != m_scopes.back().end())
+            return found->second;
+        int slot = ++m_slotTop;
+        m_maxSlot = std::max(m_maxSlot, slot);
+        m_scopes.back()[name] = slot;
+        return slot;
+    }
+
+    /**
+     * @brief Emplacement de la variable visible sous ce nom, 0 si elle n'est pas déclarée
+     */
+    int lookup(const std::string &name) const
+    {
+        for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it)
+        {
+            auto found = it->find(name);
+            if (found != it->end())
+                return found->second;
+        }
+        return 0;
+    }
+
+    bool m_checkedArithmetic;
+    std::vector<std::unordered_map<std::string, int>> m_scopes{1};
+    int m_slotTop = 0;          ///< Dernier emplacement utilisé par les blocs ouverts
+    int m_maxSlot = 0;          ///< Plus grand emplacement utilisé
+    long long m_labelCounter = 0;
+    bool m_failed = false;      ///< Une instruction n'a pas pu être traduite
+};
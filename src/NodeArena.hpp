@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @file NodeArena.hpp
+ * @brief Allocation des nœuds de l'AST par blocs.
+ *
+ * Le Parser crée ses nœuds avec std::allocate_shared et un ArenaAllocator : le nœud et
+ * son bloc de contrôle sont pris dans un bloc de l'arène par simple incrément, sans appel
+ * à malloc. Chaque bloc de contrôle garde une référence sur l'arène, qui est libérée avec
+ * le dernier nœud : les std::shared_ptr de l'AST s'utilisent comme avant.
+ */
+
+/**
+ * @class NodeArena
+ * @brief Réserve des blocs de taille croissante et y découpe les allocations
+ *
+ * La libération individuelle ne fait rien : toute la mémoire est rendue à la destruction
+ * de l'arène, ou réutilisée par reset() quand plus aucun nœud ne l'utilise.
+ * Une arène n'est utilisée que par un thread à la fois pour allouer.
+ */
+class NodeArena
+{
+public:
+    /**
+     * @brief Réserve `size` octets alignés sur `alignment` (puissance de deux, au plus 16)
+     */
+    void *allocate(size_t size, size_t alignment)
+    {
+        size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+        if (m_chunks.empty() || offset + size > m_chunkSize)
+        {
+            m_chunkSize = std::max(size, std::min(m_chunkSize * 2, MAX_CHUNK_SIZE));
+            m_chunks.emplace_back(new char[m_chunkSize]);
+            offset = 0;
+        }
+        m_used = offset + size;
+        return m_chunks.back().get() + offset;
+    }
+
+    /**
+     * @brief Rend toute la mémoire réutilisable (aucun nœud ne doit plus l'utiliser)
+     *
+     * Seul le dernier bloc, le plus grand, est gardé.
+     */
+    void reset()
+    {
+        if (m_chunks.size() > 1)
+            m_chunks.erase(m_chunks.begin(), m_chunks.end() - 1);
+        m_used = 0;
+    }
+
+private:
+    static constexpr size_t FIRST_CHUNK_SIZE = 4 * 1024;
+    static constexpr size_t MAX_CHUNK_SIZE = 256 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    size_t m_chunkSize = FIRST_CHUNK_SIZE / 2; ///< Taille du dernier bloc (doublée au bloc suivant)
+    size_t m_used = 0;                         ///< Octets utilisés dans le dernier bloc
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief Allocateur standard qui prend sa mémoire dans une NodeArena partagée
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(std::shared_ptr<NodeArena> arena) : m_arena(std::move(arena)) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : m_arena(other.arena()) {}
+
+    T *allocate(size_t count)
+    {
+        return static_cast<T *>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t) {}
+
+    const std::shared_ptr<NodeArena> &arena() const { return m_arena; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return m_arena == other.arena(); }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return m_arena != other.arena(); }
+
+private:
+    std::shared_ptr<NodeArena> m_arena;
+};
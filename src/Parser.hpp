@@ -1,10 +1,16 @@
 #pragma once
 
 #include "Tokenizer.hpp"
+#include "NodeArena.hpp"
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <optional>
 #include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <charconv>
 
 /**
  * @brief Classe représentant un programme contenant des instructions.
@@ -62,6 +68,8 @@ enum class ExprType
     ARRAY,        // Expression de tableau (ex: array[0])
     ARRAY_ACCESS, // Accès à un élément de tableau (ex: array[0])
     LENGTH,
+    MATRIX,        // Création d'une matrice (ex: matrix(3, 4))
+    MATRIX_ACCESS, // Accès à un élément de matrice (ex: m[i][j])
 
 };
 
@@ -79,6 +87,9 @@ enum class StmtType
     ASSIGN,       // Affectation var = expr
     PRINT,        // Instruction d'affichage print(expr)
     ARRAY_ASSIGN, // Affectation d'un élément de tableau array[index] = expr
+    MATRIX_ASSIGN, // Affectation d'un élément de matrice m[ligne][colonne] = expr
+    PARAM,        // Paramètre du noyau param n; ou param t[]; (option --shared)
+    MATCH,        // Aiguillage match (expr) { 0 => { ... } 1, 2 => { ... } _ => { ... } }
 };
 
 /**
@@ -117,7 +128,7 @@ struct IntExpr : public Expr
 {
     Token token;
 
-    IntExpr(Token token) : token(token) {}
+    IntExpr(Token token) : token(std::move(token)) {}
     ExprType getType() const override { return ExprType::INTEGER; }
 };
 
@@ -128,7 +139,7 @@ struct VarExpr : public Expr
 {
     Token token;
 
-    VarExpr(Token token) : token(token) {}
+    VarExpr(Token token) : token(std::move(token)) {}
     ExprType getType() const override { return ExprType::VARIABLE; }
 };
 
@@ -142,7 +153,7 @@ struct BinaryExpr : public Expr
     BinaryOpType op;
 
     BinaryExpr(std::shared_ptr<Expr> gauche, BinaryOpType op, std::shared_ptr<Expr> droite)
-        : gauche(gauche), droite(droite), op(op) {}
+        : gauche(std::move(gauche)), droite(std::move(droite)), op(op) {}
 
     ExprType getType() const override { return ExprType::BINARY; }
 };
@@ -156,7 +167,7 @@ struct ArrayExpr : public Expr
     // Explication :
     // elements est un vecteur de pointeurs partagés vers des expressions.
     // Cela signifie que chaque élément du tableau peut être une expression entier, variable, et et oui meme une expression binaire
-    ArrayExpr(std::vector<std::shared_ptr<Expr>> elements) : elements(elements) {}
+    ArrayExpr(std::vector<std::shared_ptr<Expr>> elements) : elements(std::move(elements)) {}
     ExprType getType() const override { return ExprType::ARRAY; }
 };
 
@@ -169,7 +180,7 @@ struct ArrayAccessExpr : public Expr
     std::shared_ptr<Expr> index; // le nom le dit non
 
     ArrayAccessExpr(std::shared_ptr<Expr> array, std::shared_ptr<Expr> index)
-        : array(array), index(index) {}
+        : array(std::move(array)), index(std::move(index)) {}
 
     ExprType getType() const override { return ExprType::ARRAY_ACCESS; }
 };
@@ -179,11 +190,43 @@ struct LengthExpr : public Expr
 {
     std::shared_ptr<Expr> array;
 
-    LengthExpr(std::shared_ptr<Expr> array) : array(array) {}
+    LengthExpr(std::shared_ptr<Expr> array) : array(std::move(array)) {}
 
     ExprType getType() const override { return ExprType::LENGTH; }
 };
 
+/**
+ * @brief Création d'une matrice (ex: matrix(lignes, colonnes))
+ *
+ * Les éléments sont stockés de façon contiguë, ligne par ligne, dans une seule
+ * allocation. Le nombre de lignes et de colonnes est gardé dans l'en-tête.
+ */
+struct MatrixExpr : public Expr
+{
+    std::shared_ptr<Expr> rows;
+    std::shared_ptr<Expr> cols;
+
+    MatrixExpr(std::shared_ptr<Expr> rows, std::shared_ptr<Expr> cols)
+        : rows(std::move(rows)), cols(std::move(cols)) {}
+
+    ExprType getType() const override { return ExprType::MATRIX; }
+};
+
+/**
+ * @brief Accès à un élément de matrice (ex: m[i][j])
+ */
+struct MatrixAccessExpr : public Expr
+{
+    std::shared_ptr<Expr> matrix;
+    std::shared_ptr<Expr> row;
+    std::shared_ptr<Expr> col;
+
+    MatrixAccessExpr(std::shared_ptr<Expr> matrix, std::shared_ptr<Expr> row, std::shared_ptr<Expr> col)
+        : matrix(std::move(matrix)), row(std::move(row)), col(std::move(col)) {}
+
+    ExprType getType() const override { return ExprType::MATRIX_ACCESS; }
+};
+
 /**
  * @brief Classe de base pour toutes les instructions
  */
@@ -191,6 +234,8 @@ struct Stmt
 {
     virtual ~Stmt() = default;
     virtual StmtType getType() const = 0;
+
+    int line = 0; /**< Ligne du source où commence l'instruction */
 };
 
 /**
@@ -201,7 +246,7 @@ struct ExitStmt : public Stmt
 {
     std::shared_ptr<Expr> expr;
 
-    ExitStmt(std::shared_ptr<Expr> expr) : expr(expr) {}
+    ExitStmt(std::shared_ptr<Expr> expr) : expr(std::move(expr)) {}
     StmtType getType() const override { return StmtType::EXIT; }
 };
 
@@ -214,7 +259,7 @@ struct LetStmt : public Stmt
     Token var;
     std::shared_ptr<Expr> expr;
 
-    LetStmt(Token var, std::shared_ptr<Expr> expr) : var(var), expr(expr) {}
+    LetStmt(Token var, std::shared_ptr<Expr> expr) : var(std::move(var)), expr(std::move(expr)) {}
     StmtType getType() const override { return StmtType::LET; }
 };
 
@@ -227,7 +272,7 @@ struct BlockStmt : public Stmt
     // C'est un vecteur d'instructions qui vont etre dans le bloc
     std::vector<std::shared_ptr<Stmt>> statements;
 
-    BlockStmt(std::vector<std::shared_ptr<Stmt>> statements) : statements(statements) {}
+    BlockStmt(std::vector<std::shared_ptr<Stmt>> statements) : statements(std::move(statements)) {}
     StmtType getType() const override { return StmtType::BLOCK; }
 };
 
@@ -238,7 +283,7 @@ struct IfStmt : public Stmt
     std::shared_ptr<BlockStmt> elseBranch;
 
     IfStmt(std::shared_ptr<Expr> condition, std::shared_ptr<BlockStmt> thenBranch, std::shared_ptr<BlockStmt> elseBranch = nullptr)
-        : condition(condition), thenBranch(thenBranch), elseBranch(elseBranch) {}
+        : condition(std::move(condition)), thenBranch(std::move(thenBranch)), elseBranch(std::move(elseBranch)) {}
 
     StmtType getType() const override { return StmtType::IF; }
 };
@@ -247,7 +292,7 @@ struct ElseStmt : public Stmt
 {
     std::shared_ptr<BlockStmt> elseBranch;
 
-    ElseStmt(std::shared_ptr<BlockStmt> elseBranch) : elseBranch(elseBranch) {}
+    ElseStmt(std::shared_ptr<BlockStmt> elseBranch) : elseBranch(std::move(elseBranch)) {}
 
     StmtType getType() const override { return StmtType::ELES; }
 };
@@ -258,25 +303,64 @@ struct WhileStmt : public Stmt
     std::shared_ptr<BlockStmt> body;
 
     WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<BlockStmt> body)
-        : condition(condition), body(body) {}
+        : condition(std::move(condition)), body(std::move(body)) {}
 
     StmtType getType() const override { return StmtType::WHILE; }
 };
 
+/**
+ * @brief Branche d'un match : les valeurs entières qui la choisissent et son bloc
+ */
+struct MatchArm
+{
+    std::vector<long long> values;
+    std::shared_ptr<BlockStmt> body;
+};
+
+/**
+ * @brief match (expr) { ... } : exécute la branche dont une valeur est égale à expr
+ *
+ * Les valeurs sont distinctes. Sans branche égale, le bloc `_` (defaultBranch) est
+ * exécuté s'il existe, sinon rien.
+ */
+struct MatchStmt : public Stmt
+{
+    std::shared_ptr<Expr> subject;
+    std::vector<MatchArm> arms;
+    std::shared_ptr<BlockStmt> defaultBranch;
+
+    MatchStmt(std::shared_ptr<Expr> subject, std::vector<MatchArm> arms, std::shared_ptr<BlockStmt> defaultBranch)
+        : subject(std::move(subject)), arms(std::move(arms)), defaultBranch(std::move(defaultBranch)) {}
+
+    StmtType getType() const override { return StmtType::MATCH; }
+};
+
 struct AssignStmt : public Stmt
 {
     Token var;
     std::shared_ptr<Expr> expr;
 
-    AssignStmt(Token var, std::shared_ptr<Expr> expr) : var(var), expr(expr) {}
+    AssignStmt(Token var, std::shared_ptr<Expr> expr) : var(std::move(var)), expr(std::move(expr)) {}
     StmtType getType() const override { return StmtType::ASSIGN; }
 };
 
-struct PrintStmt : public Stmt
+/**
+ * @brief Valeur affichée par print : un entier, ou tous les éléments d'un tableau
+ */
+struct PrintArg
 {
     std::shared_ptr<Expr> expr;
+    bool array; // Le parser sait que l'expression désigne un tableau ou une matrice
+};
 
-    PrintStmt(std::shared_ptr<Expr> expr) : expr(expr) {}
+/**
+ * @brief print(a, b, ...) : les valeurs sont écrites sur une ligne, séparées par un espace
+ */
+struct PrintStmt : public Stmt
+{
+    std::vector<PrintArg> args;
+
+    PrintStmt(std::vector<PrintArg> args) : args(std::move(args)) {}
     StmtType getType() const override { return StmtType::PRINT; }
 };
 
@@ -287,11 +371,40 @@ struct ArrayAssignStmt : public Stmt
     std::shared_ptr<Expr> value;
 
     ArrayAssignStmt(std::shared_ptr<Expr> array, std::shared_ptr<Expr> index, std::shared_ptr<Expr> value)
-        : array(array), index(index), value(value) {}
+        : array(std::move(array)), index(std::move(index)), value(std::move(value)) {}
 
     StmtType getType() const override { return StmtType::ARRAY_ASSIGN; }
 };
 
+struct MatrixAssignStmt : public Stmt
+{
+    std::shared_ptr<Expr> matrix;
+    std::shared_ptr<Expr> row;
+    std::shared_ptr<Expr> col;
+    std::shared_ptr<Expr> value;
+
+    MatrixAssignStmt(std::shared_ptr<Expr> matrix, std::shared_ptr<Expr> row, std::shared_ptr<Expr> col,
+                     std::shared_ptr<Expr> value)
+        : matrix(std::move(matrix)), row(std::move(row)), col(std::move(col)), value(std::move(value)) {}
+
+    StmtType getType() const override { return StmtType::MATRIX_ASSIGN; }
+};
+
+/**
+ * @brief Instruction param n; ou param t[];
+ *
+ * Déclare une variable qui reçoit l'argument suivant de yb_main (bibliothèque partagée) :
+ * un entier, ou un tableau passé par l'adresse de son élément 0.
+ */
+struct ParamStmt : public Stmt
+{
+    Token var;
+    bool array; /**< Paramètre déclaré avec [] */
+
+    ParamStmt(Token var, bool array) : var(std::move(var)), array(array) {}
+    StmtType getType() const override { return StmtType::PARAM; }
+};
+
 /**
  * @brief Programme complet c'est une liste d'instructions donc vecteur de statements
  */
@@ -301,7 +414,7 @@ struct Program
 
     void addStatement(std::shared_ptr<Stmt> stmt)
     {
-        statements.push_back(stmt);
+        statements.push_back(std::move(stmt));
     }
 };
 
@@ -313,9 +426,13 @@ class Parser
 public:
     /**
      * @brief Constructeur du Parser
-     * @param tokens Vecteur de tokens à analyser
+     *
+     * Les tokens sont demandés à la source au fur et à mesure : aucune règle ne regarde
+     * plus loin que le token suivant, le tampon de TokenStream::peek suffit.
+     *
+     * @param tokens Source des tokens (en général un Tokenizer), qui doit rester valide pendant l'analyse
      */
-    Parser(const std::vector<Token> &tokens) : m_tokens(tokens), m_position(0) {}
+    Parser(TokenStream &tokens) : m_tokens(tokens) {}
 
     /**
      * @brief Analyse tous les tokens pour produire un programme complet
@@ -324,19 +441,55 @@ public:
     std::optional<Program> parse()
     {
         Program program;
-        m_position = 0;
+        m_depth = 0;
+        m_arrayNames.assign(1, {});
 
-        while (m_position < m_tokens.size())
+        while (hasToken())
         {
             auto stmt = parseStatement();
             if (!stmt)
                 return std::nullopt;
-            program.addStatement(stmt.value());
+            program.addStatement(std::move(*stmt));
         }
 
         return program;
     }
 
+    /**
+     * @brief Analyse l'instruction de premier niveau suivante
+     *
+     * Les tokens des instructions précédentes ne sont pas gardés : la mémoire utilisée
+     * dépend de la plus grande instruction et non de la taille du programme.
+     *
+     * @return L'instruction, ou nullopt en cas d'erreur ou à la fin du programme (voir atEnd)
+     */
+    std::optional<std::shared_ptr<Stmt>> parseNext()
+    {
+        // Plus aucun nœud n'utilise l'arène : ses blocs servent à l'instruction suivante.
+        // Avec --pipeline, les derniers nœuds sont détruits par le thread du Generator :
+        // use_count() est une lecture relâchée, la barrière acquire ordonne ces destructions
+        // (décrément release du compteur) avant la réutilisation de la mémoire.
+        if (m_arena.use_count() == 1)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            m_arena->reset();
+        }
+        else
+            m_arena = std::make_shared<NodeArena>();
+        m_depth = 0;
+        if (!hasToken())
+            return std::nullopt;
+        return parseStatement();
+    }
+
+    /**
+     * @brief Indique si tous les tokens ont été analysés
+     */
+    bool atEnd()
+    {
+        return !hasToken();
+    }
+
 private:
     // TODO: a deleter
     std::string toString(ExprType type)
@@ -358,45 +511,190 @@ private:
      */
     std::optional<std::shared_ptr<Stmt>> parseStatement()
     {
-        // TODO : Commence a grossir donc vaut mieux un switch
-        // Analyser le type d'instruction
-        if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::EXIT)
+        if (!hasToken())
         {
-            return parseExitStmt();
+            std::cerr << "Erreur: Instruction attendue" << std::endl;
+            return std::nullopt;
         }
-        else if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::LET)
+
+        int line = current().line;
+        auto stmt = parseStatementRule();
+        if (stmt)
+            (*stmt)->line = line;
+        return stmt;
+    }
+
+    /**
+     * @brief Choisit et applique la règle de l'instruction qui commence au token courant
+     */
+    std::optional<std::shared_ptr<Stmt>> parseStatementRule()
+    {
+        // Le premier token (et le suivant pour un identifiant) suffit à choisir la règle :
+        // aucune règle n'a besoin de revenir en arrière
+        switch (current().type)
         {
+        case TokenType::EXIT:
+            return parseExitStmt();
+        case TokenType::LET:
             return parseLetStmt();
-        }
-        else if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::LBRACE)
-        {
+        case TokenType::LBRACE:
             return parseBlockStmt();
-        }
-        else if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::IF)
-        {
+        case TokenType::IF:
             return parseIfStmt();
-        }
-        else if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::WHILE)
-        {
+        case TokenType::WHILE:
             return parseWhileStmt();
+        case TokenType::MATCH:
+            return parseMatchStmt();
+        case TokenType::PRINT:
+            return parsePrintStmt();
+        case TokenType::PARAM:
+            return parseParamStmt();
+        case TokenType::IDENTIFIER:
+            if (peekType(1) == TokenType::EQUAL)
+                return parseAssignStmt();
+            if (peekType(1) == TokenType::LBRACKET)
+                return parseArrayAssignStmt();
+            break;
+        default:
+            break;
         }
-        else if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::IDENTIFIER && m_position + 1 < m_tokens.size() && m_tokens[m_position + 1].type == TokenType::EQUAL)
+
+        std::cerr << "Erreur: Instruction non reconnue" << std::endl;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Type du token situé `offset` positions plus loin, UNKNOWN après la fin
+     */
+    TokenType peekType(size_t offset)
+    {
+        const Token *token = m_tokens.peek(offset);
+        return token ? token->type : TokenType::UNKNOWN;
+    }
+
+    /**
+     * @brief Indique s'il reste un token `offset` positions plus loin
+     */
+    bool hasToken(size_t offset = 0)
+    {
+        return m_tokens.peek(offset) != nullptr;
+    }
+
+    /**
+     * @brief Token courant (hasToken() doit être vrai)
+     * @note La référence n'est plus valide après advance()
+     */
+    const Token &current()
+    {
+        return *m_tokens.peek();
+    }
+
+    /**
+     * @brief Consomme le token courant
+     */
+    void advance()
+    {
+        m_tokens.next();
+    }
+
+    /**
+     * @brief Consomme le token courant et le rend, sans copier sa valeur (hasToken() doit être vrai)
+     */
+    Token take()
+    {
+        return std::move(*m_tokens.next());
+    }
+
+    /**
+     * @brief Crée un nœud de l'AST dans l'arène du parser (une seule réservation, sans malloc)
+     */
+    template <typename T, typename... Args>
+    std::shared_ptr<T> makeNode(Args &&...args)
+    {
+        return std::allocate_shared<T>(ArenaAllocator<T>(m_arena), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Restaure la profondeur d'imbrication à la sortie d'une règle récursive
+     */
+    struct NestingGuard
+    {
+        size_t &depth;
+        size_t saved;
+
+        explicit NestingGuard(size_t &depth) : depth(depth), saved(depth) {}
+        ~NestingGuard() { depth = saved; }
+    };
+
+    /**
+     * @brief Ouvre un scope de noms de tableaux le temps d'un bloc
+     */
+    struct ScopeGuard
+    {
+        std::vector<std::unordered_map<std::string, bool>> &scopes;
+
+        explicit ScopeGuard(std::vector<std::unordered_map<std::string, bool>> &scopes) : scopes(scopes) { scopes.push_back({}); }
+        ~ScopeGuard() { scopes.pop_back(); }
+    };
+
+    /**
+     * @brief Indique si une expression désigne un tableau ou une matrice
+     *
+     * Les variables n'ont pas de type : une variable est un tableau si le let qui la
+     * déclare lui donne un tableau littéral, une matrice ou une autre variable tableau.
+     * print s'en sert pour afficher les éléments plutôt que l'adresse.
+     */
+    bool isArrayValue(const Expr &expr) const
+    {
+        switch (expr.getType())
         {
-            return parseAssignStmt();
+        case ExprType::ARRAY:
+        case ExprType::MATRIX:
+            return true;
+        case ExprType::VARIABLE:
+            return isArrayName(*static_cast<const VarExpr &>(expr).token.value);
+        default:
+            return false;
         }
-        else if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::PRINT)
+    }
+
+    bool isArrayName(const std::string &name) const
+    {
+        for (auto it = m_arrayNames.rbegin(); it != m_arrayNames.rend(); ++it)
         {
-            return parsePrintStmt();
-        }
-        else if(m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::IDENTIFIER){
-            return parseArrayAssignStmt();
-        
+            auto found = it->find(name);
+            if (found != it->end())
+                return found->second;
         }
-        else
+        return false;
+    }
+
+    /**
+     * @brief Enregistre la nature d'une variable déclarée dans le scope courant
+     *
+     * Seuls les tableaux, et les entiers qui masquent un tableau, sont enregistrés.
+     */
+    void declareVariable(const std::string &name, bool array)
+    {
+        if (array || isArrayName(name))
+            m_arrayNames.back()[name] = array;
+    }
+
+    /**
+     * @brief Entre dans un niveau d'imbrication (parenthèse, bloc, opérande d'une chaîne d'opérateurs)
+     * @return false si la profondeur maximale est dépassée
+     *
+     * La profondeur suit celle de l'AST construit : elle borne la récursion du parser,
+     * du générateur et des destructeurs, quelle que soit l'entrée.
+     */
+    bool enterNesting()
+    {
+        if (++m_depth > MAX_NESTING_DEPTH)
         {
-            std::cerr << "Erreur: Instruction non reconnue" << std::endl;
-            return std::nullopt;
+            std::cerr << "Erreur: Imbrication trop profonde (plus de " << MAX_NESTING_DEPTH << " niveaux)" << std::endl;
+            return false;
         }
+        return true;
     }
 
     /**
@@ -407,20 +705,20 @@ private:
     std::optional<std::shared_ptr<ExitStmt>> parseExitStmt()
     {
         // Vérifier le token 'exit'
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::EXIT)
+        if (!hasToken() || current().type != TokenType::EXIT)
         {
             std::cerr << "Erreur: Un EXIT est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
         // Vérifier la parenthèse ouvrante
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::LPARENTHESIS)
         {
             std::cerr << "Erreur: Un ( est attendu après le EXIT" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
         // Analyser l'expression
         auto expr = parseExpression();
@@ -430,22 +728,21 @@ private:
         }
 
         // Vérifier la parenthèse fermante
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::RPARENTHESIS)
         {
             std::cerr << "Erreur: Un ) est attendu après l'expression" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
         // Vérifier le point-virgule
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::SEMICOLON)
+        if (!hasToken() || current().type != TokenType::SEMICOLON)
         {
             std::cerr << "Erreur: Un ; est attendu à la fin de l'instruction" << std::endl;
             return std::nullopt;
         }
-        m_position++;
-        std::cout << toString(expr.value()->getType()) << std::endl;
-        return std::make_shared<ExitStmt>(expr.value());
+        advance();
+        return makeNode<ExitStmt>(std::move(*expr));
     }
 
     /**
@@ -454,19 +751,24 @@ private:
      */
     std::optional<std::shared_ptr<IfStmt>> parseIfStmt()
     {
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::IF)
+        // Une chaîne de else if s'imbrique dans l'AST
+        NestingGuard guard(m_depth);
+        if (!enterNesting())
+            return std::nullopt;
+
+        if (!hasToken() || current().type != TokenType::IF)
         {
             std::cerr << "Erreur: Un IF est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // Vérifier la parenthèse ouvrante
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::LPARENTHESIS)
         {
             std::cerr << "Erreur: Un ( est attendu après le IF" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // Analyser l'expression
         auto expr = parseExpression();
         if (!expr)
@@ -474,12 +776,12 @@ private:
             return std::nullopt;
         }
         // Vérifier la parenthèse fermante
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::RPARENTHESIS)
         {
             std::cerr << "Erreur: Un ) est attendu après l'expression" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // Vérifier le bloc
         auto block = parseBlockStmt();
         if (!block)
@@ -488,17 +790,17 @@ private:
         }
 
         // Je verifie si on a un else
-        if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::ELSE)
+        if (hasToken() && current().type == TokenType::ELSE)
         {
             auto elseStmt = parseElseStmt();
             if (!elseStmt)
             {
                 return std::nullopt;
             }
-            return std::make_shared<IfStmt>(expr.value(), block.value(), elseStmt.value());
+            return makeNode<IfStmt>(std::move(*expr), std::move(*block), std::move(*elseStmt));
         }
 
-        return std::make_shared<IfStmt>(expr.value(), block.value());
+        return makeNode<IfStmt>(std::move(*expr), std::move(*block));
     }
 
     /**
@@ -507,13 +809,13 @@ private:
      */
     std::optional<std::shared_ptr<BlockStmt>> parseElseStmt()
     {
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::ELSE)
+        if (!hasToken() || current().type != TokenType::ELSE)
         {
             std::cerr << "Erreur: Un ELSE est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
-        if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::IF)
+        advance();
+        if (hasToken() && current().type == TokenType::IF)
         {
             auto ifStmt = parseIfStmt();
             if (!ifStmt)
@@ -521,8 +823,8 @@ private:
                 return std::nullopt;
             }
             std::vector<std::shared_ptr<Stmt>> statements;
-            statements.push_back(ifStmt.value());
-            return std::make_shared<BlockStmt>(statements);
+            statements.push_back(std::move(*ifStmt));
+            return makeNode<BlockStmt>(std::move(statements));
         }
         // Vérifier le bloc
         auto block = parseBlockStmt();
@@ -535,19 +837,19 @@ private:
 
     std::optional<std::shared_ptr<WhileStmt>> parseWhileStmt()
     {
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::WHILE)
+        if (!hasToken() || current().type != TokenType::WHILE)
         {
             std::cerr << "Erreur: Un WHILE est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // Je verifie si on a une parenthese ouvrante
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::LPARENTHESIS)
         {
             std::cerr << "Erreur: Un ( est attendu apres le WHILE" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // Analyser l'expression
         auto expr = parseExpression();
         if (!expr)
@@ -555,19 +857,120 @@ private:
             return std::nullopt;
         }
         // Je vérifie la parenthèse fermante
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::RPARENTHESIS)
         {
             std::cerr << "Erreur: Un ) est attendu après l'expression" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // LE bloc
         auto block = parseBlockStmt();
         if (!block)
         {
             return std::nullopt;
         }
-        return std::make_shared<WhileStmt>(expr.value(), block.value());
+        return makeNode<WhileStmt>(std::move(*expr), std::move(*block));
+    }
+
+    /**
+     * @brief Analyse les tokens pour produire une instruction match
+     * @return std::optional<std::shared_ptr<MatchStmt>> L'instruction match ou nullopt en cas d'erreur
+     */
+    std::optional<std::shared_ptr<MatchStmt>> parseMatchStmt()
+    {
+        int line = current().line;
+        advance();
+        if (!hasToken() || current().type != TokenType::LPARENTHESIS)
+        {
+            std::cerr << "Erreur: Un ( est attendu apres le MATCH" << std::endl;
+            return std::nullopt;
+        }
+        advance();
+        auto subject = parseExpression();
+        if (!subject)
+            return std::nullopt;
+        if (!hasToken() || current().type != TokenType::RPARENTHESIS)
+        {
+            std::cerr << "Erreur: Un ) est attendu après l'expression" << std::endl;
+            return std::nullopt;
+        }
+        advance();
+        if (!hasToken() || current().type != TokenType::LBRACE)
+        {
+            std::cerr << "Erreur: Un { est attendu apres match (...) a la ligne " << line << std::endl;
+            return std::nullopt;
+        }
+        advance();
+
+        // Chaque branche : des entiers séparés par des virgules, ou _, puis => et un bloc
+        std::vector<MatchArm> arms;
+        std::shared_ptr<BlockStmt> defaultBranch;
+        std::unordered_set<long long> seen;
+        while (hasToken() && current().type != TokenType::RBRACE)
+        {
+            if (defaultBranch)
+            {
+                std::cerr << "Erreur: la branche _ doit etre la derniere du match (ligne " << line << ")" << std::endl;
+                return std::nullopt;
+            }
+            MatchArm arm;
+            bool isDefault = current().type == TokenType::IDENTIFIER && *current().value == "_";
+            if (isDefault)
+                advance();
+            while (!isDefault)
+            {
+                bool negative = hasToken() && current().type == TokenType::MINUS;
+                if (negative)
+                    advance();
+                if (!hasToken() || current().type != TokenType::INT_LITERAL)
+                {
+                    std::cerr << "Erreur: Un entier ou _ est attendu dans le match (ligne " << line << ")" << std::endl;
+                    return std::nullopt;
+                }
+                long long value;
+                const std::string text = (negative ? "-" : "") + *current().value;
+                auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (error != std::errc() || end != text.data() + text.size())
+                {
+                    std::cerr << "Erreur: valeur de cas invalide: " << text << std::endl;
+                    return std::nullopt;
+                }
+                if (!seen.insert(value).second)
+                {
+                    std::cerr << "Erreur: valeur " << text << " en double dans le match (ligne " << line << ")"
+                              << std::endl;
+                    return std::nullopt;
+                }
+                arm.values.push_back(value);
+                advance();
+                if (!hasToken() || current().type != TokenType::COMMA)
+                    break;
+                advance();
+            }
+            if (!hasToken() || current().type != TokenType::FAT_ARROW)
+            {
+                std::cerr << "Erreur: Un => est attendu dans le match (ligne " << line << ")" << std::endl;
+                return std::nullopt;
+            }
+            advance();
+            auto block = parseBlockStmt();
+            if (!block)
+                return std::nullopt;
+            if (isDefault)
+                defaultBranch = std::move(*block);
+            else
+            {
+                arm.body = std::move(*block);
+                arms.push_back(std::move(arm));
+            }
+        }
+        if (!hasToken())
+        {
+            std::cerr << "Erreur: Un } est attendu" << std::endl;
+            return std::nullopt;
+        }
+        advance();
+        return makeNode<MatchStmt>(std::move(*subject), std::move(arms), std::move(defaultBranch));
     }
 
     /**
@@ -577,29 +980,28 @@ private:
     std::optional<std::shared_ptr<LetStmt>> parseLetStmt()
     {
         // Vérifier le token 'let'
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LET)
+        if (!hasToken() || current().type != TokenType::LET)
         {
             std::cerr << "Erreur: Un LET est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
         // Vérifier l'identifiant de la variable
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::IDENTIFIER)
+        if (!hasToken() || current().type != TokenType::IDENTIFIER)
         {
             std::cerr << "Erreur: Un IDENTIFIER est attendu après le LET" << std::endl;
             return std::nullopt;
         }
-        auto var = m_tokens[m_position];
-        m_position++;
+        Token var = take();
 
         // Vérifier le signe égal
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::EQUAL)
+        if (!hasToken() || current().type != TokenType::EQUAL)
         {
             std::cerr << "Erreur: Un = est attendu après le LET" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
         // Analyser l'expression
         auto expr = parseExpression();
@@ -609,42 +1011,95 @@ private:
         }
 
         // Vérifier le point-virgule
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::SEMICOLON)
+        if (!hasToken() || current().type != TokenType::SEMICOLON)
         {
             std::cerr << "Erreur: Un ; est attendu à la fin de l'instruction" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
-        return std::make_shared<LetStmt>(var, expr.value());
+        declareVariable(*var.value, isArrayValue(**expr));
+        return makeNode<LetStmt>(std::move(var), std::move(*expr));
+    }
+
+    /**
+     * @brief Analyse les tokens pour produire une instruction param
+     * @return std::optional<std::shared_ptr<ParamStmt>> L'instruction param ou nullopt en cas d'erreur
+     */
+    std::optional<std::shared_ptr<ParamStmt>> parseParamStmt()
+    {
+        int line = current().line;
+        advance();
+
+        // Les paramètres sont numérotés dans l'ordre du source : pas de param dans un bloc
+        if (m_arrayNames.size() != 1)
+        {
+            std::cerr << "Erreur: param n'est autorise qu'au premier niveau (ligne " << line << ")" << std::endl;
+            return std::nullopt;
+        }
+
+        if (!hasToken() || current().type != TokenType::IDENTIFIER)
+        {
+            std::cerr << "Erreur: Un IDENTIFIER est attendu après param" << std::endl;
+            return std::nullopt;
+        }
+        Token var = take();
+
+        bool array = false;
+        if (hasToken() && current().type == TokenType::LBRACKET)
+        {
+            advance();
+            if (!hasToken() || current().type != TokenType::RBRACKET)
+            {
+                std::cerr << "Erreur: Un ] est attendu après param " << *var.value << "[" << std::endl;
+                return std::nullopt;
+            }
+            advance();
+            array = true;
+        }
+
+        if (!hasToken() || current().type != TokenType::SEMICOLON)
+        {
+            std::cerr << "Erreur: Un ; est attendu à la fin de l'instruction" << std::endl;
+            return std::nullopt;
+        }
+        advance();
+
+        declareVariable(*var.value, array);
+        return makeNode<ParamStmt>(std::move(var), array);
     }
 
     std::optional<std::shared_ptr<BlockStmt>> parseBlockStmt()
     {
+        NestingGuard guard(m_depth);
+        if (!enterNesting())
+            return std::nullopt;
+
         // On vérifie si on a un '{'
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LBRACE)
+        if (!hasToken() || current().type != TokenType::LBRACE)
         {
-            std::cerr << "Erreur: Un { est attendu a " << m_position << std::endl;
+            std::cerr << "Erreur: Un { est attendu a la ligne " << (hasToken() ? current().line : 0) << std::endl;
             return std::nullopt;
         }
         // hop on récupere toutes les instructions entre les accolades
-        m_position++;
+        advance();
+        ScopeGuard scope(m_arrayNames);
         std::vector<std::shared_ptr<Stmt>> statements;
-        while (m_position < m_tokens.size() && m_tokens[m_position].type != TokenType::RBRACE)
+        while (hasToken() && current().type != TokenType::RBRACE)
         {
             auto stmt = parseStatement();
             if (!stmt)
                 return std::nullopt;
-            statements.push_back(stmt.value());
+            statements.push_back(std::move(*stmt));
         }
         // On vérifie si on a un '}'
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RBRACE)
+        if (!hasToken() || current().type != TokenType::RBRACE)
         {
             std::cerr << "Erreur: Un } est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
-        return std::make_shared<BlockStmt>(statements);
+        advance();
+        return makeNode<BlockStmt>(std::move(statements));
     }
 
     /**
@@ -665,14 +1120,16 @@ private:
         if (!left)
             return std::nullopt;
 
-        while (m_position < m_tokens.size() && (m_tokens[m_position].type == TokenType::OR))
+        NestingGuard guard(m_depth);
+        while (hasToken() && (current().type == TokenType::OR))
         {
-            TokenType operatorType = m_tokens[m_position].type;
-            m_position++;
+            if (!enterNesting())
+                return std::nullopt;
+            advance();
             auto right = parseLogicalConAND();
             if (!right)
                 return std::nullopt;
-            left = std::make_shared<BinaryExpr>(left.value(), BinaryOpType::OR, right.value());
+            left = makeNode<BinaryExpr>(std::move(*left), BinaryOpType::OR, std::move(*right));
         }
 
         return left;
@@ -690,10 +1147,13 @@ private:
         if (!left)
             return std::nullopt;
 
-        while (m_position < m_tokens.size() && (m_tokens[m_position].type == TokenType::EGAL || m_tokens[m_position].type == TokenType::GREAT || m_tokens[m_position].type == TokenType::LESS || m_tokens[m_position].type == TokenType::GREAT_EQUAL || m_tokens[m_position].type == TokenType::LESS_EQUAL || m_tokens[m_position].type == TokenType::NEGAL))
+        NestingGuard guard(m_depth);
+        while (hasToken() && (current().type == TokenType::EGAL || current().type == TokenType::GREAT || current().type == TokenType::LESS || current().type == TokenType::GREAT_EQUAL || current().type == TokenType::LESS_EQUAL || current().type == TokenType::NEGAL))
         {
-            TokenType operatorType = m_tokens[m_position].type;
-            m_position++;
+            if (!enterNesting())
+                return std::nullopt;
+            TokenType operatorType = current().type;
+            advance();
             BinaryOpType binaryOpType;
             if (operatorType == TokenType::EGAL)
                 binaryOpType = BinaryOpType::EQUAL;
@@ -716,7 +1176,7 @@ private:
             if (!right)
                 return std::nullopt;
 
-            left = std::make_shared<BinaryExpr>(left.value(), binaryOpType, right.value());
+            left = makeNode<BinaryExpr>(std::move(*left), binaryOpType, std::move(*right));
         }
 
         return left;
@@ -728,14 +1188,16 @@ private:
         if (!left)
             return std::nullopt;
 
-        while (m_position < m_tokens.size() && (m_tokens[m_position].type == TokenType::AND))
+        NestingGuard guard(m_depth);
+        while (hasToken() && (current().type == TokenType::AND))
         {
-            TokenType operatorType = m_tokens[m_position].type;
-            m_position++;
+            if (!enterNesting())
+                return std::nullopt;
+            advance();
             auto right = parseComparison();
             if (!right)
                 return std::nullopt;
-            left = std::make_shared<BinaryExpr>(left.value(), BinaryOpType::AND, right.value());
+            left = makeNode<BinaryExpr>(std::move(*left), BinaryOpType::AND, std::move(*right));
         }
 
         return left;
@@ -751,20 +1213,21 @@ private:
         if (!left)
             return std::nullopt;
 
-        while (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::PLUS || m_tokens[m_position].type == TokenType::MINUS)
+        NestingGuard guard(m_depth);
+        while (hasToken() && (current().type == TokenType::PLUS || current().type == TokenType::MINUS))
         {
-            // Y au Bug marrant ici je le comprend pas tres bien la ca marche mais
-            // si n'utilise pas le operatorType et je met m_position + 1 a la fin ca merde
-            TokenType operatorType = m_tokens[m_position].type;
-            m_position++;
+            if (!enterNesting())
+                return std::nullopt;
+            TokenType operatorType = current().type;
+            advance();
             auto right = parseMultiplication();
             if (!right)
                 return std::nullopt;
 
             if (operatorType == TokenType::MINUS)
-                left = std::make_shared<BinaryExpr>(left.value(), BinaryOpType::SUB, right.value());
+                left = makeNode<BinaryExpr>(std::move(*left), BinaryOpType::SUB, std::move(*right));
             else if (operatorType == TokenType::PLUS)
-                left = std::make_shared<BinaryExpr>(left.value(), BinaryOpType::ADD, right.value());
+                left = makeNode<BinaryExpr>(std::move(*left), BinaryOpType::ADD, std::move(*right));
         }
 
         return left;
@@ -780,20 +1243,23 @@ private:
         auto left = parseSemiParenth();
         if (!left)
             return std::nullopt;
-        while (m_position < m_tokens.size() && (m_tokens[m_position].type == TokenType::STAR || m_tokens[m_position].type == TokenType::DIVIDE || m_tokens[m_position].type == TokenType::STAR || m_tokens[m_position].type == TokenType::MODULO))
+        NestingGuard guard(m_depth);
+        while (hasToken() && (current().type == TokenType::STAR || current().type == TokenType::DIVIDE || current().type == TokenType::MODULO))
         {
-            TokenType operatorType = m_tokens[m_position].type;
-            m_position++;
+            if (!enterNesting())
+                return std::nullopt;
+            TokenType operatorType = current().type;
+            advance();
             auto right = parseSemiParenth();
             if (!right)
                 return std::nullopt;
 
             if (operatorType == TokenType::DIVIDE)
-                left = std::make_shared<BinaryExpr>(left.value(), BinaryOpType::DIV, right.value());
+                left = makeNode<BinaryExpr>(std::move(*left), BinaryOpType::DIV, std::move(*right));
             else if (operatorType == TokenType::MODULO)
-                left = std::make_shared<BinaryExpr>(left.value(), BinaryOpType::MOD, right.value());
+                left = makeNode<BinaryExpr>(std::move(*left), BinaryOpType::MOD, std::move(*right));
             else if (operatorType == TokenType::STAR)
-                left = std::make_shared<BinaryExpr>(left.value(), BinaryOpType::MUL, right.value());
+                left = makeNode<BinaryExpr>(std::move(*left), BinaryOpType::MUL, std::move(*right));
         }
         return left;
     }
@@ -805,57 +1271,78 @@ private:
      */
     std::optional<std::shared_ptr<Expr>> parseSemiParenth()
     {
-        if (m_position < m_tokens.size())
+        NestingGuard guard(m_depth);
+        if (!enterNesting())
+            return std::nullopt;
+
+        if (hasToken())
         {
-            if (m_tokens[m_position].type == TokenType::LBRACKET)
+            if (current().type == TokenType::LBRACKET)
             {
                 return parseArray();
             }
             // Cas d'un entier
-            else if (m_tokens[m_position].type == TokenType::INT_LITERAL)
+            else if (current().type == TokenType::INT_LITERAL)
             {
-                auto intExpr = std::make_shared<IntExpr>(m_tokens[m_position]);
-                m_position++;
-                return intExpr;
+                return makeNode<IntExpr>(take());
             }
             // Cas d'une variable ou accès à un tableau
-            else if (m_tokens[m_position].type == TokenType::IDENTIFIER)
+            else if (current().type == TokenType::IDENTIFIER)
             {
-                auto varExpr = std::make_shared<VarExpr>(m_tokens[m_position]);
-                m_position++;
+                std::shared_ptr<Expr> varExpr = makeNode<VarExpr>(take());
 
                 // Vérifier si on a un accès à un tableau: arr[index]
-                if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::LBRACKET)
+                if (hasToken() && current().type == TokenType::LBRACKET)
                 {
-                    m_position++; // Consommer le '['
+                    advance(); // Consommer le '['
 
                     auto indexExpr = parseExpression();
                     if (!indexExpr)
                         return std::nullopt;
 
-                    if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RBRACKET)
+                    if (!hasToken() || current().type != TokenType::RBRACKET)
                     {
                         std::cerr << "Erreur: Un ']' est attendu" << std::endl;
                         return std::nullopt;
                     }
 
-                    m_position++; // Consommer le ']'
-                    return std::make_shared<ArrayAccessExpr>(varExpr, indexExpr.value());
+                    advance(); // Consommer le ']'
+
+                    // Un second indice donne un accès de matrice: m[i][j]
+                    if (hasToken() && current().type == TokenType::LBRACKET)
+                    {
+                        advance(); // Consommer le '['
+
+                        auto colExpr = parseExpression();
+                        if (!colExpr)
+                            return std::nullopt;
+
+                        if (!hasToken() || current().type != TokenType::RBRACKET)
+                        {
+                            std::cerr << "Erreur: Un ']' est attendu" << std::endl;
+                            return std::nullopt;
+                        }
+
+                        advance(); // Consommer le ']'
+                        return makeNode<MatrixAccessExpr>(std::move(varExpr), std::move(*indexExpr), std::move(*colExpr));
+                    }
+
+                    return makeNode<ArrayAccessExpr>(std::move(varExpr), std::move(*indexExpr));
                 }
 
                 return varExpr;
             }
-            else if (m_tokens[m_position].type == TokenType::LENGTH)
+            else if (current().type == TokenType::LENGTH)
             {
-                m_position++; // Consommer 'len'
+                advance(); // Consommer 'len'
 
                 // Vérifier la parenthèse ouvrante
-                if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LPARENTHESIS)
+                if (!hasToken() || current().type != TokenType::LPARENTHESIS)
                 {
                     std::cerr << "Erreur: Un ( est attendu après len" << std::endl;
                     return std::nullopt;
                 }
-                m_position++; // Consommer '('
+                advance(); // Consommer '('
 
                 // Parser l'expression du tableau
                 auto arrayExpr = parseExpression();
@@ -863,29 +1350,33 @@ private:
                     return std::nullopt;
 
                 // Vérifier la parenthèse fermante
-                if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RPARENTHESIS)
+                if (!hasToken() || current().type != TokenType::RPARENTHESIS)
                 {
                     std::cerr << "Erreur: Un ) est attendu après l'argument de len()" << std::endl;
                     return std::nullopt;
                 }
-                m_position++; // Consommer ')'
+                advance(); // Consommer ')'
 
-                return std::make_shared<LengthExpr>(arrayExpr.value());
+                return makeNode<LengthExpr>(std::move(*arrayExpr));
+            }
+            else if (current().type == TokenType::MATRIX)
+            {
+                return parseMatrixExpr();
             }
             // Cas d'une expression entre parenthèses
-            else if (m_tokens[m_position].type == TokenType::LPARENTHESIS)
+            else if (current().type == TokenType::LPARENTHESIS)
             {
-                m_position++; // Consommer '('
+                advance(); // Consommer '('
                 auto expr = parseExpression();
                 if (!expr)
                     return std::nullopt;
 
-                if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RPARENTHESIS)
+                if (!hasToken() || current().type != TokenType::RPARENTHESIS)
                 {
                     std::cerr << "Erreur: Un ) est attendu" << std::endl;
                     return std::nullopt;
                 }
-                m_position++; // Consommer ')'
+                advance(); // Consommer ')'
                 return expr;
             }
         }
@@ -897,20 +1388,20 @@ private:
     std::optional<std::shared_ptr<Expr>> parseArray()
     {
         // Vérifier et consommer le crochet ouvrant '['
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LBRACKET)
+        if (!hasToken() || current().type != TokenType::LBRACKET)
         {
             std::cerr << "Erreur: Un [ est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++; // Consommer '['
+        advance(); // Consommer '['
 
         std::vector<std::shared_ptr<Expr>> elements;
 
         // Cas du tableau vide []
-        if (m_position < m_tokens.size() && m_tokens[m_position].type == TokenType::RBRACKET)
+        if (hasToken() && current().type == TokenType::RBRACKET)
         {
-            m_position++; // Consommer ']'
-            return std::make_shared<ArrayExpr>(elements);
+            advance(); // Consommer ']'
+            return makeNode<ArrayExpr>(std::move(elements));
         }
 
         // Parser les éléments du tableau
@@ -921,50 +1412,94 @@ private:
             if (!expr)
                 return std::nullopt;
 
-            elements.push_back(expr.value());
+            elements.push_back(std::move(*expr));
 
             // Vérifier si on a atteint la fin du tableau
-            if (m_position >= m_tokens.size())
+            if (!hasToken())
             {
                 std::cerr << "Erreur: Fin de fichier inattendue dans la déclaration du tableau" << std::endl;
                 return std::nullopt;
             }
 
             // Si on trouve ']', c'est la fin du tableau
-            if (m_tokens[m_position].type == TokenType::RBRACKET)
+            if (current().type == TokenType::RBRACKET)
             {
-                m_position++; // Consommer ']'
+                advance(); // Consommer ']'
                 break;
             }
 
             // Sinon, on doit avoir une virgule
-            if (m_tokens[m_position].type != TokenType::COMMA)
+            if (current().type != TokenType::COMMA)
             {
                 std::cerr << "Erreur: Une virgule est attendue entre les éléments du tableau" << std::endl;
                 return std::nullopt;
             }
-            m_position++; // Consommer ','
+            advance(); // Consommer ','
+        }
+
+        return makeNode<ArrayExpr>(std::move(elements));
+    }
+
+    /**
+     * @brief Analyse une création de matrice: matrix(lignes, colonnes)
+     * @return std::optional<std::shared_ptr<Expr>> L'expression ou nullopt en cas d'erreur
+     */
+    std::optional<std::shared_ptr<Expr>> parseMatrixExpr()
+    {
+        if (!hasToken() || current().type != TokenType::MATRIX)
+        {
+            std::cerr << "Erreur: Un MATRIX est attendu" << std::endl;
+            return std::nullopt;
+        }
+        advance(); // Consommer 'matrix'
+
+        if (!hasToken() || current().type != TokenType::LPARENTHESIS)
+        {
+            std::cerr << "Erreur: Un ( est attendu après matrix" << std::endl;
+            return std::nullopt;
+        }
+        advance(); // Consommer '('
+
+        auto rows = parseExpression();
+        if (!rows)
+            return std::nullopt;
+
+        if (!hasToken() || current().type != TokenType::COMMA)
+        {
+            std::cerr << "Erreur: Une virgule est attendue entre les dimensions de matrix()" << std::endl;
+            return std::nullopt;
+        }
+        advance(); // Consommer ','
+
+        auto cols = parseExpression();
+        if (!cols)
+            return std::nullopt;
+
+        if (!hasToken() || current().type != TokenType::RPARENTHESIS)
+        {
+            std::cerr << "Erreur: Un ) est attendu après les dimensions de matrix()" << std::endl;
+            return std::nullopt;
         }
+        advance(); // Consommer ')'
 
-        return std::make_shared<ArrayExpr>(elements);
+        return makeNode<MatrixExpr>(std::move(*rows), std::move(*cols));
     }
 
     std::optional<std::shared_ptr<AssignStmt>> parseAssignStmt()
     {
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::IDENTIFIER)
+        if (!hasToken() || current().type != TokenType::IDENTIFIER)
         {
             std::cerr << "Erreur: Un IDENTIFIER est attendu" << std::endl;
             return std::nullopt;
         }
-        auto var = m_tokens[m_position];
-        m_position++;
+        Token var = take();
         // Vérifier le signe égal
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::EQUAL)
+        if (!hasToken() || current().type != TokenType::EQUAL)
         {
             std::cerr << "Erreur: Un = est attendu avant " << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // Analyser l'expression
         auto expr = parseExpression();
         if (!expr)
@@ -972,146 +1507,164 @@ private:
             return std::nullopt;
         }
         // Vérifier le point-virgule
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::SEMICOLON)
+        if (!hasToken() || current().type != TokenType::SEMICOLON)
         {
             std::cerr << "Erreur: Un ; est attendu à la fin de l'instruction" << std::endl;
             return std::nullopt;
         }
-        m_position++;
-        return std::make_shared<AssignStmt>(var, expr.value());
+        advance();
+        return makeNode<AssignStmt>(std::move(var), std::move(*expr));
     }
 
     std::optional<std::shared_ptr<PrintStmt>> parsePrintStmt()
     {
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::PRINT)
+        if (!hasToken() || current().type != TokenType::PRINT)
         {
             std::cerr << "Erreur: Un PRINT est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // parenthese ouvrante (
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::LPARENTHESIS)
         {
             std::cerr << "Erreur: Un ( est attendu après le PRINT" << std::endl;
             return std::nullopt;
         }
-        m_position++;
-        // Analyser l'expression
-        auto expr = parseExpression();
-        if (!expr)
+        advance();
+        // Analyser les expressions, séparées par des virgules
+        std::vector<PrintArg> args;
+        while (true)
         {
-            return std::nullopt;
+            auto expr = parseExpression();
+            if (!expr)
+            {
+                return std::nullopt;
+            }
+            bool array = isArrayValue(**expr);
+            args.push_back({std::move(*expr), array});
+
+            if (!hasToken() || current().type != TokenType::COMMA)
+                break;
+            advance();
         }
         // parenthese fermante )
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::RPARENTHESIS)
         {
             std::cerr << "Erreur: Un ) est attendu après l'expression" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
         // Vérifier le point-virgule
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::SEMICOLON)
+        if (!hasToken() || current().type != TokenType::SEMICOLON)
         {
             std::cerr << "Erreur: Un ; est attendu à la fin de l'instruction" << std::endl;
             return std::nullopt;
         }
-        m_position++;
-        return std::make_shared<PrintStmt>(expr.value());
+        advance();
+        return makeNode<PrintStmt>(std::move(args));
     }
 
     std::optional<std::shared_ptr<Expr>> parseLengthExpr()
     {
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LENGTH)
+        if (!hasToken() || current().type != TokenType::LENGTH)
             return std::nullopt;
-        m_position++;
+        advance();
 
         // Vérifier (
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::LPARENTHESIS)
         {
             std::cerr << "Erreur: Un ( est attendu après len" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
         auto arrayExpr = parseExpression();
         if (!arrayExpr)
             return std::nullopt;
 
         // Vérifier )
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RPARENTHESIS)
+        if (!hasToken() || current().type != TokenType::RPARENTHESIS)
         {
             std::cerr << "Erreur: Un ) est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
-        return std::make_shared<LengthExpr>(arrayExpr.value());
+        return makeNode<LengthExpr>(std::move(*arrayExpr));
     }
 
-    std::optional<std::shared_ptr<ArrayAssignStmt>> parseArrayAssignStmt()
+    /**
+     * @brief Analyse une affectation d'élément : tableau[indice] = expr ou matrice[ligne][colonne] = expr
+     * @note Appelée seulement quand l'identifiant est suivi de '[' : les erreurs sont donc définitives
+     */
+    std::optional<std::shared_ptr<Stmt>> parseArrayAssignStmt()
     {
-        // Sauvegarder la position pour pouvoir revenir en back back
-        size_t startPos = m_position;
-
         // Parser l'identifiant du tableau
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::IDENTIFIER)
-            return std::nullopt;
-
-        Token arrayToken = m_tokens[m_position];
-        auto array = std::make_shared<VarExpr>(arrayToken);
-        m_position++;
-
-        // Vérifier le crochet ouvrant
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::LBRACKET)
+        if (!hasToken() || current().type != TokenType::IDENTIFIER)
         {
-            m_position = startPos;
+            std::cerr << "Erreur: Un IDENTIFIER est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
 
-        // Parser l'indice
-        auto index = parseExpression();
-        if (!index)
+        std::shared_ptr<Expr> array = makeNode<VarExpr>(take());
+
+        // Un ou deux indices entre crochets
+        std::shared_ptr<Expr> indices[2];
+        size_t indexCount = 0;
+        while (hasToken() && current().type == TokenType::LBRACKET && indexCount < 2)
         {
-            m_position = startPos;
-            return std::nullopt;
-        }
+            advance(); // Consommer le '['
+            auto index = parseExpression();
+            if (!index)
+                return std::nullopt;
 
-        // Vérifier le crochet fermant ] je suis pas sûr du nom
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::RBRACKET)
+            if (!hasToken() || current().type != TokenType::RBRACKET)
+            {
+                std::cerr << "Erreur: Un ']' est attendu" << std::endl;
+                return std::nullopt;
+            }
+            advance(); // Consommer le ']'
+            indices[indexCount++] = std::move(*index);
+        }
+        if (indexCount == 0)
         {
-            m_position = startPos;
+            std::cerr << "Erreur: Un [ est attendu" << std::endl;
             return std::nullopt;
         }
-        m_position++;
 
         // Vérifier le signe égal
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::EQUAL)
+        if (!hasToken() || current().type != TokenType::EQUAL)
         {
-            m_position = startPos;
+            std::cerr << "Erreur: Un = est attendu après l'indice" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
         // Parser la valeur à assigner
         auto value = parseExpression();
         if (!value)
-        {
-            m_position = startPos;
             return std::nullopt;
-        }
 
         // Vérifier le point-virgule
-        if (m_position >= m_tokens.size() || m_tokens[m_position].type != TokenType::SEMICOLON)
+        if (!hasToken() || current().type != TokenType::SEMICOLON)
         {
             std::cerr << "Erreur: Un ; est attendu après l'assignation" << std::endl;
             return std::nullopt;
         }
-        m_position++;
+        advance();
 
-        return std::make_shared<ArrayAssignStmt>(array, index.value(), value.value());
+        if (indexCount == 2)
+            return makeNode<MatrixAssignStmt>(std::move(array), std::move(indices[0]), std::move(indices[1]), std::move(*value));
+        return makeNode<ArrayAssignStmt>(std::move(array), std::move(indices[0]), std::move(*value));
     }
 
-    std::vector<Token> m_tokens; ///< Vecteur des tokens à analyser
-    size_t m_position;           ///< Position actuelle dans le flux de tokens
+    /**
+     * @brief Profondeur maximale de l'AST (parenthèses, crochets, blocs, else if et chaînes d'opérateurs)
+     */
+    static constexpr size_t MAX_NESTING_DEPTH = 512;
+
+    TokenStream &m_tokens; ///< Source des tokens
+    std::shared_ptr<NodeArena> m_arena = std::make_shared<NodeArena>(); ///< Mémoire des nœuds créés
+    size_t m_depth = 0;    ///< Profondeur d'imbrication courante
+    std::vector<std::unordered_map<std::string, bool>> m_arrayNames{1}; ///< Variables tableaux, par scope
 };
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "CodeGenerator.hpp"
+#include "SpscQueue.hpp"
+#include <istream>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @file Pipeline.hpp
+ * @brief Compilation en trois étages parallèles (option --pipeline).
+ *
+ * Un thread lit le source et produit des lots de tokens, un thread les analyse et
+ * produit les instructions de premier niveau, et le thread appelant génère et écrit
+ * le code de chaque instruction. Les étages communiquent par des SpscQueue : sur un
+ * gros fichier, la durée totale tend vers celle de l'étage le plus lent au lieu de la
+ * somme des trois. Comme avec --stream, la mémoire reste bornée par la taille des files
+ * et de la plus grande instruction.
+ */
+
+/**
+ * @brief Nombre de tokens par lot transmis au parser (un lot vide marque la fin)
+ */
+constexpr size_t PIPELINE_TOKEN_BATCH = 512;
+
+using TokenBatchQueue = SpscQueue<std::vector<Token>, 64>;
+
+/**
+ * @brief Instruction transmise au générateur
+ */
+struct ParsedStatement
+{
+    std::shared_ptr<Stmt> stmt; /**< nullptr : fin du programme ou erreur */
+    bool error = false;         /**< Le parser a rencontré une erreur */
+};
+
+using StatementQueue = SpscQueue<ParsedStatement, 256>;
+
+/**
+ * @class QueuedTokens
+ * @brief Tokens lus depuis la file de lots du thread lexical
+ */
+class QueuedTokens : public TokenStream
+{
+public:
+    explicit QueuedTokens(TokenBatchQueue &queue) : m_queue(queue) {}
+
+protected:
+    std::optional<Token> produce() override
+    {
+        while (m_index == m_batch.size())
+        {
+            if (m_finished)
+                return std::nullopt;
+            m_batch = m_queue.pop();
+            m_index = 0;
+            m_finished = m_batch.empty();
+        }
+        return std::move(m_batch[m_index++]);
+    }
+
+private:
+    TokenBatchQueue &m_queue;
+    std::vector<Token> m_batch;
+    size_t m_index = 0;
+    bool m_finished = false;
+};
+
+/**
+ * @brief Compile le source avec un thread par étage
+ * @param source Flux du code source
+ * @param output Flux où écrire le code assembleur
+ * @param generator Générateur (incrémental) utilisé par le thread appelant
+ * @return false si le programme n'a pas pu être analysé
+ */
+inline bool compilePipelined(std::istream &source, std::ostream &output, const CodeGenerator &generator)
+{
+    TokenBatchQueue tokenQueue;
+    StatementQueue statementQueue;
+
+    std::thread lexer([&]
+                      {
+        Tokenizer tokenizer(source);
+        std::vector<Token> batch;
+        batch.reserve(PIPELINE_TOKEN_BATCH);
+        while (auto token = tokenizer.next())
+        {
+            batch.push_back(std::move(*token));
+            if (batch.size() == PIPELINE_TOKEN_BATCH)
+            {
+                if (!tokenQueue.push(std::move(batch)))
+                    return; // Le parser s'est arrêté
+                batch = std::vector<Token>();
+                batch.reserve(PIPELINE_TOKEN_BATCH);
+            }
+        }
+        if (!batch.empty() && !tokenQueue.push(std::move(batch)))
+            return;
+        tokenQueue.push(std::vector<Token>()); });
+
+    std::thread parser([&]
+                       {
+        QueuedTokens tokens(tokenQueue);
+        Parser parser(tokens);
+        while (!parser.atEnd())
+        {
+            auto stmt = parser.parseNext();
+            if (!stmt)
+            {
+                tokenQueue.close();
+                statementQueue.push({nullptr, true});
+                return;
+            }
+            if (!statementQueue.push({stmt.value(), false}))
+            {
+                tokenQueue.close(); // Le générateur s'est arrêté
+                return;
+            }
+        }
+        statementQueue.push({nullptr, false}); });
+
+    std::stringstream chunk;
+    generator.beginAssembly(chunk);
+    bool ok = true;
+    while (true)
+    {
+        ParsedStatement parsed = statementQueue.pop();
+        if (!parsed.stmt)
+        {
+            ok = !parsed.error;
+            break;
+        }
+        generator.generateStatement(parsed.stmt, chunk);
+        output << chunk.str();
+        chunk.str("");
+    }
+    if (ok)
+    {
+        generator.finishAssembly(chunk);
+        output << chunk.str();
+    }
+
+    statementQueue.close();
+    parser.join();
+    lexer.join();
+    return ok;
+}
@@ -0,0 +1,1032 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file RuntimeEmitter.hpp
+ * @brief Génère la bibliothèque d'exécution `yb_rt` ajoutée une seule fois à chaque binaire.
+ *
+ * Au lieu de recopier la conversion d'entier, l'appel mmap ou la sortie du
+ * programme à chaque utilisation, le Generator appelle des routines partagées
+ * (`call yb_rt_...`). Le RuntimeEmitter garde la trace des routines demandées
+ * pendant la génération et n'émet à la fin que celles réellement utilisées
+ * (ainsi que leurs dépendances), ce qui garde les binaires petits.
+ *
+ * Convention d'appel des routines `yb_rt` :
+ * - le premier argument est passé dans rax, le second dans rbx, le résultat revient dans rax ;
+ * - tous les autres registres sont préservés, le code généré n'a donc rien à sauvegarder.
+ *   Seuls les registres vectoriels ne le sont pas : le code généré ne s'en sert que
+ *   comme temporaires (copie des tableaux constants).
+ *
+ * Les données du runtime sont toujours adressées relativement à rip : le même code
+ * convient à un exécutable et à une bibliothèque partagée.
+ */
+
+/**
+ * @brief Niveau du jeu d'instructions x86-64 garanti sur la machine cible (option -march)
+ */
+enum class CpuLevel
+{
+    V1, // x86-64 de base : SSE2
+    V2, // + SSE4.2, POPCNT
+    V3, // + AVX2, BMI1, BMI2, LZCNT
+    V4, // + AVX-512 (F, BW, DQ, VL)
+};
+
+/**
+ * @brief Niveau désigné par un nom de -march : x86-64, x86-64-v2, x86-64-v3 ou x86-64-v4
+ * @return Faux si le nom est inconnu
+ */
+inline bool parseCpuLevel(const std::string &name, CpuLevel &level)
+{
+    if (name == "x86-64" || name == "x86-64-v1")
+        level = CpuLevel::V1;
+    else if (name == "x86-64-v2")
+        level = CpuLevel::V2;
+    else if (name == "x86-64-v3")
+        level = CpuLevel::V3;
+    else if (name == "x86-64-v4")
+        level = CpuLevel::V4;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @brief Niveau de la machine qui compile (-march=native), lu par CPUID
+ */
+inline CpuLevel hostCpuLevel()
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("bmi2"))
+        return CpuLevel::V4;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2") &&
+        __builtin_cpu_supports("fma"))
+        return CpuLevel::V3;
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+        return CpuLevel::V2;
+#endif
+    return CpuLevel::V1;
+}
+
+/**
+ * @brief Options du runtime choisies à la compilation
+ */
+struct RuntimeOptions
+{
+    /**
+     * @brief Taille (en octets) à partir de laquelle une allocation est préfaultée
+     * et placée sur des huge pages. 0 désactive ce chemin.
+     */
+    long long largeAllocThreshold = 2 * 1024 * 1024;
+
+    /**
+     * @brief Essayer d'abord MAP_HUGETLB (pages réservées par l'administrateur)
+     * pour les grandes allocations, avec repli sur les huge pages transparentes
+     */
+    bool useHugeTlb = false;
+
+    /**
+     * @brief Code pour une bibliothèque partagée (option --shared)
+     *
+     * yb_rt_exit et yb_rt_panic reviennent à l'appelant de yb_main au lieu de terminer
+     * le processus, et les tableaux alloués sont libérés avant le retour.
+     */
+    bool sharedLibrary = false;
+
+    /**
+     * @brief Jeu d'instructions garanti (option -march)
+     *
+     * Les routines multiversionnées n'utilisent directement que les extensions de ce
+     * niveau ; les versions plus larges sont choisies au premier appel avec CPUID.
+     */
+    CpuLevel cpuLevel = CpuLevel::V1;
+};
+
+/**
+ * @brief Routines disponibles dans le runtime
+ */
+enum class RuntimeRoutine
+{
+    ALLOC_ARRAY,  // yb_rt_alloc_array : rax = nombre d'éléments -> rax = adresse de l'élément 0
+    ALLOC_MATRIX, // yb_rt_alloc_matrix : rax = lignes, rbx = colonnes -> rax = adresse de l'élément [0][0]
+    FMT_INT,     // yb_rt_fmt_int : écrit rax en décimal à [rdi], rdi avance
+    PRINT_INT,   // yb_rt_print_int : ajoute rax suivi d'un saut de ligne au tampon de sortie
+    PRINT_LIST,  // yb_rt_print_list : ajoute une ligne de rax valeurs ou tableaux passés sur la pile
+    FLUSH,       // yb_rt_flush : écrit le tampon de sortie sur stdout
+    EXIT,        // yb_rt_exit : vide le tampon puis termine avec le code rax
+    PANIC,       // yb_rt_panic : affiche le message (rsi, rdx) sur stderr puis termine avec le code 1
+    BOUNDS_TRAP, // yb_rt_bounds_trap : erreur d'indice hors limites
+    ALLOC_TRAP,  // yb_rt_alloc_trap : échec d'une allocation (mmap, taille de matrice invalide)
+    OVERFLOW_TRAP, // yb_rt_overflow_trap : dépassement d'une opération (--checked-arith)
+    FAULT_HANDLER, // yb_rt_fault_init : installe le gestionnaire de SIGFPE et SIGSEGV (--fault-handler)
+    COPY_WORDS,    // yb_rt_copy_words : copie dans le tableau rax ses [rax-8] éléments depuis [rbx]
+    CPU_LEVEL,     // yb_rt_cpu_level : rax = 0 (SSE2), 1 (AVX2) ou 2 (AVX-512) selon CPUID
+};
+
+/**
+ * @brief Classe responsable de la génération du runtime `yb_rt`
+ */
+class RuntimeEmitter
+{
+public:
+    /**
+     * @brief Taille du tampon de sortie partagé par les print
+     */
+    static constexpr int OUTPUT_BUFFER_SIZE = 65536;
+
+    /**
+     * @brief Section du code froid : sorties, traps et branches qui se terminent par exit
+     *
+     * Les attributs sont répétés à chaque déclaration : pour NASM, une section de nom
+     * inconnu n'est ni exécutable ni alignée.
+     */
+    static constexpr const char *COLD_SECTION = "section .text.cold progbits alloc exec nowrite align=16";
+
+    /**
+     * @brief Taille de l'en-tête placé avant les éléments d'un tableau
+     *
+     * Un tableau est désigné par l'adresse de son élément 0, alignée sur une ligne de
+     * cache (64 octets). La longueur est stockée juste avant, à [adresse - 8], dans une
+     * ligne de cache séparée des données. Pour une matrice, la longueur est le nombre
+     * total d'éléments, suivie du nombre de colonnes à [adresse - 16] et du nombre de
+     * lignes à [adresse - 24]. En mode bibliothèque partagée, la taille et le début de la
+     * projection mmap sont à [adresse - 32] et [adresse - 40], et [adresse - 48] pointe
+     * sur le tableau alloué juste avant (liste libérée par yb_rt_exit).
+     */
+    static constexpr int ARRAY_HEADER_SIZE = 64;
+
+    /**
+     * @brief Constructeur
+     * @param options Options du runtime (seuil des grandes allocations, MAP_HUGETLB)
+     */
+    explicit RuntimeEmitter(const RuntimeOptions &options = RuntimeOptions()) : m_options(options) {}
+
+    /**
+     * @brief Indique qu'une routine est utilisée par le programme
+     * @param routine La routine à inclure (ses dépendances sont ajoutées aussi)
+     */
+    void require(RuntimeRoutine routine)
+    {
+        m_used |= bit(routine);
+
+        switch (routine)
+        {
+        case RuntimeRoutine::PRINT_INT:
+        case RuntimeRoutine::PRINT_LIST:
+            require(RuntimeRoutine::FMT_INT);
+            require(RuntimeRoutine::FLUSH);
+            break;
+        case RuntimeRoutine::BOUNDS_TRAP:
+        case RuntimeRoutine::ALLOC_TRAP:
+        case RuntimeRoutine::OVERFLOW_TRAP:
+            require(RuntimeRoutine::PANIC);
+            break;
+        case RuntimeRoutine::PANIC:
+            if (m_options.sharedLibrary)
+                require(RuntimeRoutine::EXIT); // Le retour à l'appelant passe par yb_rt_exit
+            break;
+        case RuntimeRoutine::ALLOC_ARRAY:
+            require(RuntimeRoutine::ALLOC_TRAP);
+            break;
+        case RuntimeRoutine::ALLOC_MATRIX:
+            require(RuntimeRoutine::ALLOC_ARRAY);
+            break;
+        case RuntimeRoutine::FAULT_HANDLER:
+            require(RuntimeRoutine::FMT_INT);
+            break;
+        case RuntimeRoutine::COPY_WORDS:
+            if (m_options.cpuLevel < CpuLevel::V4)
+                require(RuntimeRoutine::CPU_LEVEL); // Choix de la version au premier appel
+            break;
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Indique si une routine fait partie du runtime émis
+     */
+    bool uses(RuntimeRoutine routine) const
+    {
+        return (m_used & bit(routine)) != 0;
+    }
+
+    /**
+     * @brief Émet les routines utilisées et leurs données
+     * @param assembly Flux où écrire le code assembleur
+     */
+    void emit(std::stringstream &assembly) const
+    {
+        assembly << "\n; ---------------- runtime yb_rt ----------------\n";
+        assembly << "section .text.yb_rt progbits alloc exec nowrite align=16\n";
+
+        if (uses(RuntimeRoutine::PRINT_INT))
+            emitPrintInt(assembly);
+        if (uses(RuntimeRoutine::PRINT_LIST))
+            emitPrintList(assembly);
+        if (uses(RuntimeRoutine::FMT_INT))
+            emitFmtInt(assembly);
+        if (uses(RuntimeRoutine::FLUSH))
+            emitFlush(assembly);
+        if (uses(RuntimeRoutine::ALLOC_MATRIX))
+            emitAllocMatrix(assembly);
+        if (uses(RuntimeRoutine::ALLOC_ARRAY))
+            emitAllocArray(assembly);
+        if (uses(RuntimeRoutine::COPY_WORDS))
+            emitCopyWords(assembly);
+
+        // Routines exécutées au plus une fois : hors des lignes de cache du code chaud
+        assembly << COLD_SECTION << "\n";
+        if (uses(RuntimeRoutine::EXIT))
+            emitExit(assembly);
+        if (uses(RuntimeRoutine::BOUNDS_TRAP))
+            emitTrap(assembly, "yb_rt_bounds_trap", "yb_rt_msg_bounds", MSG_BOUNDS);
+        if (uses(RuntimeRoutine::ALLOC_TRAP))
+            emitTrap(assembly, "yb_rt_alloc_trap", "yb_rt_msg_alloc", MSG_ALLOC);
+        if (uses(RuntimeRoutine::OVERFLOW_TRAP))
+            emitTrap(assembly, "yb_rt_overflow_trap", "yb_rt_msg_overflow", MSG_OVERFLOW);
+        if (uses(RuntimeRoutine::PANIC))
+            emitPanic(assembly);
+        if (uses(RuntimeRoutine::FAULT_HANDLER))
+            emitFaultHandler(assembly);
+        if (uses(RuntimeRoutine::CPU_LEVEL))
+            emitCpuLevel(assembly);
+
+        emitData(assembly);
+    }
+
+    /**
+     * @brief Label du repère de ligne `index` posé dans le code du programme
+     *
+     * Les labels `..@` ne changent pas la portée des labels locaux (`.while_start_0`...).
+     * Le repère 0 marque le début du code : les décalages de la table en partent.
+     */
+    static std::string lineLabel(size_t index)
+    {
+        return "..@yb_line_" + std::to_string(index);
+    }
+
+    /**
+     * @brief Émet la table adresse -> ligne lue par le gestionnaire de fautes
+     * @param lines Ligne du source de chaque repère, dans l'ordre des adresses (0 : ligne inconnue)
+     *
+     * La table commence par le nombre d'entrées, suivi d'une paire de mots de 32 bits par
+     * repère : décalage depuis le repère 0 et ligne. Seuls les changements de ligne ont un
+     * repère, la table reste donc petite et n'est lue qu'en cas de faute.
+     */
+    static void emitLineTable(std::stringstream &assembly, const std::vector<int> &lines)
+    {
+        assembly << "section .rodata\n";
+        assembly << "align 4\n";
+        assembly << "yb_rt_line_table: dd " << lines.size() << "\n";
+        for (size_t i = 0; i < lines.size(); i++)
+            assembly << "    dd " << lineLabel(i) << " - " << lineLabel(0) << ", " << lines[i] << "\n";
+    }
+
+private:
+    RuntimeOptions m_options; /**< Options choisies à la compilation */
+    unsigned m_used = 0;      /**< Masque des routines demandées */
+
+    static unsigned bit(RuntimeRoutine routine)
+    {
+        return 1u << static_cast<unsigned>(routine);
+    }
+
+    // Messages d'erreur des traps (texte, sans le saut de ligne final)
+    static constexpr const char *MSG_BOUNDS = "Erreur: indice de tableau hors limites";
+    static constexpr const char *MSG_ALLOC = "Erreur: allocation memoire impossible";
+    static constexpr const char *MSG_OVERFLOW = "Erreur: depassement de capacite arithmetique";
+    static constexpr const char *MSG_FPE = "Erreur: division par zero ou depassement de division";
+    static constexpr const char *MSG_SEGV = "Erreur: acces memoire invalide";
+
+    void emitExit(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_exit:\n";
+        if (uses(RuntimeRoutine::FLUSH))
+            assembly << "    call yb_rt_flush\n";
+        if (m_options.sharedLibrary)
+        {
+            emitSharedReturn(assembly);
+            return;
+        }
+        assembly << "    mov rdi, rax\n"; // Code de retour
+        assembly << "    mov rax, 60\n";  // syscall exit
+        assembly << "    syscall\n";
+    }
+
+    /**
+     * @brief Retour de yb_main vers l'appelant (bibliothèque partagée), rax = code
+     *
+     * Les tableaux sont libérés, puis la pile est ramenée au cadre de yb_main (rbp n'est
+     * jamais modifié par le code généré ni par le runtime) : on peut donc sortir depuis un
+     * bloc, une boucle ou une routine du runtime.
+     */
+    void emitSharedReturn(std::stringstream &assembly) const
+    {
+        if (uses(RuntimeRoutine::ALLOC_ARRAY))
+        {
+            assembly << "    push rax\n";
+            assembly << "    mov rbx, [rel yb_rt_allocs]\n";
+            assembly << ".free:\n";
+            assembly << "    test rbx, rbx\n";
+            assembly << "    jz .freed\n";
+            assembly << "    mov rdi, [rbx-40]\n"; // Début de la projection
+            assembly << "    mov rsi, [rbx-32]\n"; // Taille
+            assembly << "    mov rbx, [rbx-48]\n"; // Tableau précédent, lu avant munmap
+            assembly << "    mov eax, 11\n";       // syscall munmap
+            assembly << "    syscall\n";
+            assembly << "    jmp .free\n";
+            assembly << ".freed:\n";
+            assembly << "    mov qword [rel yb_rt_allocs], 0\n";
+            assembly << "    pop rax\n";
+        }
+        assembly << "    mov rsp, rbp\n";
+        assembly << "    pop rbp\n";
+        assembly << "    add rsp, 48\n"; // Arguments rangés par le prologue
+        assembly << "    pop r15\n";
+        assembly << "    pop r14\n";
+        assembly << "    pop r13\n";
+        assembly << "    pop r12\n";
+        assembly << "    pop rbx\n";
+        assembly << "    ret\n";
+    }
+
+    void emitPrintInt(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_print_int:\n";
+        assembly << "    push rsi\n";
+        assembly << "    push rdi\n";
+        assembly << "    mov rdi, [rel yb_rt_outpos]\n";
+        // 21 octets suffisent pour un int64 signé et le saut de ligne
+        assembly << "    cmp rdi, " << OUTPUT_BUFFER_SIZE - 32 << "\n";
+        assembly << "    jbe .room\n";
+        assembly << "    call yb_rt_flush\n";
+        assembly << "    xor edi, edi\n";
+        assembly << ".room:\n";
+        assembly << "    lea rsi, [rel yb_rt_outbuf]\n";
+        assembly << "    add rdi, rsi\n";
+        assembly << "    call yb_rt_fmt_int\n";
+        assembly << "    mov byte [rdi], 10\n"; // Saut de ligne
+        assembly << "    inc rdi\n";
+        assembly << "    sub rdi, rsi\n";
+        assembly << "    mov [rel yb_rt_outpos], rdi\n";
+        assembly << "    pop rdi\n";
+        assembly << "    pop rsi\n";
+        assembly << "    ret\n";
+    }
+
+    void emitPrintList(std::stringstream &assembly) const
+    {
+        // Chaque élément occupe deux mots empilés par l'appelant, dans l'ordre du print :
+        // la valeur puis -1 pour un entier, l'adresse de l'élément 0 puis la longueur pour
+        // un tableau. Toutes les valeurs sont formatées dans le tampon en une seule passe,
+        // séparées par un espace, et la ligne finit par un saut de ligne.
+        assembly << "yb_rt_print_list:\n";
+        assembly << "    push rbx\n";
+        assembly << "    push rcx\n";
+        assembly << "    push rdx\n";
+        assembly << "    push rsi\n";
+        assembly << "    push rdi\n";
+        assembly << "    push r8\n";
+        assembly << "    push r9\n";
+        assembly << "    push r10\n";
+        assembly << "    mov rcx, rax\n";                  // Éléments restants
+        assembly << "    shl rax, 4\n";
+        assembly << "    lea rbx, [rsp + rax + 56]\n";     // Premier élément (8 registres + adresse de retour - 16)
+        assembly << "    lea rsi, [rel yb_rt_outbuf]\n";
+        assembly << "    mov rdi, [rel yb_rt_outpos]\n";
+        assembly << "    add rdi, rsi\n";
+        assembly << "    xor r10d, r10d\n"; // 1 dès qu'une valeur est écrite
+        assembly << ".item:\n";
+        assembly << "    test rcx, rcx\n";
+        assembly << "    jz .end\n";
+        assembly << "    lea r8, [rbx+8]\n"; // Entier : la valeur est sur la pile
+        assembly << "    mov r9, [rbx]\n";
+        assembly << "    cmp r9, -1\n";
+        assembly << "    jne .array\n";
+        assembly << "    mov r9d, 1\n";
+        assembly << "    jmp .value\n";
+        assembly << ".array:\n";
+        assembly << "    mov r8, [r8]\n"; // Tableau : r9 éléments à partir de [r8]
+        assembly << ".value:\n";
+        assembly << "    test r9, r9\n";
+        assembly << "    jz .next\n";
+        assembly << "    mov rax, rdi\n";
+        assembly << "    sub rax, rsi\n";
+        // 21 octets suffisent pour un int64 signé et le séparateur
+        assembly << "    cmp rax, " << OUTPUT_BUFFER_SIZE - 32 << "\n";
+        assembly << "    jbe .room\n";
+        assembly << "    mov [rel yb_rt_outpos], rax\n";
+        assembly << "    call yb_rt_flush\n";
+        assembly << "    mov rdi, rsi\n";
+        assembly << ".room:\n";
+        assembly << "    mov rax, [r8]\n";
+        assembly << "    call yb_rt_fmt_int\n";
+        assembly << "    mov byte [rdi], ' '\n";
+        assembly << "    inc rdi\n";
+        assembly << "    mov r10d, 1\n";
+        assembly << "    add r8, 8\n";
+        assembly << "    dec r9\n";
+        assembly << "    jmp .value\n";
+        assembly << ".next:\n";
+        assembly << "    sub rbx, 16\n";
+        assembly << "    dec rcx\n";
+        assembly << "    jmp .item\n";
+        assembly << ".end:\n";
+        assembly << "    sub rdi, r10\n"; // Le dernier espace devient le saut de ligne
+        assembly << "    mov byte [rdi], 10\n";
+        assembly << "    inc rdi\n";
+        assembly << "    sub rdi, rsi\n";
+        assembly << "    mov [rel yb_rt_outpos], rdi\n";
+        assembly << "    pop r10\n";
+        assembly << "    pop r9\n";
+        assembly << "    pop r8\n";
+        assembly << "    pop rdi\n";
+        assembly << "    pop rsi\n";
+        assembly << "    pop rdx\n";
+        assembly << "    pop rcx\n";
+        assembly << "    pop rbx\n";
+        assembly << "    ret\n";
+    }
+
+    void emitFmtInt(std::stringstream &assembly) const
+    {
+        // Les chiffres sont produits à l'envers dans un tampon sur la pile puis recopiés
+        assembly << "yb_rt_fmt_int:\n";
+        assembly << "    push rbx\n";
+        assembly << "    push rcx\n";
+        assembly << "    push rdx\n";
+        assembly << "    push rsi\n";
+        assembly << "    sub rsp, 32\n";
+        assembly << "    lea rsi, [rsp+32]\n"; // Fin du tampon temporaire
+        assembly << "    mov rbx, rax\n";      // Garder le signe
+        assembly << "    test rax, rax\n";
+        assembly << "    jns .convert\n";
+        assembly << "    neg rax\n";
+        assembly << ".convert:\n";
+        // Division par 10 sans div : n / 10 = (n * 0xCCCCCCCCCCCCCCCD) >> 67, exact pour tout n < 2^64
+        assembly << ".digit:\n";
+        assembly << "    mov rcx, rax\n";
+        assembly << "    mov rax, 0xCCCCCCCCCCCCCCCD\n";
+        assembly << "    mul rcx\n";
+        assembly << "    shr rdx, 3\n";              // Quotient
+        assembly << "    lea rax, [rdx + rdx*4]\n";
+        assembly << "    add rax, rax\n";
+        assembly << "    sub rcx, rax\n";            // Reste
+        assembly << "    add cl, '0'\n";
+        assembly << "    dec rsi\n";
+        assembly << "    mov [rsi], cl\n";
+        assembly << "    mov rax, rdx\n";
+        assembly << "    test rax, rax\n";
+        assembly << "    jnz .digit\n";
+        assembly << "    test rbx, rbx\n";
+        assembly << "    jns .copy\n";
+        assembly << "    dec rsi\n";
+        assembly << "    mov byte [rsi], '-'\n";
+        assembly << ".copy:\n";
+        assembly << "    lea rcx, [rsp+32]\n";
+        assembly << "    sub rcx, rsi\n"; // Nombre de caractères
+        assembly << "    rep movsb\n";    // Copie vers [rdi], rdi avance
+        assembly << "    add rsp, 32\n";
+        assembly << "    pop rsi\n";
+        assembly << "    pop rdx\n";
+        assembly << "    pop rcx\n";
+        assembly << "    pop rbx\n";
+        assembly << "    ret\n";
+    }
+
+    void emitFlush(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_flush:\n";
+        assembly << "    push rax\n";
+        assembly << "    push rcx\n";
+        assembly << "    push rdx\n";
+        assembly << "    push rsi\n";
+        assembly << "    push rdi\n";
+        assembly << "    push r11\n";
+        assembly << "    lea rsi, [rel yb_rt_outbuf]\n";
+        assembly << "    mov rdx, [rel yb_rt_outpos]\n";
+        assembly << ".write:\n";
+        assembly << "    test rdx, rdx\n";
+        assembly << "    jz .done\n";
+        assembly << "    mov rax, 1\n"; // syscall write
+        assembly << "    mov rdi, 1\n"; // stdout
+        assembly << "    syscall\n";
+        assembly << "    test rax, rax\n";
+        assembly << "    jle .done\n";
+        assembly << "    add rsi, rax\n"; // Écriture partielle : on continue
+        assembly << "    sub rdx, rax\n";
+        assembly << "    jmp .write\n";
+        assembly << ".done:\n";
+        assembly << "    mov qword [rel yb_rt_outpos], 0\n";
+        assembly << "    pop r11\n";
+        assembly << "    pop rdi\n";
+        assembly << "    pop rsi\n";
+        assembly << "    pop rdx\n";
+        assembly << "    pop rcx\n";
+        assembly << "    pop rax\n";
+        assembly << "    ret\n";
+    }
+
+    void emitAllocArray(std::stringstream &assembly) const
+    {
+        // Disposition d'un tableau : [en-tête de 64 octets, longueur à la fin][élément 0][élément 1]...
+        assembly << "yb_rt_alloc_array:\n";
+        assembly << "    push rcx\n";
+        assembly << "    push rdx\n";
+        assembly << "    push rsi\n";
+        assembly << "    push rdi\n";
+        assembly << "    push r8\n";
+        assembly << "    push r9\n";
+        assembly << "    push r10\n";
+        assembly << "    push r11\n";
+        assembly << "    push rax\n";             // Nombre d'éléments
+        assembly << "    lea rsi, [rax*8 + " << ARRAY_HEADER_SIZE << "]\n";
+        if (m_options.largeAllocThreshold > 0)
+        {
+            assembly << "    mov rcx, " << m_options.largeAllocThreshold << "\n";
+            assembly << "    cmp rsi, rcx\n";
+            assembly << "    jae .large\n";
+        }
+        emitMmap(assembly, "34"); // MAP_PRIVATE | MAP_ANONYMOUS
+        emitRecordMapping(assembly);
+        assembly << ".store:\n";
+        assembly << "    pop rcx\n";
+        assembly << "    add rax, " << ARRAY_HEADER_SIZE << "\n"; // mmap est aligné sur une page : l'élément 0 l'est sur 64
+        assembly << "    mov [rax-8], rcx\n";                     // Stocker la longueur
+        if (m_options.sharedLibrary)
+        {
+            assembly << "    mov [rax-32], r9\n";
+            assembly << "    mov [rax-40], r8\n";
+            assembly << "    mov rcx, [rel yb_rt_allocs]\n";
+            assembly << "    mov [rax-48], rcx\n";
+            assembly << "    mov [rel yb_rt_allocs], rax\n";
+        }
+        assembly << "    pop r11\n";
+        assembly << "    pop r10\n";
+        assembly << "    pop r9\n";
+        assembly << "    pop r8\n";
+        assembly << "    pop rdi\n";
+        assembly << "    pop rsi\n";
+        assembly << "    pop rdx\n";
+        assembly << "    pop rcx\n";
+        assembly << "    ret\n";
+        if (m_options.largeAllocThreshold > 0)
+            emitLargeAlloc(assembly);
+    }
+
+    void emitAllocMatrix(std::stringstream &assembly) const
+    {
+        // Une seule allocation de lignes * colonnes éléments, rangés ligne par ligne
+        assembly << "yb_rt_alloc_matrix:\n";
+        assembly << "    push rcx\n";
+        assembly << "    push rdx\n";
+        assembly << "    mov rcx, rax\n"; // Lignes
+        assembly << "    or rcx, rbx\n";  // Dimension négative ?
+        assembly << "    js yb_rt_alloc_trap\n";
+        assembly << "    mov rcx, rax\n";
+        assembly << "    imul rax, rbx\n";
+        assembly << "    jo yb_rt_alloc_trap\n";
+        assembly << "    mov rdx, 0x100000000000000\n"; // La taille en octets doit rester représentable
+        assembly << "    cmp rax, rdx\n";
+        assembly << "    jae yb_rt_alloc_trap\n";
+        assembly << "    call yb_rt_alloc_array\n";
+        assembly << "    mov [rax-16], rbx\n"; // Colonnes
+        assembly << "    mov [rax-24], rcx\n"; // Lignes
+        assembly << "    pop rdx\n";
+        assembly << "    pop rcx\n";
+        assembly << "    ret\n";
+    }
+
+    /**
+     * @brief Bibliothèque partagée : garde le début (r8) et la taille (r9) de la projection
+     * qui vient d'être créée, pour la libérer au retour de yb_main
+     *
+     * Ne modifie pas les drapeaux.
+     */
+    void emitRecordMapping(std::stringstream &assembly) const
+    {
+        if (!m_options.sharedLibrary)
+            return;
+        assembly << "    mov r8, rax\n";
+        assembly << "    mov r9, rsi\n";
+    }
+
+    /**
+     * @brief Appel mmap anonyme de rsi octets, saute à yb_rt_alloc_trap en cas d'erreur
+     * @param flags Drapeaux MAP_* passés dans r10
+     */
+    void emitMmap(std::stringstream &assembly, const std::string &flags) const
+    {
+        assembly << "    mov rax, 9\n";   // syscall mmap
+        assembly << "    xor edi, edi\n"; // Le noyau choisit l'adresse
+        assembly << "    mov rdx, 3\n";   // PROT_READ | PROT_WRITE
+        assembly << "    mov r10, " << flags << "\n";
+        assembly << "    mov r8, -1\n";
+        assembly << "    xor r9d, r9d\n";
+        assembly << "    syscall\n";
+        assembly << "    cmp rax, -4095\n"; // Les erreurs sont renvoyées sous forme -errno
+        assembly << "    jae yb_rt_alloc_trap\n";
+    }
+
+    /**
+     * @brief Chemin des grandes allocations : huge pages et préfault
+     *
+     * Un parcours d'un grand tableau en pages de 4 Kio prend un défaut de page et un
+     * défaut de TLB toutes les 512 entrées. Ici la taille est arrondie à 2 Mio et :
+     * - avec MAP_HUGETLB, MAP_POPULATE réserve et remplit directement des pages de 2 Mio ;
+     * - sinon (ou si aucune page n'est réservée) la zone est alignée sur 2 Mio,
+     *   marquée MADV_HUGEPAGE puis préfaultée avec MADV_POPULATE_WRITE. MAP_POPULATE
+     *   n'est pas utilisé ici car il remplirait la zone en pages de 4 Kio avant le madvise.
+     */
+    void emitLargeAlloc(std::stringstream &assembly) const
+    {
+        assembly << ".large:\n";
+        assembly << "    add rsi, 0x1FFFFF\n"; // Arrondir à un multiple de 2 Mio
+        assembly << "    and rsi, -0x200000\n";
+        if (m_options.useHugeTlb)
+        {
+            assembly << "    mov rax, 9\n";
+            assembly << "    xor edi, edi\n";
+            assembly << "    mov rdx, 3\n";
+            assembly << "    mov r10, 0x48022\n"; // MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE
+            assembly << "    mov r8, -1\n";
+            assembly << "    xor r9d, r9d\n";
+            assembly << "    syscall\n";
+            emitRecordMapping(assembly);
+            assembly << "    cmp rax, -4095\n";
+            assembly << "    jb .store\n"; // Sinon pas de huge pages réservées : repli
+        }
+        assembly << "    push rsi\n";
+        assembly << "    add rsi, 0x200000\n"; // Marge pour aligner le début sur 2 Mio
+        emitMmap(assembly, "34");
+        emitRecordMapping(assembly);
+        assembly << "    pop rsi\n";
+        assembly << "    add rax, 0x1FFFFF\n";
+        assembly << "    and rax, -0x200000\n";
+        assembly << "    mov rdi, rax\n";
+        assembly << "    mov rax, 28\n"; // syscall madvise
+        assembly << "    mov rdx, 14\n"; // MADV_HUGEPAGE
+        assembly << "    syscall\n";
+        assembly << "    mov rax, 28\n";
+        assembly << "    mov rdx, 23\n"; // MADV_POPULATE_WRITE (Linux >= 5.14)
+        assembly << "    syscall\n";
+        assembly << "    test rax, rax\n";
+        assembly << "    jz .populated\n";
+        // Noyau plus ancien : toucher une fois chaque page de 4 Kio
+        assembly << "    mov rax, rdi\n";
+        assembly << "    lea rcx, [rdi + rsi]\n";
+        assembly << ".touch:\n";
+        assembly << "    mov byte [rax], 0\n";
+        assembly << "    add rax, 4096\n";
+        assembly << "    cmp rax, rcx\n";
+        assembly << "    jb .touch\n";
+        assembly << ".populated:\n";
+        assembly << "    mov rax, rdi\n";
+        assembly << "    jmp .store\n";
+    }
+
+    void emitTrap(std::stringstream &assembly, const std::string &name, const std::string &label,
+                  const std::string &text) const
+    {
+        assembly << name << ":\n";
+        emitPanicJump(assembly, label, text);
+    }
+
+    void emitPanicJump(std::stringstream &assembly, const std::string &label, const std::string &text) const
+    {
+        assembly << "    lea rsi, [rel " << label << "]\n";
+        assembly << "    mov rdx, " << text.size() + 1 << "\n"; // +1 pour le saut de ligne
+        assembly << "    jmp yb_rt_panic\n";
+    }
+
+    void emitPanic(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_panic:\n";
+        if (uses(RuntimeRoutine::FLUSH))
+            assembly << "    call yb_rt_flush\n"; // Ne pas perdre ce qui a déjà été affiché
+        assembly << "    mov rax, 1\n";           // syscall write
+        assembly << "    mov rdi, 2\n";           // stderr
+        assembly << "    syscall\n";
+        if (m_options.sharedLibrary)
+        {
+            assembly << "    mov eax, 1\n"; // yb_main renvoie 1
+            assembly << "    jmp yb_rt_exit\n";
+            return;
+        }
+        assembly << "    mov rax, 60\n"; // syscall exit
+        assembly << "    mov rdi, 1\n";
+        assembly << "    syscall\n";
+    }
+
+    /**
+     * @brief Gestionnaire de SIGFPE et SIGSEGV
+     *
+     * yb_rt_fault_init, appelé une fois par l'entrée du programme, installe le gestionnaire
+     * avec rt_sigaction : le code normal n'a aucun test en plus. En cas de faute, le
+     * gestionnaire lit l'adresse fautive dans le contexte du signal (uc_mcontext.gregs[REG_RIP],
+     * à 168 octets du début du ucontext_t), cherche la ligne dans yb_rt_line_table (voir
+     * emitLineTable), vide le tampon de sortie, affiche le message sur stderr et termine avec
+     * le code 128 + signal, celui qu'un shell affiche pour un processus tué par ce signal.
+     */
+    void emitFaultHandler(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_fault_init:\n";
+        assembly << "    sub rsp, 32\n"; // struct kernel_sigaction
+        assembly << "    lea rax, [rel yb_rt_fault_handler]\n";
+        assembly << "    mov [rsp], rax\n";          // sa_handler
+        // Sans SA_RESTORER, le noyau x86-64 refuse de délivrer le signal, même si le
+        // gestionnaire ne revient jamais
+        assembly << "    mov qword [rsp+8], 0x4000004\n"; // sa_flags = SA_SIGINFO | SA_RESTORER
+        assembly << "    lea rax, [rel yb_rt_fault_restorer]\n";
+        assembly << "    mov [rsp+16], rax\n";       // sa_restorer
+        assembly << "    mov qword [rsp+24], 0\n";   // sa_mask
+        assembly << "    mov rsi, rsp\n";
+        assembly << "    xor edx, edx\n";            // Ancienne action ignorée
+        assembly << "    mov r10d, 8\n";             // Taille du masque de signaux
+        assembly << "    mov eax, 13\n";             // syscall rt_sigaction
+        assembly << "    mov edi, 8\n";              // SIGFPE
+        assembly << "    syscall\n";
+        assembly << "    mov eax, 13\n";
+        assembly << "    mov edi, 11\n";             // SIGSEGV
+        assembly << "    syscall\n";
+        assembly << "    add rsp, 32\n";
+        assembly << "    ret\n";
+
+        assembly << "yb_rt_fault_restorer:\n";
+        assembly << "    mov eax, 15\n"; // syscall rt_sigreturn
+        assembly << "    syscall\n";
+
+        assembly << "yb_rt_fault_handler:\n";
+        assembly << "    mov r12, rdi\n";         // Numéro du signal
+        assembly << "    mov rax, [rdx+168]\n";   // Adresse de l'instruction fautive
+        assembly << "    lea rcx, [rel " << lineLabel(0) << "]\n";
+        assembly << "    sub rax, rcx\n";
+        assembly << "    lea rsi, [rel yb_rt_line_table]\n";
+        assembly << "    mov ecx, [rsi]\n";       // Nombre de repères
+        assembly << "    add rsi, 4\n";
+        assembly << "    xor ebx, ebx\n";         // Ligne du dernier repère avant l'adresse
+        assembly << ".search:\n";
+        assembly << "    test ecx, ecx\n";
+        assembly << "    jz .found\n";
+        assembly << "    mov edx, [rsi]\n";
+        assembly << "    cmp rax, rdx\n";
+        assembly << "    jb .found\n";
+        assembly << "    mov ebx, [rsi+4]\n";
+        assembly << "    add rsi, 8\n";
+        assembly << "    dec ecx\n";
+        assembly << "    jmp .search\n";
+        assembly << ".found:\n";
+        if (uses(RuntimeRoutine::FLUSH))
+            assembly << "    call yb_rt_flush\n";
+        assembly << "    sub rsp, 128\n"; // Message construit sur la pile
+        assembly << "    mov rdi, rsp\n";
+        assembly << "    lea rsi, [rel yb_rt_msg_fpe]\n";
+        assembly << "    cmp r12, 8\n";
+        assembly << "    je .message\n";
+        assembly << "    lea rsi, [rel yb_rt_msg_segv]\n";
+        assembly << ".message:\n";
+        assembly << "    call .append\n";
+        assembly << "    test ebx, ebx\n";
+        assembly << "    jz .write\n"; // Faute hors du code du programme
+        assembly << "    lea rsi, [rel yb_rt_msg_line]\n";
+        assembly << "    call .append\n";
+        assembly << "    mov eax, ebx\n";
+        assembly << "    call yb_rt_fmt_int\n";
+        assembly << "    mov byte [rdi], ')'\n";
+        assembly << "    inc rdi\n";
+        assembly << ".write:\n";
+        assembly << "    mov byte [rdi], 10\n";
+        assembly << "    inc rdi\n";
+        assembly << "    mov rsi, rsp\n";
+        assembly << "    mov rdx, rdi\n";
+        assembly << "    sub rdx, rsi\n";
+        assembly << "    mov eax, 1\n"; // syscall write
+        assembly << "    mov edi, 2\n"; // stderr
+        assembly << "    syscall\n";
+        assembly << "    lea rdi, [r12 + 128]\n";
+        assembly << "    mov eax, 60\n"; // syscall exit
+        assembly << "    syscall\n";
+        // Copie la chaîne terminée par 0 de [rsi] vers [rdi], rdi avance
+        assembly << ".append:\n";
+        assembly << "    mov al, [rsi]\n";
+        assembly << "    test al, al\n";
+        assembly << "    jz .appended\n";
+        assembly << "    mov [rdi], al\n";
+        assembly << "    inc rsi\n";
+        assembly << "    inc rdi\n";
+        assembly << "    jmp .append\n";
+        assembly << ".appended:\n";
+        assembly << "    ret\n";
+    }
+
+    /**
+     * @brief Copie de tableau en versions SSE2, AVX2 et AVX-512
+     *
+     * Avec un -march qui garantit AVX-512, yb_rt_copy_words est directement la version
+     * AVX-512. Sinon c'est un aiguillage : le premier appel lit le niveau du processeur
+     * (yb_rt_cpu_level), range l'adresse de la version la plus large disponible dans
+     * yb_rt_copy_words_impl, et les appels suivants n'ont plus qu'un saut indirect. Le
+     * choix est fait au premier appel plutôt qu'à l'entrée du programme, qui est déjà
+     * émise (--stream) quand le premier tableau constant est rencontré.
+     */
+    void emitCopyWords(std::stringstream &assembly) const
+    {
+        if (m_options.cpuLevel >= CpuLevel::V4)
+        {
+            emitCopyWordsVersion(assembly, "yb_rt_copy_words", 8);
+            return;
+        }
+
+        bool sse2 = m_options.cpuLevel < CpuLevel::V3; // Sinon AVX2 est garanti
+        assembly << "yb_rt_copy_words:\n";
+        assembly << "    cmp qword [rel yb_rt_copy_words_impl], 0\n";
+        assembly << "    je .resolve\n";
+        assembly << "    jmp qword [rel yb_rt_copy_words_impl]\n";
+        assembly << ".resolve:\n";
+        assembly << "    push rax\n";
+        assembly << "    push rbx\n";
+        assembly << "    call yb_rt_cpu_level\n";
+        if (sse2)
+        {
+            assembly << "    lea rbx, [rel yb_rt_copy_words_sse2]\n";
+            assembly << "    cmp rax, 1\n";
+            assembly << "    jb .chosen\n";
+        }
+        assembly << "    lea rbx, [rel yb_rt_copy_words_avx2]\n";
+        assembly << "    cmp rax, 2\n";
+        assembly << "    jb .chosen\n";
+        assembly << "    lea rbx, [rel yb_rt_copy_words_avx512]\n";
+        assembly << ".chosen:\n";
+        assembly << "    mov [rel yb_rt_copy_words_impl], rbx\n";
+        assembly << "    pop rbx\n";
+        assembly << "    pop rax\n";
+        assembly << "    jmp qword [rel yb_rt_copy_words_impl]\n";
+
+        if (sse2)
+            emitCopyWordsVersion(assembly, "yb_rt_copy_words_sse2", 2);
+        emitCopyWordsVersion(assembly, "yb_rt_copy_words_avx2", 4);
+        emitCopyWordsVersion(assembly, "yb_rt_copy_words_avx512", 8);
+    }
+
+    /**
+     * @brief Une version de yb_rt_copy_words, par blocs de `width` éléments (2, 4 ou 8)
+     *
+     * La destination est l'élément 0 d'un tableau, aligné sur 64 octets : les écritures
+     * sont alignées. La source peut ne pas l'être. Les derniers éléments sont copiés un par
+     * un, ou avec un masque en AVX-512.
+     */
+    void emitCopyWordsVersion(std::stringstream &assembly, const std::string &name, int width) const
+    {
+        const char *load = width == 2 ? "movdqu xmm0" : width == 4 ? "vmovdqu ymm0" : "vmovdqu64 zmm0";
+        const char *store = width == 2 ? "movdqa [rdi], xmm0" : width == 4 ? "vmovdqa [rdi], ymm0" : "vmovdqa64 [rdi], zmm0";
+
+        assembly << name << ":\n";
+        assembly << "    push rcx\n";
+        assembly << "    push rsi\n";
+        assembly << "    push rdi\n";
+        assembly << "    mov rcx, [rax-8]\n"; // Nombre d'éléments
+        assembly << "    mov rdi, rax\n";
+        assembly << "    mov rsi, rbx\n";
+        assembly << ".block:\n";
+        assembly << "    cmp rcx, " << width << "\n";
+        assembly << "    jb .tail\n";
+        assembly << "    " << load << ", [rsi]\n";
+        assembly << "    " << store << "\n";
+        assembly << "    add rsi, " << width * 8 << "\n";
+        assembly << "    add rdi, " << width * 8 << "\n";
+        assembly << "    sub rcx, " << width << "\n";
+        assembly << "    jmp .block\n";
+        assembly << ".tail:\n";
+        if (width == 8)
+        {
+            // Masque des rcx < 8 derniers éléments : les éléments masqués ne sont ni lus ni écrits
+            assembly << "    push rax\n";
+            assembly << "    mov eax, 1\n";
+            assembly << "    shl eax, cl\n";
+            assembly << "    dec eax\n";
+            assembly << "    kmovw k1, eax\n";
+            assembly << "    vmovdqu64 zmm0{k1}{z}, [rsi]\n";
+            assembly << "    vmovdqu64 [rdi]{k1}, zmm0\n";
+            assembly << "    pop rax\n";
+        }
+        else
+        {
+            assembly << "    test rcx, rcx\n";
+            assembly << "    jz .done\n";
+            assembly << "    push rax\n";
+            assembly << ".element:\n";
+            assembly << "    mov rax, [rsi]\n";
+            assembly << "    mov [rdi], rax\n";
+            assembly << "    add rsi, 8\n";
+            assembly << "    add rdi, 8\n";
+            assembly << "    dec rcx\n";
+            assembly << "    jnz .element\n";
+            assembly << "    pop rax\n";
+            assembly << ".done:\n";
+        }
+        if (width > 2)
+            assembly << "    vzeroupper\n"; // Évite la pénalité de transition vers du code SSE
+        assembly << "    pop rdi\n";
+        assembly << "    pop rsi\n";
+        assembly << "    pop rcx\n";
+        assembly << "    ret\n";
+    }
+
+    /**
+     * @brief Niveau vectoriel utilisable : le processeur doit avoir l'extension et le
+     * système sauver ses registres (XCR0, lu par xgetbv)
+     */
+    void emitCpuLevel(std::stringstream &assembly) const
+    {
+        assembly << "yb_rt_cpu_level:\n";
+        assembly << "    push rbx\n";
+        assembly << "    push rcx\n";
+        assembly << "    push rdx\n";
+        assembly << "    push rsi\n";
+        assembly << "    push rdi\n";
+        assembly << "    xor esi, esi\n"; // Niveau trouvé
+        assembly << "    xor eax, eax\n";
+        assembly << "    cpuid\n";        // eax = dernière feuille disponible
+        assembly << "    cmp eax, 7\n";
+        assembly << "    jb .done\n";
+        assembly << "    mov eax, 1\n";
+        assembly << "    cpuid\n";
+        assembly << "    bt ecx, 27\n";  // OSXSAVE : xgetbv disponible
+        assembly << "    jnc .done\n";
+        assembly << "    xor ecx, ecx\n";
+        assembly << "    xgetbv\n";
+        assembly << "    mov edi, eax\n"; // XCR0 : états sauvés par le système
+        assembly << "    mov eax, 7\n";
+        assembly << "    xor ecx, ecx\n";
+        assembly << "    cpuid\n";        // ebx = extensions
+        assembly << "    mov eax, edi\n";
+        assembly << "    and eax, 6\n";   // États SSE et AVX
+        assembly << "    cmp eax, 6\n";
+        assembly << "    jne .done\n";
+        assembly << "    bt ebx, 5\n";    // AVX2
+        assembly << "    jnc .done\n";
+        assembly << "    mov esi, 1\n";
+        assembly << "    and edi, 0xE6\n"; // + états opmask et ZMM
+        assembly << "    cmp edi, 0xE6\n";
+        assembly << "    jne .done\n";
+        assembly << "    bt ebx, 16\n";   // AVX512F
+        assembly << "    jnc .done\n";
+        assembly << "    mov esi, 2\n";
+        assembly << ".done:\n";
+        assembly << "    mov eax, esi\n";
+        assembly << "    pop rdi\n";
+        assembly << "    pop rsi\n";
+        assembly << "    pop rdx\n";
+        assembly << "    pop rcx\n";
+        assembly << "    pop rbx\n";
+        assembly << "    ret\n";
+    }
+
+    void emitData(std::stringstream &assembly) const
+    {
+        if (uses(RuntimeRoutine::FAULT_HANDLER))
+        {
+            assembly << "section .rodata\n";
+            assembly << "yb_rt_msg_fpe: db \"" << MSG_FPE << "\", 0\n";
+            assembly << "yb_rt_msg_segv: db \"" << MSG_SEGV << "\", 0\n";
+            assembly << "yb_rt_msg_line: db \" (ligne \", 0\n";
+        }
+
+        if (uses(RuntimeRoutine::PANIC))
+        {
+            assembly << "section .rodata\n";
+            if (uses(RuntimeRoutine::BOUNDS_TRAP))
+                assembly << "yb_rt_msg_bounds: db \"" << MSG_BOUNDS << "\", 10\n";
+            if (uses(RuntimeRoutine::ALLOC_TRAP))
+                assembly << "yb_rt_msg_alloc: db \"" << MSG_ALLOC << "\", 10\n";
+            if (uses(RuntimeRoutine::OVERFLOW_TRAP))
+                assembly << "yb_rt_msg_overflow: db \"" << MSG_OVERFLOW << "\", 10\n";
+        }
+
+        if (uses(RuntimeRoutine::FLUSH))
+        {
+            assembly << "section .bss\n";
+            assembly << "yb_rt_outpos: resq 1\n";
+            assembly << "yb_rt_outbuf: resb " << OUTPUT_BUFFER_SIZE << "\n";
+        }
+
+        if (uses(RuntimeRoutine::COPY_WORDS) && m_options.cpuLevel < CpuLevel::V4)
+        {
+            assembly << "section .bss\n";
+            assembly << "yb_rt_copy_words_impl: resq 1\n"; // Version choisie, 0 avant le premier appel
+        }
+
+        if (m_options.sharedLibrary && uses(RuntimeRoutine::ALLOC_ARRAY))
+        {
+            assembly << "section .bss\n";
+            assembly << "yb_rt_allocs: resq 1\n"; // Dernier tableau alloué
+        }
+    }
+};
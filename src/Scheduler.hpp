@@ -0,0 +1,585 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file Scheduler.hpp
+ * @brief Réordonnancement du code x86-64 d'une instruction de premier niveau.
+ *
+ * Le Generator émet le code dans l'ordre du parcours de l'arbre : chaque valeur passe
+ * par rax, et un opérande attend sur la pile (push puis pop) que l'autre soit calculé.
+ * Chaque push/pop est une écriture puis une relecture en mémoire sur le chemin critique,
+ * et chaque chargement est suivi immédiatement de son utilisation. Deux passes, faites
+ * sur le texte de l'instruction générée :
+ *
+ * 1. Renommage : un push et le pop qui le consomme dans le même bloc deviennent des mov
+ *    vers un registre libre (r8 à r11, que ni le code généré ni le runtime n'utilisent
+ *    autrement), tant qu'aucune instruction entre les deux ne lit rsp ou n'appelle une
+ *    routine. Les sauts vers les traps du runtime ne reviennent pas et ne coupent pas le bloc.
+ * 2. Ordonnancement par liste de chaque suite d'instructions sans label ni saut : le
+ *    graphe des dépendances (registres, drapeaux, mémoire) est parcouru en plaçant d'abord
+ *    les instructions prêtes les plus loin de la fin du bloc, avec un modèle de latence
+ *    simple (chargement 5 cycles, imul 3, idiv 40, le reste 1). Un accès au cadre ou à
+ *    la pile dépend de rsp : il reste entre le sub rsp qui réserve la variable et le
+ *    add rsp qui la libère, hors de portée d'un gestionnaire de signal.
+ *
+ * Les labels, directives et commentaires ne bougent pas : les repères de ligne du mode
+ * --fault-handler gardent donc les mêmes instructions. Une instruction inconnue est
+ * laissée à sa place.
+ */
+class Scheduler
+{
+public:
+    /**
+     * @brief Renomme puis réordonne le code d'une instruction de premier niveau
+     */
+    std::string run(const std::string &assembly) const
+    {
+        std::vector<Line> lines = parse(assembly);
+        renameStackPairs(lines);
+
+        std::string result;
+        result.reserve(assembly.size());
+        size_t regionStart = 0;
+        for (size_t i = 0; i <= lines.size(); i++)
+        {
+            bool schedulable = i < lines.size() && lines[i].instruction.schedulable;
+            if (schedulable && i - regionStart < MAX_REGION)
+                continue;
+            scheduleRegion(lines, regionStart, i, result);
+            if (i < lines.size() && !schedulable)
+            {
+                result += lines[i].text;
+                result += '\n';
+                regionStart = i + 1;
+            }
+            else
+                regionStart = i;
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t MAX_REGION = 256; ///< Borne le coût quadratique du graphe
+
+    /** Ressources suivies : les 16 registres généraux, les drapeaux, les registres vectoriels */
+    enum Resource : int
+    {
+        RSP = 4,
+        FLAGS = 16,
+        VECTOR = 17,
+    };
+
+    /** Zone de mémoire touchée par un accès */
+    enum class MemoryClass
+    {
+        NONE,
+        FRAME,  // [rbp +/- constante] : variables du cadre
+        STACK,  // push, pop, [rsp...] : zone de la pile sous les variables
+        HEAP,   // Tableaux (mmap), jamais dans la pile
+        GLOBAL, // [rel ...] : données du runtime et tables constantes
+    };
+
+    struct Instruction
+    {
+        bool schedulable = false;
+        std::string mnemonic;
+        std::vector<std::string> operands;
+        uint32_t reads = 0;  ///< Masque de Resource
+        uint32_t writes = 0;
+        MemoryClass memory = MemoryClass::NONE;
+        bool memoryWrite = false;
+        std::string slot; ///< FRAME : adresse exacte, vide si elle dépend d'un registre
+        // push [x] et pop [x] touchent aussi la mémoire de leur opérande, en plus de la pile
+        MemoryClass operandMemory = MemoryClass::NONE;
+        bool operandWrite = false;
+        std::string operandSlot;
+        int latency = 1;
+    };
+
+    struct Line
+    {
+        std::string text;
+        Instruction instruction;
+    };
+
+    static std::vector<Line> parse(const std::string &assembly)
+    {
+        std::vector<Line> lines;
+        std::istringstream stream(assembly);
+        std::string text;
+        while (std::getline(stream, text))
+            lines.push_back({text, decode(text)});
+        return lines;
+    }
+
+    /**
+     * @brief Famille (0 à 15) d'un registre général, -1 sinon ; `partial` vaut vrai pour 8 et 16 bits
+     */
+    static int registerFamily(const std::string &name, bool &partial)
+    {
+        static const char *const names[16][4] = {
+            {"rax", "eax", "ax", "al"},     {"rcx", "ecx", "cx", "cl"},     {"rdx", "edx", "dx", "dl"},
+            {"rbx", "ebx", "bx", "bl"},     {"rsp", "esp", "sp", "spl"},    {"rbp", "ebp", "bp", "bpl"},
+            {"rsi", "esi", "si", "sil"},    {"rdi", "edi", "di", "dil"},    {"r8", "r8d", "r8w", "r8b"},
+            {"r9", "r9d", "r9w", "r9b"},    {"r10", "r10d", "r10w", "r10b"}, {"r11", "r11d", "r11w", "r11b"},
+            {"r12", "r12d", "r12w", "r12b"}, {"r13", "r13d", "r13w", "r13b"}, {"r14", "r14d", "r14w", "r14b"},
+            {"r15", "r15d", "r15w", "r15b"}};
+        for (int family = 0; family < 16; family++)
+            for (int width = 0; width < 4; width++)
+                if (name == names[family][width])
+                {
+                    partial = width >= 2;
+                    return family;
+                }
+        if (name == "ah" || name == "bh" || name == "ch" || name == "dh")
+        {
+            partial = true;
+            return name[0] == 'a' ? 0 : name[0] == 'b' ? 3 : name[0] == 'c' ? 1 : 2;
+        }
+        return -1;
+    }
+
+    static bool isVectorRegister(const std::string &name)
+    {
+        return name.rfind("xmm", 0) == 0 || name.rfind("ymm", 0) == 0 || name.rfind("zmm", 0) == 0;
+    }
+
+    /**
+     * @brief Registres lus par une adresse [...] et zone mémoire touchée
+     */
+    static void decodeAddress(const std::string &operand, Instruction &instr)
+    {
+        size_t open = operand.find('[');
+        std::string inside = operand.substr(open + 1, operand.rfind(']') - open - 1);
+        if (inside.rfind("rel ", 0) == 0)
+        {
+            instr.memory = MemoryClass::GLOBAL;
+            return;
+        }
+
+        std::string slot;
+        int registers = 0;
+        bool usesRbp = false, usesRsp = false;
+        std::string word;
+        for (size_t i = 0; i <= inside.size(); i++)
+        {
+            char c = i < inside.size() ? inside[i] : '+';
+            if (c != ' ')
+                slot += c;
+            if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+            {
+                word += c;
+                continue;
+            }
+            bool partial;
+            int family = registerFamily(word, partial);
+            if (family >= 0)
+            {
+                instr.reads |= 1u << family;
+                registers++;
+                usesRbp |= family == 5;
+                usesRsp |= family == RSP;
+            }
+            word.clear();
+        }
+        if (usesRsp)
+            instr.memory = MemoryClass::STACK;
+        else if (usesRbp)
+        {
+            instr.memory = MemoryClass::FRAME;
+            instr.slot = registers == 1 ? slot.substr(0, slot.size() - 1) : ""; // Sans le '+' final
+        }
+        else
+            instr.memory = MemoryClass::HEAP;
+    }
+
+    /**
+     * @brief Effet d'un opérande : lu, écrit ou les deux
+     */
+    static void addOperand(const std::string &operand, bool read, bool write, Instruction &instr)
+    {
+        if (operand.find('[') != std::string::npos)
+        {
+            decodeAddress(operand, instr);
+            instr.memoryWrite |= write;
+            if (read)
+                instr.latency += 4;
+            return;
+        }
+        if (isVectorRegister(operand))
+        {
+            instr.reads |= read ? 1u << VECTOR : 0;
+            instr.writes |= write ? 1u << VECTOR : 0;
+            return;
+        }
+        bool partial = false;
+        int family = registerFamily(operand, partial);
+        if (family < 0)
+            return; // Constante ou label
+        if (read || (write && partial)) // Une écriture de 8 ou 16 bits garde le reste du registre
+            instr.reads |= 1u << family;
+        if (write)
+            instr.writes |= 1u << family;
+    }
+
+    /**
+     * @brief Décode une ligne ; seules les instructions connues sont déplaçables
+     */
+    static Instruction decode(const std::string &text)
+    {
+        Instruction instr;
+        if (text.empty() || (text[0] != ' ' && text[0] != '\t'))
+            return instr; // Label, directive, section ou données
+
+        std::string code = text.substr(0, text.find(';'));
+        std::istringstream words(code);
+        if (!(words >> instr.mnemonic))
+            return instr; // Commentaire
+        std::string rest;
+        std::getline(words, rest);
+        std::string operand;
+        for (char c : rest + ",")
+        {
+            if (c == ',')
+            {
+                size_t begin = operand.find_first_not_of(' ');
+                size_t end = operand.find_last_not_of(' ');
+                if (begin != std::string::npos)
+                    instr.operands.push_back(operand.substr(begin, end - begin + 1));
+                operand.clear();
+            }
+            else
+                operand += c;
+        }
+        for (std::string &op : instr.operands)
+            for (const char *size : {"qword ", "dword ", "word ", "byte "})
+                if (op.rfind(size, 0) == 0)
+                    op = op.substr(std::string(size).size());
+
+        const std::string &m = instr.mnemonic;
+        const std::vector<std::string> &ops = instr.operands;
+        uint32_t flags = 1u << FLAGS;
+        instr.schedulable = true;
+
+        if (ops.size() == 2 && (m == "mov" || m == "movzx" || m == "movsx" || m == "movsxd" || m == "movdqa" ||
+                                m == "movdqu" || m == "vmovdqa" || m == "vmovdqu" || m == "vmovdqa64" ||
+                                m == "vmovdqu64"))
+        {
+            addOperand(ops[0], false, true, instr);
+            addOperand(ops[1], true, false, instr);
+        }
+        else if (ops.size() == 2 && m == "lea")
+        {
+            addOperand(ops[0], false, true, instr);
+            Instruction address;
+            decodeAddress(ops[1], address); // Calcul d'adresse, sans accès mémoire
+            instr.reads |= address.reads;
+        }
+        else if (ops.size() == 2 && (m == "add" || m == "sub" || m == "and" || m == "or" || m == "xor" ||
+                                     m == "shl" || m == "shr" || m == "sar" || m == "imul"))
+        {
+            addOperand(ops[0], true, true, instr);
+            addOperand(ops[1], true, false, instr);
+            instr.writes |= flags;
+            if (m == "imul")
+                instr.latency += 2;
+        }
+        else if (ops.size() == 2 && (m == "cmp" || m == "test"))
+        {
+            addOperand(ops[0], true, false, instr);
+            addOperand(ops[1], true, false, instr);
+            instr.writes |= flags;
+        }
+        else if (ops.size() == 1 && m.rfind("set", 0) == 0)
+        {
+            addOperand(ops[0], false, true, instr);
+            instr.reads |= flags;
+        }
+        else if (ops.size() == 1 && (m == "inc" || m == "dec" || m == "neg" || m == "not"))
+        {
+            addOperand(ops[0], true, true, instr);
+            if (m != "not")
+                instr.writes |= flags;
+        }
+        else if (ops.empty() && m == "cqo")
+        {
+            instr.reads |= 1u << 0;
+            instr.writes |= 1u << 2;
+        }
+        else if (ops.size() == 1 && (m == "idiv" || m == "div"))
+        {
+            addOperand(ops[0], true, false, instr);
+            instr.reads |= (1u << 0) | (1u << 2);
+            instr.writes |= (1u << 0) | (1u << 2) | flags;
+            instr.latency += 39;
+        }
+        else if (ops.size() == 1 && m == "push")
+        {
+            addOperand(ops[0], true, false, instr);
+            moveToOperand(instr);
+            instr.reads |= 1u << RSP;
+            instr.writes |= 1u << RSP;
+            instr.memory = MemoryClass::STACK;
+            instr.memoryWrite = true;
+        }
+        else if (ops.size() == 1 && m == "pop")
+        {
+            addOperand(ops[0], false, true, instr);
+            moveToOperand(instr);
+            instr.reads |= 1u << RSP;
+            instr.writes |= 1u << RSP;
+            instr.memory = MemoryClass::STACK;
+            instr.latency += 4;
+        }
+        else if (ops.empty() && m == "vzeroupper")
+            instr.writes |= 1u << VECTOR;
+        else
+            instr.schedulable = false; // Sauts, appels, syscall, ret... et tout le reste
+        return instr;
+    }
+
+    /**
+     * @brief Range l'accès mémoire de l'opérande d'un push ou pop à part, avant que
+     * l'instruction ne devienne un accès à la pile
+     */
+    static void moveToOperand(Instruction &instr)
+    {
+        instr.operandMemory = instr.memory;
+        instr.operandWrite = instr.memoryWrite;
+        instr.operandSlot = std::move(instr.slot);
+        instr.memory = MemoryClass::NONE;
+        instr.memoryWrite = false;
+        instr.slot.clear();
+    }
+
+    static bool isTrapJump(const Instruction &instr)
+    {
+        return instr.mnemonic.size() >= 2 && instr.mnemonic[0] == 'j' && instr.operands.size() == 1 &&
+               instr.operands[0].rfind("yb_rt_", 0) == 0 && instr.operands[0].find("_trap") != std::string::npos;
+    }
+
+    /**
+     * @brief Remplace les paires push/pop d'un même bloc par des mov vers r8-r11
+     */
+    static void renameStackPairs(std::vector<Line> &lines)
+    {
+        static const char *const scratch[] = {"r8", "r9", "r10", "r11"};
+
+        // Premier passage : paires dont la valeur ne peut passer que par la pile
+        std::vector<long> partner(lines.size(), -1);
+        std::vector<size_t> open; // push sans leur pop, le plus récent à la fin
+        std::vector<bool> escaped(lines.size(), false);
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            const Instruction &instr = lines[i].instruction;
+            if (instr.mnemonic == "push")
+                open.push_back(i);
+            else if (instr.mnemonic == "pop")
+            {
+                if (open.empty())
+                    continue; // Valeur poussée dans un bloc précédent
+                if (!escaped[open.back()])
+                {
+                    partner[open.back()] = static_cast<long>(i);
+                    partner[i] = static_cast<long>(open.back());
+                }
+                open.pop_back();
+            }
+            else if (!instr.schedulable && !isTrapJump(instr) && !isComment(lines[i].text))
+            {
+                // Label, saut ou appel : les valeurs ouvertes restent sur la pile
+                for (size_t index : open)
+                    escaped[index] = true;
+                open.clear();
+            }
+            else if (((instr.reads | instr.writes) & (1u << RSP)) || instr.memory == MemoryClass::STACK)
+            {
+                // Accès direct à la pile (mov rbx, [rsp]...) : les valeurs ouvertes doivent y être
+                for (size_t index : open)
+                    escaped[index] = true;
+            }
+        }
+
+        // Second passage : si le registre du pop n'est pas touché entre les deux, la valeur y
+        // est copiée dès le push ; sinon elle passe par r8-r11 selon la profondeur, et au-delà
+        // de quatre la pile reste utilisée
+        std::vector<int> depth;
+        std::vector<bool> removed(lines.size(), false);
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            Instruction &instr = lines[i].instruction;
+            if (partner[i] < 0)
+                continue;
+            if (instr.mnemonic == "push")
+            {
+                size_t pop = static_cast<size_t>(partner[i]);
+                bool partial = true;
+                const std::string &target = lines[pop].instruction.operands[0];
+                int family = registerFamily(target, partial);
+                uint32_t used = 0;
+                for (size_t k = i + 1; k < pop; k++)
+                    used |= lines[k].instruction.reads | lines[k].instruction.writes;
+                if (family >= 0 && !partial && !(used & (1u << family)))
+                {
+                    depth.push_back(-1);
+                    removed[pop] = true;
+                    if (target == instr.operands[0])
+                        removed[i] = true; // push rax ... pop rax
+                    else
+                    {
+                        lines[i].text = "    mov " + target + ", " + instr.operands[0];
+                        lines[i].instruction = decode(lines[i].text);
+                    }
+                    continue;
+                }
+                int level = static_cast<int>(depth.size());
+                depth.push_back(level < 4 ? level : -1);
+                if (level >= 4)
+                    continue;
+                lines[i].text = "    mov " + std::string(scratch[level]) + ", " + instr.operands[0];
+            }
+            else
+            {
+                int level = depth.back();
+                depth.pop_back();
+                if (level < 0)
+                    continue;
+                lines[i].text = "    mov " + instr.operands[0] + ", " + scratch[level];
+            }
+            lines[i].instruction = decode(lines[i].text);
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < lines.size(); i++)
+            if (!removed[i])
+            {
+                if (kept != i)
+                    lines[kept] = std::move(lines[i]);
+                kept++;
+            }
+        lines.resize(kept);
+    }
+
+    static bool isComment(const std::string &text)
+    {
+        size_t first = text.find_first_not_of(" \t");
+        return first == std::string::npos || text[first] == ';';
+    }
+
+    static bool accessConflict(MemoryClass a, bool writeA, const std::string &slotA,
+                               MemoryClass b, bool writeB, const std::string &slotB)
+    {
+        if (a == MemoryClass::NONE || b == MemoryClass::NONE || (!writeA && !writeB))
+            return false;
+        bool stackA = a == MemoryClass::FRAME || a == MemoryClass::STACK;
+        bool stackB = b == MemoryClass::FRAME || b == MemoryClass::STACK;
+        if (stackA && stackB)
+            // Deux variables distinctes du cadre ne se recouvrent pas ; la pile peut recouvrir
+            // une variable pas encore déclarée
+            return !(a == MemoryClass::FRAME && b == MemoryClass::FRAME && !slotA.empty() &&
+                     !slotB.empty() && slotA != slotB);
+        return a == b;
+    }
+
+    static bool memoryConflict(const Instruction &a, const Instruction &b)
+    {
+        return accessConflict(a.memory, a.memoryWrite, a.slot, b.memory, b.memoryWrite, b.slot) ||
+               accessConflict(a.operandMemory, a.operandWrite, a.operandSlot, b.memory, b.memoryWrite, b.slot) ||
+               accessConflict(a.memory, a.memoryWrite, a.slot, b.operandMemory, b.operandWrite, b.operandSlot) ||
+               accessConflict(a.operandMemory, a.operandWrite, a.operandSlot, b.operandMemory, b.operandWrite,
+                              b.operandSlot);
+    }
+
+    /**
+     * @brief Registres dont dépend l'instruction, rsp compris pour tout accès au cadre ou à la pile
+     *
+     * Une variable [rbp-N] n'est à l'abri d'un signal qu'au-dessus de rsp : l'accès ne passe
+     * ni avant le sub rsp qui la réserve ni après le add rsp qui la libère.
+     */
+    static uint32_t dependencyReads(const Instruction &instr)
+    {
+        auto onStack = [](MemoryClass memory)
+        { return memory == MemoryClass::FRAME || memory == MemoryClass::STACK; };
+        return instr.reads | (onStack(instr.memory) || onStack(instr.operandMemory) ? 1u << RSP : 0);
+    }
+
+    /**
+     * @brief Ordonnancement par liste des lignes [begin, end), toutes déplaçables
+     */
+    static void scheduleRegion(const std::vector<Line> &lines, size_t begin, size_t end, std::string &result)
+    {
+        size_t count = end - begin;
+        std::vector<std::vector<std::pair<size_t, int>>> successors(count); // (nœud, latence)
+        std::vector<int> pending(count, 0);
+        for (size_t j = 0; j < count; j++)
+        {
+            const Instruction &later = lines[begin + j].instruction;
+            for (size_t i = 0; i < j; i++)
+            {
+                const Instruction &earlier = lines[begin + i].instruction;
+                bool trueDependency = (earlier.writes & dependencyReads(later)) != 0;
+                bool ordered = (dependencyReads(earlier) & later.writes) || (earlier.writes & later.writes) ||
+                               memoryConflict(earlier, later);
+                if (!trueDependency && !ordered)
+                    continue;
+                // Une lecture après une écriture en mémoire attend aussi la latence
+                bool laterLoads = (later.memory != MemoryClass::NONE && !later.memoryWrite) ||
+                                  (later.operandMemory != MemoryClass::NONE && !later.operandWrite);
+                bool memoryValue = (earlier.memoryWrite || earlier.operandWrite) && laterLoads &&
+                                   memoryConflict(earlier, later);
+                successors[i].push_back({j, trueDependency || memoryValue ? earlier.latency : 0});
+                pending[j]++;
+            }
+        }
+
+        // Priorité : plus long chemin (en cycles) jusqu'à la fin du bloc
+        std::vector<int> height(count, 0);
+        for (size_t i = count; i-- > 0;)
+        {
+            height[i] = lines[begin + i].instruction.latency;
+            for (const auto &edge : successors[i])
+                height[i] = std::max(height[i], edge.second + height[edge.first]);
+        }
+
+        std::vector<int> earliest(count, 0);
+        std::vector<bool> done(count, false);
+        int cycle = 0;
+        for (size_t placed = 0; placed < count; placed++)
+        {
+            // Une instruction prête à ce cycle, la plus prioritaire ; sinon celle qui attend le moins
+            size_t best = count;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (done[i] || pending[i] > 0)
+                    continue;
+                if (best == count)
+                {
+                    best = i;
+                    continue;
+                }
+                bool readyI = earliest[i] <= cycle, readyBest = earliest[best] <= cycle;
+                if (readyI != readyBest ? readyI
+                                        : readyI ? height[i] > height[best]
+                                                 : earliest[i] < earliest[best] ||
+                                                       (earliest[i] == earliest[best] && height[i] > height[best]))
+                    best = i;
+            }
+            done[best] = true;
+            cycle = std::max(cycle, earliest[best]) + 1;
+            for (const auto &edge : successors[best])
+            {
+                earliest[edge.first] = std::max(earliest[edge.first], cycle - 1 + edge.second);
+                pending[edge.first]--;
+            }
+            result += lines[begin + best].text;
+            result += '\n';
+        }
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <thread>
+
+/**
+ * @file SpscQueue.hpp
+ * @brief File bornée sans verrou entre un seul producteur et un seul consommateur.
+ *
+ * Utilisée par le pipeline de compilation (voir Pipeline.hpp) : chaque étage tourne
+ * dans son propre thread et transmet son travail à l'étage suivant par une de ces files.
+ */
+
+/**
+ * @class SpscQueue
+ * @brief Tampon circulaire de Capacity éléments, un thread écrit et un thread lit
+ *
+ * Le producteur ne modifie que m_tail, le consommateur que m_head : chacun publie sa
+ * position avec une écriture release et lit celle de l'autre avec une lecture acquire.
+ * Les deux indices sont sur des lignes de cache différentes pour que les deux cœurs
+ * ne se disputent pas la même ligne. Une file pleine (ou vide) fait attendre le thread
+ * avec std::this_thread::yield.
+ *
+ * Le consommateur peut fermer la file (close) pour arrêter le producteur, par exemple
+ * après une erreur : push renvoie alors false.
+ *
+ * @tparam T Type des éléments (déplacé à l'entrée et à la sortie)
+ * @tparam Capacity Nombre d'emplacements, puissance de deux
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity doit etre une puissance de deux");
+
+public:
+    SpscQueue() : m_slots(new std::optional<T>[Capacity]) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * @brief Ajoute un élément, en attendant une place libre (côté producteur)
+     * @return false si le consommateur a fermé la file
+     */
+    bool push(T value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        while (tail - m_head.load(std::memory_order_acquire) == Capacity)
+        {
+            if (m_closed.load(std::memory_order_relaxed))
+                return false;
+            std::this_thread::yield();
+        }
+        if (m_closed.load(std::memory_order_relaxed))
+            return false;
+
+        m_slots[tail & (Capacity - 1)] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Retire le plus ancien élément, en attendant qu'il y en ait un (côté consommateur)
+     */
+    T pop()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        while (m_tail.load(std::memory_order_acquire) == head)
+            std::this_thread::yield();
+
+        std::optional<T> &slot = m_slots[head & (Capacity - 1)];
+        T value = std::move(*slot);
+        slot.reset();
+        m_head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @brief Ferme la file : les push suivants (et ceux en attente) échouent (côté consommateur)
+     */
+    void close()
+    {
+        m_closed.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::unique_ptr<std::optional<T>[]> m_slots;
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0}; ///< Prochain élément à lire
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0}; ///< Prochain emplacement à écrire
+    alignas(CACHE_LINE) std::atomic<bool> m_closed{false};
+};
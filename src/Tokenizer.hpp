@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <string>
 #include <sstream>
 #include <optional>
@@ -54,6 +56,10 @@ enum class TokenType
     WHILE,        /**< Mot clé 'while' */
     PRINT,        /**< Mot clé 'print' */
     LENGTH,       /**< Mot clé 'length' */
+    MATRIX,       /**< Mot clé 'matrix' */
+    PARAM,        /**< Mot clé 'param' */
+    MATCH,        /**< Mot clé 'match' */
+    FAT_ARROW,    /**< Flèche '=>' d'une branche de match */
     UNKNOWN       /**< Token non reconnu */
 };
 
@@ -67,16 +73,93 @@ struct Token
 {
     TokenType type;                   /**< Type du token */
     std::optional<std::string> value; /**< Valeur du token (si applicable) */
+    int line = 0;                     /**< Ligne du source où commence le token (à partir de 1) */
+};
+
+/**
+ * @class TokenStream
+ * @brief Suite de tokens produite à la demande.
+ *
+ * Les classes dérivées fournissent les tokens un par un (produce). peek(k) donne accès
+ * aux LOOKAHEAD prochains tokens sans les consommer : ils sont gardés dans un petit
+ * tampon circulaire, le parser n'a pas besoin de vecteur de tokens.
+ */
+class TokenStream
+{
+public:
+    virtual ~TokenStream() = default;
+
+    /**
+     * @brief Produit le token suivant.
+     * @return Le token, ou std::nullopt à la fin du source.
+     */
+    std::optional<Token> next()
+    {
+        if (m_lookaheadCount == 0)
+            return produce();
+
+        std::optional<Token> token = std::move(m_lookahead[m_lookaheadHead]);
+        m_lookaheadHead = (m_lookaheadHead + 1) % LOOKAHEAD;
+        m_lookaheadCount--;
+        return token;
+    }
+
+    /**
+     * @brief Donne le k-ième token à venir sans le consommer (peek(0) est celui que next() rendra)
+     * @param k Décalage, strictement inférieur à LOOKAHEAD
+     * @return Le token, ou nullptr s'il est après la fin du source
+     * @note Le pointeur reste valide jusqu'au prochain appel à next()
+     */
+    const Token *peek(size_t k = 0)
+    {
+        // Au-delà, la boucle écraserait le token de tête du tampon circulaire
+        assert(k < LOOKAHEAD && "peek() au-delà de TokenStream::LOOKAHEAD");
+        while (m_lookaheadCount <= k)
+        {
+            std::optional<Token> &slot = m_lookahead[(m_lookaheadHead + m_lookaheadCount) % LOOKAHEAD];
+            slot = produce();
+            if (!slot)
+                return nullptr;
+            m_lookaheadCount++;
+        }
+        return &*m_lookahead[(m_lookaheadHead + k) % LOOKAHEAD];
+    }
+
+    /**
+     * @brief Nombre de tokens accessibles par peek()
+     */
+    static constexpr size_t LOOKAHEAD = 4;
+
+protected:
+    /**
+     * @brief Fournit le token qui suit le dernier produit, std::nullopt à la fin
+     */
+    virtual std::optional<Token> produce() = 0;
+
+    /**
+     * @brief Oublie les tokens en attente (pour reprendre depuis le début)
+     */
+    void clearLookahead()
+    {
+        m_lookaheadCount = 0;
+    }
+
+private:
+    std::optional<Token> m_lookahead[LOOKAHEAD]; /**< Tokens lus par peek() et pas encore consommés */
+    size_t m_lookaheadHead = 0;                  /**< Emplacement du prochain token */
+    size_t m_lookaheadCount = 0;                 /**< Nombre de tokens en attente */
 };
 
 /**
  * @class Tokenizer
  * @brief Classe responsable de l'analyse lexicale du code source.
  *
- * Cette classe analyse une chaîne de caractères représentant le code source
- * et la convertit en une séquence de tokens.
+ * Cette classe analyse le code source et le convertit en une séquence de tokens.
+ * Les tokens sont produits à la demande par next() : le source peut être une chaîne
+ * complète ou un flux, lu par blocs de CHUNK_SIZE octets. Dans ce cas seuls les
+ * caractères du token en cours sont gardés en mémoire, quelle que soit la taille du fichier.
  */
-class Tokenizer
+class Tokenizer : public TokenStream
 {
 public:
     /**
@@ -85,68 +168,99 @@ public:
      */
     Tokenizer(const std::string &input) : m_input(input) {}
 
+    /**
+     * @brief Constructeur qui lit le code source au fur et à mesure depuis un flux.
+     * @param stream Flux du code source, qui doit rester valide pendant l'analyse.
+     */
+    Tokenizer(std::istream &stream) : m_stream(&stream) {}
+
     /**
      * @brief Analyse le code source pour produire une séquence de tokens.
+     *
+     * Pour un source en chaîne, l'analyse reprend depuis le début à chaque appel ;
+     * pour un flux, elle produit les tokens restants.
+     *
      * @return Un vecteur contenant les tokens identifiés dans le code source.
      */
-    std::vector<Token> tokenize() const
+    std::vector<Token> tokenize()
     {
-        const std::unordered_map<std::string, TokenType> keywords = {
-            {"exit", TokenType::EXIT},
-            {"let", TokenType::LET},
-            {"if", TokenType::IF},
-            {"else", TokenType::ELSE},
-            {"while", TokenType::WHILE},
-            {"print", TokenType::PRINT},
-            {"len", TokenType::LENGTH}
-            
-        };
+        if (!m_stream)
+        {
+            m_position = 0;
+            m_line = 1;
+            clearLookahead();
+        }
         std::vector<Token> tokens;
-        int position = 0;
-        while (position < m_input.size())
+        while (auto token = next())
         {
+            tokens.push_back(std::move(*token));
+        }
+        return tokens;
+    }
+
+protected:
+    std::optional<Token> produce() override
+    {
+        return lex();
+    }
+
+private:
+    /**
+     * @brief Analyse le token suivant du source.
+     * @return Le token, ou std::nullopt à la fin du source.
+     */
+    std::optional<Token> lex()
+    {
+        size_t &position = m_position;
+        while (available(position))
+        {
+            // Rien avant le token courant ne sera relu : le tampon peut l'oublier
+            m_keep = position;
+
             //  ici on doit ignorer les espaces avant de chaque token
-            if (std::isspace(m_input[position]))
+            if (std::isspace(static_cast<unsigned char>(at(position))))
             {
+                if (at(position) == '\n')
+                    m_line++;
                 position++;
                 continue;
             }
 
             // ici &&
-            if (m_input[position] == '&' && position + 1 < m_input.size() && m_input[position + 1] == '&')
+            if (at(position) == '&' && available(position + 1) && at(position + 1) == '&')
             {
-                tokens.push_back({TokenType::AND, "&&"});
                 position += 2;
-                continue;
+                return makeToken(TokenType::AND, "&&");
             }
             // ici ||
-            if (m_input[position] == '|' && position + 1 < m_input.size() && m_input[position + 1] == '|')
+            if (at(position) == '|' && available(position + 1) && at(position + 1) == '|')
             {
-                tokens.push_back({TokenType::OR, "||"});
                 position += 2;
-                continue;
+                return makeToken(TokenType::OR, "||");
             }
 
             // ici on doit ignorer les commentaires sur une ligne
-            if (m_input[position] == '/' && position + 1 < m_input.size() && m_input[position + 1] == '/')
+            if (at(position) == '/' && available(position + 1) && at(position + 1) == '/')
             {
-                while (position < m_input.size() && m_input[position] != '\n')
+                while (available(position) && at(position) != '\n')
                 {
-                    position++;
+                    m_keep = position++;
                 }
                 continue;
             }
 
             // ici on doit ignorer les commentaires sur plusieurs lignes
-            if (m_input[position] == '/' && position + 1 < m_input.size() && m_input[position + 1] == '*')
+            if (at(position) == '/' && available(position + 1) && at(position + 1) == '*')
             {
                 bool closed = false;
                 position += 2;
-                while (position < m_input.size() && !(m_input[position] == '*' && position + 1 < m_input.size() && m_input[position + 1] == '/'))
+                while (available(position) && !(at(position) == '*' && available(position + 1) && at(position + 1) == '/'))
                 {
-                    position++;
+                    if (at(position) == '\n')
+                        m_line++;
+                    m_keep = position++;
                 }
-                if (position < m_input.size())
+                if (available(position))
                 {
                     position += 2;
                     closed = true;
@@ -161,199 +275,260 @@ public:
             }
 
             // si on rencontre un caractere alphabetique ou underscore
-            if (std::isalpha(m_input[position]) || m_input[position] == '_')
+            if (std::isalpha(static_cast<unsigned char>(at(position))) || at(position) == '_')
             {
                 std::string identifier = consumeIdentifier(position);
 
-                auto it = keywords.find(identifier);
-                if (it != keywords.end())
-                {
-                    tokens.push_back({it->second, identifier});
-                }
-                else
+                auto it = keywords().find(identifier);
+                if (it != keywords().end())
                 {
-                    tokens.push_back({TokenType::IDENTIFIER, identifier});
+                    return makeToken(it->second, identifier);
                 }
-                continue;
+                return makeToken(TokenType::IDENTIFIER, identifier);
             }
 
             // si on trouve un nombre
-            if (std::isdigit(m_input[position]))
+            if (std::isdigit(static_cast<unsigned char>(at(position))))
             {
                 Token token = StartNumToken(position);
-                tokens.push_back(token);
-                continue;
+                token.line = m_line;
+                return token;
             }
 
             // ici c'est (
-            if (m_input[position] == '(')
+            if (at(position) == '(')
             {
-                tokens.push_back({TokenType::LPARENTHESIS, "("});
                 position++;
-                continue;
+                return makeToken(TokenType::LPARENTHESIS, "(");
             }
 
             // ici c'est )
-            if (m_input[position] == ')')
+            if (at(position) == ')')
             {
-                tokens.push_back({TokenType::RPARENTHESIS, ")"});
                 position++;
-                continue;
+                return makeToken(TokenType::RPARENTHESIS, ")");
             }
 
             // ici c'est ==
-            if (m_input[position] == '=' && position + 1 < m_input.size() && m_input[position + 1] == '=')
+            if (at(position) == '=' && available(position + 1) && at(position + 1) == '=')
             {
-                tokens.push_back({TokenType::EGAL, "=="});
                 position += 2;
-                continue;
+                return makeToken(TokenType::EGAL, "==");
+            }
+
+            // ici c'est =>
+            if (at(position) == '=' && available(position + 1) && at(position + 1) == '>')
+            {
+                position += 2;
+                return makeToken(TokenType::FAT_ARROW, "=>");
             }
 
             // ici c'est !=
-            if (m_input[position] == '!' && position + 1 < m_input.size() && m_input[position + 1] == '=')
+            if (at(position) == '!' && available(position + 1) && at(position + 1) == '=')
             {
-                tokens.push_back({TokenType::NEGAL, "!="});
                 position += 2;
-                continue;
+                return makeToken(TokenType::NEGAL, "!=");
             }
 
             // ici c'est >=
-            if (m_input[position] == '>' && position + 1 < m_input.size() && m_input[position + 1] == '=')
+            if (at(position) == '>' && available(position + 1) && at(position + 1) == '=')
             {
-                tokens.push_back({TokenType::GREAT_EQUAL, ">="});
                 position += 2;
-                continue;
+                return makeToken(TokenType::GREAT_EQUAL, ">=");
             }
 
             // ici c'est <=
-            if (m_input[position] == '<' && position + 1 < m_input.size() && m_input[position + 1] == '=')
+            if (at(position) == '<' && available(position + 1) && at(position + 1) == '=')
             {
-                tokens.push_back({TokenType::LESS_EQUAL, "<="});
                 position += 2;
-                continue;
+                return makeToken(TokenType::LESS_EQUAL, "<=");
             }
 
             // ici c'est >
-            if (m_input[position] == '>')
+            if (at(position) == '>')
             {
-                tokens.push_back({TokenType::GREAT, ">"});
                 position++;
-                continue;
+                return makeToken(TokenType::GREAT, ">");
             }
 
             // ici c'est <
-            if (m_input[position] == '<')
+            if (at(position) == '<')
             {
-                tokens.push_back({TokenType::LESS, "<"});
                 position++;
-                continue;
+                return makeToken(TokenType::LESS, "<");
             }
             // ici c'est =
-            if (m_input[position] == '=')
+            if (at(position) == '=')
             {
-                tokens.push_back({TokenType::EQUAL, "="});
                 position++;
-                continue;
+                return makeToken(TokenType::EQUAL, "=");
             }
 
             // ici c'est -
-            if (m_input[position] == '-')
+            if (at(position) == '-')
             {
-                tokens.push_back({TokenType::MINUS, "-"});
                 position++;
-                continue;
+                return makeToken(TokenType::MINUS, "-");
             }
 
             // ici c'est +
-            if (m_input[position] == '+')
+            if (at(position) == '+')
             {
-                tokens.push_back({TokenType::PLUS, "+"});
                 position++;
-                continue;
+                return makeToken(TokenType::PLUS, "+");
             }
 
             // ici c'est /
-            if (m_input[position] == '/')
+            if (at(position) == '/')
             {
-                tokens.push_back({TokenType::DIVIDE, "/"});
                 position++;
-                continue;
+                return makeToken(TokenType::DIVIDE, "/");
             }
 
             // ici c'est %
-            if (m_input[position] == '%')
+            if (at(position) == '%')
             {
-                tokens.push_back({TokenType::MODULO, "%"});
                 position++;
-                continue;
+                return makeToken(TokenType::MODULO, "%");
             }
 
             // ici c'est *
-            if (m_input[position] == '*')
+            if (at(position) == '*')
             {
-                tokens.push_back({TokenType::STAR, "*"});
                 position++;
-                continue;
+                return makeToken(TokenType::STAR, "*");
             }
 
             // ici c'est {
-            if (m_input[position] == '{')
+            if (at(position) == '{')
             {
-                tokens.push_back({TokenType::LBRACE, "{"});
                 position++;
-                continue;
+                return makeToken(TokenType::LBRACE, "{");
             }
 
             // ici c'est }
-            if (m_input[position] == '}')
+            if (at(position) == '}')
             {
-                tokens.push_back({TokenType::RBRACE, "}"});
                 position++;
-                continue;
+                return makeToken(TokenType::RBRACE, "}");
             }
 
             // ici  c'est [
-            if (m_input[position] == '[')
+            if (at(position) == '[')
             {
-                tokens.push_back({TokenType::LBRACKET, "["});
                 position++;
-                continue;
+                return makeToken(TokenType::LBRACKET, "[");
             }
             // ici c'est ]
-            if (m_input[position] == ']')
+            if (at(position) == ']')
             {
-                tokens.push_back({TokenType::RBRACKET, "]"});
                 position++;
-                continue;
+                return makeToken(TokenType::RBRACKET, "]");
             }
 
             // ici c'est ;
-            if (m_input[position] == ';')
+            if (at(position) == ';')
             {
-                tokens.push_back({TokenType::SEMICOLON, ";"});
                 position++;
-                continue;
+                return makeToken(TokenType::SEMICOLON, ";");
             }
 
             // ici c'est ,
-            if (m_input[position] == ',')
+            if (at(position) == ',')
             {
-                tokens.push_back({TokenType::COMMA, ","});
                 position++;
-                continue;
+                return makeToken(TokenType::COMMA, ",");
             }
 
             // Les OVNI
             std::string unknown;
-            unknown += m_input[position++];
-            tokens.push_back({TokenType::UNKNOWN, unknown});
+            unknown += at(position++);
+            return makeToken(TokenType::UNKNOWN, unknown);
         }
 
-        return tokens;
+        return std::nullopt;
     }
 
-private:
-    std::string m_input; /**< Code source à analyser */
+    /**
+     * @brief Taille des blocs lus depuis un flux
+     */
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    std::string m_input;              /**< Code source, ou partie du flux encore utile */
+    std::istream *m_stream = nullptr; /**< Flux du code source (nullptr pour une chaîne) */
+    size_t m_offset = 0;              /**< Position dans le source du premier caractère de m_input */
+    size_t m_position = 0;            /**< Position courante dans le source */
+    size_t m_keep = 0;                /**< Les caractères avant cette position ne sont plus lus */
+    int m_line = 1;                   /**< Ligne de la position courante */
+
+    /**
+     * @brief Mots clés du langage
+     */
+    static const std::unordered_map<std::string, TokenType> &keywords()
+    {
+        static const std::unordered_map<std::string, TokenType> table = {
+            {"exit", TokenType::EXIT},
+            {"let", TokenType::LET},
+            {"if", TokenType::IF},
+            {"else", TokenType::ELSE},
+            {"while", TokenType::WHILE},
+            {"print", TokenType::PRINT},
+            {"len", TokenType::LENGTH},
+            {"matrix", TokenType::MATRIX},
+            {"param", TokenType::PARAM},
+            {"match", TokenType::MATCH}
+        };
+        return table;
+    }
+
+    Token makeToken(TokenType type, std::string value) const
+    {
+        return {type, std::move(value), m_line};
+    }
+
+    /**
+     * @brief Caractère à une position du source (qui doit être disponible)
+     */
+    char at(size_t position) const
+    {
+        return m_input[position - m_offset];
+    }
+
+    /**
+     * @brief Indique si le source contient la position, en lisant la suite du flux si besoin
+     */
+    bool available(size_t position)
+    {
+        if (position - m_offset < m_input.size())
+            return true;
+        if (!m_stream)
+            return false;
+        return refill(position);
+    }
+
+    /**
+     * @brief Lit des blocs du flux jusqu'à contenir la position, après avoir
+     * oublié les caractères qui précèdent m_keep
+     */
+    bool refill(size_t position)
+    {
+        if (m_keep > m_offset)
+        {
+            m_input.erase(0, m_keep - m_offset);
+            m_offset = m_keep;
+        }
+        while (position - m_offset >= m_input.size())
+        {
+            size_t size = m_input.size();
+            m_input.resize(size + CHUNK_SIZE);
+            m_stream->read(&m_input[size], CHUNK_SIZE);
+            std::streamsize count = m_stream->gcount();
+            m_input.resize(size + static_cast<size_t>(std::max<std::streamsize>(count, 0)));
+            if (count <= 0)
+                return false;
+        }
+        return true;
+    }
 
     /**
      * @brief Consomme et retourne un identifiant à partir de la position courante.
@@ -364,15 +539,24 @@ private:
      * @param position Référence à la position courante dans le code source.
      * @return L'identifiant consommé sous forme de chaîne de caractères.
      */
-    std::string consumeIdentifier(int &position) const
+    std::string consumeIdentifier(size_t &position)
     {
-        std::string result;
-        while (position < m_input.size() &&
-               (std::isalnum(m_input[position]) || m_input[position] == '_'))
+        size_t start = position;
+        while (available(position) &&
+               (std::isalnum(static_cast<unsigned char>(at(position))) || at(position) == '_'))
         {
-            result += m_input[position++];
+            position++;
         }
-        return result;
+        return text(start, position);
+    }
+
+    /**
+     * @brief Copie les caractères [start, end) du source en une seule allocation
+     * @note Ils sont encore dans le tampon : refill ne supprime rien après m_keep
+     */
+    std::string text(size_t start, size_t end) const
+    {
+        return m_input.substr(start - m_offset, end - start);
     }
 
     /**
@@ -384,14 +568,14 @@ private:
      * @param position Référence à la position courante dans le code source.
      * @return Le nombre consommé sous forme de chaîne de caractères.
      */
-    std::string consumeNumber(int &position) const
+    std::string consumeNumber(size_t &position)
     {
-        std::string result;
-        while (position < m_input.size() && std::isdigit(m_input[position]))
+        size_t start = position;
+        while (available(position) && std::isdigit(static_cast<unsigned char>(at(position))))
         {
-            result += m_input[position++];
+            position++;
         }
-        return result;
+        return text(start, position);
     }
 
     /**
@@ -403,25 +587,23 @@ private:
      * @param position Référence à la position courante dans le code source.
      * @return Un token de type INT_LITERAL ou IDENTIFIER.
      */
-    Token StartNumToken(int &position) const
+    Token StartNumToken(size_t &position)
     {
         // Consommer tous les chiffres
+        size_t start = position;
         std::string number = consumeNumber(position);
 
         // Verifier si le prochain caractère est une lettre ou un underscore
-        if (position < m_input.size() &&
-            (std::isalpha(m_input[position]) || m_input[position] == '_'))
+        if (available(position) &&
+            (std::isalpha(static_cast<unsigned char>(at(position))) || at(position) == '_'))
         {
-
-            std::string identifier = number;
-
-            while (position < m_input.size() &&
-                   (std::isalnum(m_input[position]) || m_input[position] == '_'))
+            while (available(position) &&
+                   (std::isalnum(static_cast<unsigned char>(at(position))) || at(position) == '_'))
             {
-                identifier += m_input[position++];
+                position++;
             }
 
-            return {TokenType::IDENTIFIER, identifier};
+            return {TokenType::IDENTIFIER, text(start, position)};
         }
         else
         {
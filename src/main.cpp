@@ -8,6 +8,9 @@
 #include "Tokenizer.hpp"
 #include "Parser.hpp"
 #include "Generator.hpp"
+#include "AArch64Backend.hpp"
+#include "BytecodeBackend.hpp"
+#include "Pipeline.hpp"
 
 // TODO : a deleter
 std::string toString(TokenType type)
@@ -76,11 +79,180 @@ std::string toString(TokenType type)
         return "PRINT";
     case TokenType::LENGTH:
         return "LENGTH";
+    case TokenType::MATRIX:
+        return "MATRIX";
+    case TokenType::PARAM:
+        return "PARAM";
+    case TokenType::MATCH:
+        return "MATCH";
+    case TokenType::FAT_ARROW:
+        return "FAT_ARROW";
     default:
         return "UNKNOWN";
     }
 }
 
+/**
+ * @brief Affiche les options acceptées par le compilateur
+ */
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options] [fichier.yb]\n"
+              << "Options:\n"
+              << "  -o <fichier>                 Fichier assembleur produit (defaut: ../build_asm/asm/org.asm)\n"
+              << "  --target=<cible>             x86-64 (NASM, defaut), aarch64 (assembleur GNU)\n"
+              << "                               ou bytecode (module .ybc execute par ybvm)\n"
+              << "  -march=<niveau>              x86-64 (defaut), x86-64-v2, x86-64-v3, x86-64-v4 ou native :\n"
+              << "                               largeur des copies vectorielles (SSE2, AVX2, AVX-512)\n"
+              << "  --hugepage-threshold=<oct>   Taille a partir de laquelle les tableaux sont prefaultes\n"
+              << "                               sur des huge pages (defaut: 2097152, 0 = desactive)\n"
+              << "  --hugetlb                    Essayer MAP_HUGETLB avant les huge pages transparentes\n"
+              << "  --stats                      Afficher le nombre d'instructions generees par construction\n"
+              << "  --checked-arith              Arreter le programme (code 1) si +, - ou * deborde\n"
+              << "  --fault-handler              Sur division par zero ou acces invalide, afficher la ligne\n"
+              << "                               du source et terminer avec le code 128 + signal\n"
+              << "  --shared                     Produire long yb_main(...) pour une bibliotheque partagee\n"
+              << "                               (code PIC, exit et les erreurs reviennent a l'appelant)\n"
+              << "  --entry=<nom>                Nom du point d'entree exporte avec --shared (defaut: yb_main)\n"
+              << "  --emit-header=<fichier>      Ecrire l'en-tete C++ du noyau (param) pour --shared\n"
+              << "  --no-promote                 Laisser en memoire les variables des boucles internes au lieu\n"
+              << "                               de les garder dans r12-r15\n"
+              << "  --no-schedule                Garder le code x86-64 dans l'ordre d'emission (pas de renommage\n"
+              << "                               des push/pop ni de reordonnancement)\n"
+              << "  --stream                     Lire, analyser et generer une instruction a la fois : la memoire\n"
+              << "                               utilisee depend de la plus grande instruction, pas du fichier\n"
+              << "  --pipeline                   Comme --stream, avec l'analyse lexicale, l'analyse syntaxique\n"
+              << "                               et la generation dans trois threads\n";
+}
+
+/**
+ * @brief Vérifie les paramètres du noyau et écrit son en-tête C++ (option --emit-header)
+ * @return int Code de retour du compilateur
+ */
+int finishKernel(const Generator &generator, const GeneratorOptions &options, const std::string &headerPath,
+                 const std::string &sourcePath)
+{
+    if (!generator.parameters().empty() && !options.runtime.sharedLibrary)
+    {
+        std::cerr << "Erreur: param n'est disponible qu'avec --shared" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (headerPath.empty())
+        return EXIT_SUCCESS;
+
+    std::ofstream header(headerPath);
+    header << generateKernelHeader(options.entryName, generator.parameters(), sourcePath);
+    if (!header)
+    {
+        std::cerr << "erreur d'ecriture du fichier " << headerPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "ecriture de l'en-tete " << headerPath << " fini" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Compile le source instruction par instruction (option --stream)
+ *
+ * Les tokens sont lus à la demande depuis le fichier, chaque instruction de premier
+ * niveau est analysée, générée et écrite avant de lire la suivante. Ni la liste des
+ * tokens, ni l'AST, ni le code assembleur complets ne sont gardés en mémoire.
+ *
+ * @param generator Générateur de la cible, qui ne doit pas encore avoir servi
+ * @param pipelined Faire tourner chaque étage dans son thread (option --pipeline)
+ * @return int Code de retour du compilateur
+ */
+int compileStream(std::istream &source, const std::string &outputPath, const CodeGenerator &generator,
+                  bool pipelined)
+{
+    std::ofstream asm_file(outputPath, std::ios::binary); // Le bytecode n'est pas du texte
+    if (!asm_file)
+    {
+        std::cerr << "erreur de creation du fichier " << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (pipelined && std::thread::hardware_concurrency() < 2)
+    {
+        std::cout << "Un seul coeur disponible: compilation sans threads" << std::endl;
+        pipelined = false;
+    }
+    if (pipelined)
+    {
+        if (!compilePipelined(source, asm_file, generator))
+        {
+            std::cerr << "Erreur: Impossible d'analyser le programme" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (!asm_file)
+        {
+            std::cerr << "erreur d'ecriture du fichier " << outputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "ecriture du code assembleur fini" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    Tokenizer tokenizer(source);
+    Parser parser(tokenizer);
+    std::stringstream chunk;
+
+    generator.beginAssembly(chunk);
+    while (!parser.atEnd())
+    {
+        auto stmt = parser.parseNext();
+        if (!stmt)
+        {
+            std::cerr << "Erreur: Impossible d'analyser le programme" << std::endl;
+            return EXIT_FAILURE;
+        }
+        generator.generateStatement(stmt.value(), chunk);
+
+        asm_file << chunk.str();
+        chunk.str("");
+    }
+    generator.finishAssembly(chunk);
+    asm_file << chunk.str();
+
+    if (!asm_file)
+    {
+        std::cerr << "erreur d'ecriture du fichier " << outputPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "ecriture du code assembleur fini" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Générateur d'une cible qui passe par la représentation intermédiaire
+ */
+std::unique_ptr<LoweringGenerator> makeLoweringGenerator(Target target, const GeneratorOptions &options)
+{
+    switch (target)
+    {
+    case Target::AARCH64:
+        return std::make_unique<LoweringGenerator>(std::make_unique<AArch64Backend>(), options.checkedArithmetic);
+    case Target::BYTECODE:
+        return std::make_unique<LoweringGenerator>(std::make_unique<BytecodeBackend>(), options.checkedArithmetic);
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Vérifie que la traduction en représentation intermédiaire est complète
+ * @return int Code de retour du compilateur
+ */
+int finishLowering(const LoweringGenerator &generator)
+{
+    if (generator.failed())
+    {
+        std::cerr << "Erreur: le programme utilise des instructions absentes de cette cible" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
 /**
  * @brief Point d'entrée principal du compilateur
  *
@@ -98,10 +270,150 @@ int main(int argc, char *argv[])
 {
 
     std::string filePath;
+    std::string outputPath = "../build_asm/asm/org.asm";
+    std::string headerPath;
+    GeneratorOptions options;
+    Target target = Target::X86_64;
+    bool stream = false;
+    bool pipelined = false;
+    bool march = false;
 
-    if (argc >= 2)
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else if (arg.rfind("--target=", 0) == 0)
+        {
+            std::string name = arg.substr(9);
+            if (name == "x86-64" || name == "x86_64")
+                target = Target::X86_64;
+            else if (name == "aarch64" || name == "arm64")
+                target = Target::AARCH64;
+            else if (name == "bytecode")
+                target = Target::BYTECODE;
+            else
+            {
+                std::cerr << "Erreur: cible inconnue: " << name << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg.rfind("-march=", 0) == 0)
+        {
+            std::string name = arg.substr(7);
+            if (name == "native")
+                options.runtime.cpuLevel = hostCpuLevel();
+            else if (!parseCpuLevel(name, options.runtime.cpuLevel))
+            {
+                std::cerr << "Erreur: niveau -march inconnu: " << name << std::endl;
+                return EXIT_FAILURE;
+            }
+            march = true;
+        }
+        else if (arg.rfind("--hugepage-threshold=", 0) == 0)
+        {
+            try
+            {
+                options.runtime.largeAllocThreshold = std::stoll(arg.substr(arg.find('=') + 1));
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Erreur: seuil invalide: " << arg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--hugetlb")
+        {
+            options.runtime.useHugeTlb = true;
+        }
+        else if (arg == "--stats")
+        {
+            options.stats = true;
+        }
+        else if (arg == "--no-promote")
+        {
+            options.promoteLoopVariables = false;
+        }
+        else if (arg == "--no-schedule")
+        {
+            options.schedule = false;
+        }
+        else if (arg == "--checked-arith")
+        {
+            options.checkedArithmetic = true;
+        }
+        else if (arg == "--fault-handler")
+        {
+            options.faultHandler = true;
+        }
+        else if (arg == "--shared")
+        {
+            options.runtime.sharedLibrary = true;
+        }
+        else if (arg.rfind("--entry=", 0) == 0)
+        {
+            options.entryName = arg.substr(8);
+            bool valid = !options.entryName.empty() && !std::isdigit(static_cast<unsigned char>(options.entryName[0]));
+            for (char c : options.entryName)
+                valid = valid && (std::isalnum(static_cast<unsigned char>(c)) || c == '_');
+            if (!valid)
+            {
+                std::cerr << "Erreur: nom de point d'entree invalide: " << arg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg.rfind("--emit-header=", 0) == 0)
+        {
+            headerPath = arg.substr(14);
+        }
+        else if (arg == "--stream")
+        {
+            stream = true;
+        }
+        else if (arg == "--pipeline")
+        {
+            stream = true;
+            pipelined = true;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Erreur: option inconnue: " << arg << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            filePath = arg;
+        }
+    }
+
+    if (options.faultHandler && options.runtime.sharedLibrary)
+    {
+        // Le gestionnaire remplacerait ceux du processus hôte
+        std::cerr << "Erreur: --fault-handler n'est pas disponible avec --shared" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!headerPath.empty() && !options.runtime.sharedLibrary)
+    {
+        std::cerr << "Erreur: --emit-header n'est disponible qu'avec --shared" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (target != Target::X86_64 && (options.runtime.sharedLibrary || options.faultHandler || options.stats))
+    {
+        // Ces modes dépendent du runtime x86-64 (Generator, RuntimeEmitter)
+        std::cerr << "Erreur: --shared, --fault-handler et --stats ne sont disponibles que pour x86-64" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (target != Target::X86_64 && march)
+    {
+        std::cerr << "Erreur: -march n'est disponible que pour x86-64" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!filePath.empty())
     {
-        filePath = argv[1];
         std::cout << "Lecture du fichier: " << filePath << std::endl;
     }
     else
@@ -118,23 +430,39 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    if (stream)
+    {
+        if (options.stats)
+        {
+            std::cerr << "Erreur: --stats n'est pas disponible avec --stream et --pipeline" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (auto lowering = makeLoweringGenerator(target, options))
+        {
+            int status = compileStream(file, outputPath, *lowering, pipelined);
+            return status == EXIT_SUCCESS ? finishLowering(*lowering) : status;
+        }
+        Generator generator(options);
+        int status = compileStream(file, outputPath, generator, pipelined);
+        return status == EXIT_SUCCESS ? finishKernel(generator, options, headerPath, filePath) : status;
+    }
+
     std::stringstream ss;
     ss << file.rdbuf();
     file.close();
     std::string content = ss.str();
 
-    // ETape 01: On fait l'annalyse lexicale
-    Tokenizer tokenizer(content);
-    std::vector<Token> tokens = tokenizer.tokenize();
-
+    // ETape 01: On affiche l'analyse lexicale (le parser relit les tokens à la demande)
     std::cout << "Tokens:\n";
-    for (const auto &token : tokens)
+    Tokenizer dump(content);
+    while (auto token = dump.next())
     {
-        std::cout << "Type: " << toString(token.type) << "\t\t" << ", Value: " << (token.value ? *token.value : "null") << std::endl;
+        std::cout << "Type: " << toString(token->type) << "\t\t" << ", Value: " << (token->value ? *token->value : "null") << std::endl;
     }
 
-    // ETape 02: On fait l'analyse syntaxique
-    Parser parser(tokens);
+    // ETape 02: On fait l'analyse syntaxique, en demandant les tokens au tokenizer
+    Tokenizer tokenizer(content);
+    Parser parser(tokenizer);
     auto program = parser.parse();
     if (!program)
     {
@@ -143,13 +471,15 @@ int main(int argc, char *argv[])
     }
 
     // ETape 03: On fait la generation du code assembleur
-    Generator generator(program.value());
-    std::string asm_code = generator.generateAssembly();
+    auto lowering = makeLoweringGenerator(target, options);
+    Generator generator(program.value(), options);
+    std::string asm_code = lowering ? lowering->generateProgram(program.value()) : generator.generateAssembly();
 
-    std::cout << "Le code asm:\n"
-              << asm_code << std::endl;
+    if (target != Target::BYTECODE)
+        std::cout << "Le code asm:\n"
+                  << asm_code << std::endl;
 
-    std::ofstream asm_file("../build_asm/asm/org.asm");
+    std::ofstream asm_file(outputPath, std::ios::binary);
     if (!asm_file)
     {
         std::cerr << "erreur de creation du fichier " << std::endl;
@@ -159,5 +489,13 @@ int main(int argc, char *argv[])
     asm_file.close();
     std::cout << "ecriture du code assembleur fini" << std::endl;
 
-    return EXIT_SUCCESS;
+    if (options.stats)
+    {
+        std::cout << "\nStatistiques du code genere:\n";
+        generator.codeStats().print(std::cout);
+    }
+
+    if (lowering)
+        return finishLowering(*lowering);
+    return finishKernel(generator, options, headerPath, filePath);
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "Bytecode.hpp"
+#include "BytecodeVM.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * @file ybvm.cpp
+ * @brief Exécute un module produit par compiler --target=bytecode
+ *
+ * Le module est entièrement validé avant la première instruction : un fichier corrompu
+ * ou forgé est refusé, il ne peut ni lire hors de la pile ou des variables, ni sauter
+ * au milieu d'une instruction, ni utiliser plus de mémoire que --max-memory.
+ */
+
+/**
+ * @brief Affiche les options acceptées par ybvm
+ */
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options] programme.ybc\n"
+              << "Options:\n"
+              << "  --max-memory=<oct>   Memoire maximale des tableaux (defaut: 1073741824)\n"
+              << "  --check              Valider le module sans l'executer\n";
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path;
+    uint64_t maxMemory = uint64_t(1) << 30;
+    bool checkOnly = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--max-memory=", 0) == 0)
+        {
+            try
+            {
+                maxMemory = std::stoull(arg.substr(arg.find('=') + 1));
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Erreur: taille invalide: " << arg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--check")
+            checkOnly = true;
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Erreur: option inconnue: " << arg << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+            path = arg;
+    }
+    if (path.empty())
+    {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Erreur ouverture du fichier: " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::stringstream bytes;
+    bytes << file.rdbuf();
+
+    std::string error;
+    auto module = loadBytecode(bytes.str(), error);
+    if (!module)
+    {
+        std::cerr << "Erreur: bytecode invalide: " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (checkOnly)
+        return EXIT_SUCCESS;
+
+    BytecodeVM vm(*module, std::cout, std::cerr, maxMemory);
+    return vm.run();
+}